@@ -30,6 +30,21 @@ struct JLevelDBBatch
 	leveldb_writebatch_t* batch;
 	gchar* namespace;
 	JSemantics* semantics;
+
+	/**
+	 * Values returned by backend_get_borrowed(), freed when the batch is executed.
+	 */
+	GPtrArray* values;
+
+	/**
+	 * Whether the batch contains modifications that have not been written yet.
+	 */
+	gboolean pending;
+
+	/**
+	 * Whether the batch holds the lock for atomic operations.
+	 */
+	gboolean locked;
 };
 
 typedef struct JLevelDBBatch JLevelDBBatch;
@@ -41,6 +56,18 @@ struct JLevelDBData
 	leveldb_readoptions_t* read_options;
 	leveldb_writeoptions_t* write_options;
 	leveldb_writeoptions_t* write_options_sync;
+
+	/**
+	 * The block cache and the bloom filter policy, NULL if LevelDB's defaults are used.
+	 * Both have to outlive the database.
+	 */
+	leveldb_cache_t* cache;
+	leveldb_filterpolicy_t* filter_policy;
+
+	/**
+	 * Serializes atomic operations.
+	 */
+	GMutex lock;
 };
 
 typedef struct JLevelDBData JLevelDBData;
@@ -51,10 +78,82 @@ struct JLevelDBIterator
 	gboolean first;
 	gchar* prefix;
 	gsize namespace_len;
+
+	/**
+	 * The range to iterate over, NULL if unbounded.
+	 * The start is inclusive, the end is exclusive.
+	 */
+	gchar* start;
+	gchar* end;
+	gboolean reverse;
+
+	/**
+	 * The maximum number of pairs to return, 0 for no limit.
+	 */
+	guint32 limit;
+	guint32 count;
 };
 
 typedef struct JLevelDBIterator JLevelDBIterator;
 
+static void
+leveldb_value_free(gpointer data)
+{
+	leveldb_free(data);
+}
+
+/**
+ * Returns a numeric option from the backend path.
+ */
+static guint64
+leveldb_option_get(GHashTable* options, gchar const* name, guint64 default_value)
+{
+	gchar const* value;
+
+	if ((value = g_hash_table_lookup(options, name)) != NULL)
+	{
+		return g_ascii_strtoull(value, NULL, 10);
+	}
+
+	return default_value;
+}
+
+/**
+ * Prepares a batch for an atomic operation.
+ * Atomic operations read the stored values directly, so the batch's previous modifications are written first.
+ * The lock is held until the batch has been executed, so that other atomic operations cannot interfere in the meantime.
+ * Batches without atomic operations do not take the lock and can be written concurrently.
+ */
+static gboolean
+leveldb_batch_lock(JLevelDBData* bd, JLevelDBBatch* batch)
+{
+	g_autofree gchar* leveldb_error = NULL;
+
+	leveldb_writeoptions_t* write_options = bd->write_options;
+
+	if (!batch->locked)
+	{
+		g_mutex_lock(&(bd->lock));
+		batch->locked = TRUE;
+	}
+
+	if (!batch->pending)
+	{
+		return TRUE;
+	}
+
+	if (j_semantics_get(batch->semantics, J_SEMANTICS_SAFETY) == J_SEMANTICS_SAFETY_STORAGE)
+	{
+		write_options = bd->write_options_sync;
+	}
+
+	leveldb_write(bd->db, write_options, batch->batch, &leveldb_error);
+	leveldb_writebatch_clear(batch->batch);
+	batch->pending = FALSE;
+
+	return (leveldb_error == NULL);
+}
+
 static gboolean
 backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* backend_batch)
 {
@@ -70,6 +169,9 @@ backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* s
 	batch->batch = leveldb_writebatch_create();
 	batch->namespace = g_strdup(namespace);
 	batch->semantics = j_semantics_ref(semantics);
+	batch->values = NULL;
+	batch->pending = FALSE;
+	batch->locked = FALSE;
 
 	*backend_batch = batch;
 
@@ -95,6 +197,16 @@ backend_batch_execute(gpointer backend_data, gpointer backend_batch)
 
 	leveldb_write(bd->db, write_options, batch->batch, &leveldb_error);
 
+	if (batch->locked)
+	{
+		g_mutex_unlock(&(bd->lock));
+	}
+
+	if (batch->values != NULL)
+	{
+		g_ptr_array_unref(batch->values);
+	}
+
 	j_semantics_unref(batch->semantics);
 	g_free(batch->namespace);
 	leveldb_writebatch_destroy(batch->batch);
@@ -117,6 +229,7 @@ backend_put(gpointer backend_data, gpointer backend_batch, gchar const* key, gco
 
 	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
 	leveldb_writebatch_put(batch->batch, nskey, strlen(nskey) + 1, value, len);
+	batch->pending = TRUE;
 
 	return TRUE;
 }
@@ -134,6 +247,7 @@ backend_delete(gpointer backend_data, gpointer backend_batch, gchar const* key)
 
 	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
 	leveldb_writebatch_delete(batch->batch, nskey, strlen(nskey) + 1);
+	batch->pending = TRUE;
 
 	return TRUE;
 }
@@ -164,6 +278,228 @@ backend_get(gpointer backend_data, gpointer backend_batch, gchar const* key, gpo
 	return (result != NULL);
 }
 
+static gboolean
+backend_get_borrowed(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer* value, guint32* len)
+{
+	JLevelDBBatch* batch = backend_batch;
+	JLevelDBData* bd = backend_data;
+	g_autofree gchar* nskey = NULL;
+	gchar* result;
+	gsize result_len;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(len != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	// LevelDB cannot pin values, but its own copy can be handed out without copying it again
+	result = leveldb_get(bd->db, bd->read_options, nskey, strlen(nskey) + 1, &result_len, NULL);
+
+	if (result == NULL)
+	{
+		return FALSE;
+	}
+
+	if (batch->values == NULL)
+	{
+		batch->values = g_ptr_array_new_with_free_func(leveldb_value_free);
+	}
+
+	g_ptr_array_add(batch->values, result);
+
+	*value = result;
+	*len = result_len;
+
+	return TRUE;
+}
+
+static gint
+backend_key_compare(gconstpointer a, gconstpointer b, gpointer data)
+{
+	gchar const* const* const* keys = data;
+
+	return strcmp((*keys)[*(guint32 const*)a], (*keys)[*(guint32 const*)b]);
+}
+
+static gboolean
+backend_get_multi(gpointer backend_data, gpointer backend_batch, gchar const* const* keys, guint32 count, gconstpointer* values, guint32* lens)
+{
+	g_autofree guint32* order = NULL;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(keys != NULL, FALSE);
+	g_return_val_if_fail(values != NULL, FALSE);
+	g_return_val_if_fail(lens != NULL, FALSE);
+
+	order = g_new(guint32, count);
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		order[i] = i;
+	}
+
+	// Looking up the keys in order lets neighboring lookups hit the same blocks in the block cache
+	g_qsort_with_data(order, count, sizeof(guint32), backend_key_compare, &keys);
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		guint32 j = order[i];
+
+		if (!backend_get_borrowed(backend_data, backend_batch, keys[j], &(values[j]), &(lens[j])))
+		{
+			values[j] = NULL;
+			lens[j] = 0;
+		}
+	}
+
+	return TRUE;
+}
+
+static gboolean
+backend_compare_and_swap(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer expected, guint32 expected_len, gconstpointer value, guint32 len, gboolean* swapped)
+{
+	JLevelDBBatch* batch = backend_batch;
+	JLevelDBData* bd = backend_data;
+	g_autofree gchar* nskey = NULL;
+	g_autofree gchar* current = NULL;
+	g_autofree gchar* leveldb_error = NULL;
+	gsize current_len = 0;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(swapped != NULL, FALSE);
+
+	*swapped = FALSE;
+
+	if (!leveldb_batch_lock(bd, batch))
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	current = leveldb_get(bd->db, bd->read_options, nskey, strlen(nskey) + 1, &current_len, &leveldb_error);
+
+	if (leveldb_error != NULL)
+	{
+		return FALSE;
+	}
+
+	if (expected == NULL)
+	{
+		*swapped = (current == NULL);
+	}
+	else
+	{
+		*swapped = (current != NULL && current_len == expected_len && memcmp(current, expected, expected_len) == 0);
+	}
+
+	if (*swapped)
+	{
+		leveldb_writebatch_put(batch->batch, nskey, strlen(nskey) + 1, value, len);
+		batch->pending = TRUE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+backend_add(gpointer backend_data, gpointer backend_batch, gchar const* key, gint64 delta, gint64* result)
+{
+	JLevelDBBatch* batch = backend_batch;
+	JLevelDBData* bd = backend_data;
+	g_autofree gchar* nskey = NULL;
+	g_autofree gchar* current = NULL;
+	g_autofree gchar* leveldb_error = NULL;
+	gsize current_len = 0;
+	gint64 number = 0;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+
+	if (!leveldb_batch_lock(bd, batch))
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	current = leveldb_get(bd->db, bd->read_options, nskey, strlen(nskey) + 1, &current_len, &leveldb_error);
+
+	if (leveldb_error != NULL)
+	{
+		return FALSE;
+	}
+
+	if (current != NULL)
+	{
+		if (current_len != sizeof(number))
+		{
+			return FALSE;
+		}
+
+		memcpy(&number, current, sizeof(number));
+	}
+
+	number += delta;
+
+	leveldb_writebatch_put(batch->batch, nskey, strlen(nskey) + 1, (gchar const*)&number, sizeof(number));
+	batch->pending = TRUE;
+
+	*result = number;
+
+	return TRUE;
+}
+
+static gboolean
+backend_append(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer value, guint32 len)
+{
+	JLevelDBBatch* batch = backend_batch;
+	JLevelDBData* bd = backend_data;
+	g_autofree gchar* nskey = NULL;
+	g_autofree gchar* current = NULL;
+	g_autofree gchar* new_value = NULL;
+	g_autofree gchar* leveldb_error = NULL;
+	gsize current_len = 0;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+
+	if (!leveldb_batch_lock(bd, batch))
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	current = leveldb_get(bd->db, bd->read_options, nskey, strlen(nskey) + 1, &current_len, &leveldb_error);
+
+	if (leveldb_error != NULL)
+	{
+		return FALSE;
+	}
+
+	if (current == NULL)
+	{
+		current_len = 0;
+	}
+
+	new_value = g_malloc(current_len + len);
+
+	if (current_len > 0)
+	{
+		memcpy(new_value, current, current_len);
+	}
+
+	memcpy(new_value + current_len, value, len);
+
+	leveldb_writebatch_put(batch->batch, nskey, strlen(nskey) + 1, new_value, current_len + len);
+	batch->pending = TRUE;
+
+	return TRUE;
+}
+
 static gboolean
 backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend_iterator)
 {
@@ -183,6 +519,11 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend
 		iterator->first = TRUE;
 		iterator->prefix = g_strdup_printf("%s:", namespace);
 		iterator->namespace_len = strlen(namespace) + 1;
+		iterator->start = NULL;
+		iterator->end = NULL;
+		iterator->reverse = FALSE;
+		iterator->limit = 0;
+		iterator->count = 0;
 
 		*backend_iterator = iterator;
 	}
@@ -210,6 +551,42 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 		iterator->first = TRUE;
 		iterator->prefix = g_strdup_printf("%s:%s", namespace, prefix);
 		iterator->namespace_len = strlen(namespace) + 1;
+		iterator->start = NULL;
+		iterator->end = NULL;
+		iterator->reverse = FALSE;
+		iterator->limit = 0;
+		iterator->count = 0;
+
+		*backend_iterator = iterator;
+	}
+
+	return (iterator != NULL);
+}
+
+static gboolean
+backend_get_range(gpointer backend_data, gchar const* namespace, gchar const* start, gchar const* end, guint32 limit, gboolean reverse, gpointer* backend_iterator)
+{
+	JLevelDBData* bd = backend_data;
+	JLevelDBIterator* iterator = NULL;
+	leveldb_iterator_t* it;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(backend_iterator != NULL, FALSE);
+
+	it = leveldb_create_iterator(bd->db, bd->read_options);
+
+	if (it != NULL)
+	{
+		iterator = g_slice_new(JLevelDBIterator);
+		iterator->iterator = it;
+		iterator->first = TRUE;
+		iterator->prefix = g_strdup_printf("%s:", namespace);
+		iterator->namespace_len = strlen(namespace) + 1;
+		iterator->start = (start != NULL) ? g_strdup_printf("%s:%s", namespace, start) : NULL;
+		iterator->end = (end != NULL) ? g_strdup_printf("%s:%s", namespace, end) : NULL;
+		iterator->reverse = reverse;
+		iterator->limit = limit;
+		iterator->count = 0;
 
 		*backend_iterator = iterator;
 	}
@@ -217,6 +594,20 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	return (iterator != NULL);
 }
 
+static void
+backend_iterator_free(gpointer backend_data, gpointer backend_iterator)
+{
+	JLevelDBIterator* iterator = backend_iterator;
+
+	(void)backend_data;
+
+	g_free(iterator->prefix);
+	g_free(iterator->start);
+	g_free(iterator->end);
+	leveldb_iter_destroy(iterator->iterator);
+	g_slice_free(JLevelDBIterator, iterator);
+}
+
 static gboolean
 backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const** key, gconstpointer* value, guint32* len)
 {
@@ -228,11 +619,52 @@ backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const**
 	g_return_val_if_fail(value != NULL, FALSE);
 	g_return_val_if_fail(len != NULL, FALSE);
 
+	if (iterator->limit > 0 && iterator->count >= iterator->limit)
+	{
+		goto out;
+	}
+
 	if (iterator->first)
 	{
-		leveldb_iter_seek(iterator->iterator, iterator->prefix, strlen(iterator->prefix));
+		if (!iterator->reverse)
+		{
+			gchar const* seek;
+
+			seek = (iterator->start != NULL) ? iterator->start : iterator->prefix;
+			leveldb_iter_seek(iterator->iterator, seek, strlen(seek));
+		}
+		else
+		{
+			g_autofree gchar* upper = NULL;
+			gchar const* seek = iterator->end;
+
+			if (seek == NULL)
+			{
+				// The first key after the namespace
+				upper = g_strdup(iterator->prefix);
+				upper[iterator->namespace_len - 1]++;
+				seek = upper;
+			}
+
+			// Position on the first key not in the range and go back one key
+			leveldb_iter_seek(iterator->iterator, seek, strlen(seek));
+
+			if (leveldb_iter_valid(iterator->iterator))
+			{
+				leveldb_iter_prev(iterator->iterator);
+			}
+			else
+			{
+				leveldb_iter_seek_to_last(iterator->iterator);
+			}
+		}
+
 		iterator->first = FALSE;
 	}
+	else if (iterator->reverse)
+	{
+		leveldb_iter_prev(iterator->iterator);
+	}
 	else
 	{
 		leveldb_iter_next(iterator->iterator);
@@ -250,6 +682,13 @@ backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const**
 			goto out;
 		}
 
+		if ((iterator->end != NULL && strcmp(key_, iterator->end) >= 0) || (iterator->start != NULL && strcmp(key_, iterator->start) < 0))
+		{
+			goto out;
+		}
+
+		iterator->count++;
+
 		*key = key_ + iterator->namespace_len;
 		*value = leveldb_iter_value(iterator->iterator, &tmp);
 		*len = tmp;
@@ -258,9 +697,7 @@ backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const**
 	}
 
 out:
-	g_free(iterator->prefix);
-	leveldb_iter_destroy(iterator->iterator);
-	g_slice_free(JLevelDBIterator, iterator);
+	backend_iterator_free(backend_data, iterator);
 
 	return FALSE;
 }
@@ -270,12 +707,22 @@ backend_init(gchar const* path, gpointer* backend_data)
 {
 	JLevelDBData* bd;
 	leveldb_options_t* options;
+	g_autoptr(GHashTable) path_options = NULL;
+	g_autofree gchar* db_path = NULL;
 	g_autofree gchar* dirname = NULL;
+	guint64 block_cache;
+	guint64 bloom_filter;
+	guint64 write_buffer;
 	gint const compressions[] = { leveldb_snappy_compression, leveldb_no_compression };
 
 	g_return_val_if_fail(path != NULL, FALSE);
 
-	dirname = g_path_get_dirname(path);
+	db_path = j_backend_path_parse(path, &path_options);
+	block_cache = leveldb_option_get(path_options, "block-cache", 0);
+	bloom_filter = leveldb_option_get(path_options, "bloom-filter", 10);
+	write_buffer = leveldb_option_get(path_options, "write-buffer", 0);
+
+	dirname = g_path_get_dirname(db_path);
 	g_mkdir_with_parents(dirname, 0700);
 
 	bd = g_slice_new(JLevelDBData);
@@ -283,16 +730,37 @@ backend_init(gchar const* path, gpointer* backend_data)
 	bd->write_options = leveldb_writeoptions_create();
 	bd->write_options_sync = leveldb_writeoptions_create();
 	leveldb_writeoptions_set_sync(bd->write_options_sync, 1);
+	bd->cache = NULL;
+	bd->filter_policy = NULL;
+	g_mutex_init(&(bd->lock));
 
 	options = leveldb_options_create();
 	leveldb_options_set_create_if_missing(options, 1);
 
+	if (write_buffer > 0)
+	{
+		leveldb_options_set_write_buffer_size(options, write_buffer);
+	}
+
+	if (block_cache > 0)
+	{
+		bd->cache = leveldb_cache_create_lru(block_cache);
+		leveldb_options_set_cache(options, bd->cache);
+	}
+
+	if (bloom_filter > 0)
+	{
+		// Point lookups only read files that might contain the key
+		bd->filter_policy = leveldb_filterpolicy_create_bloom(bloom_filter);
+		leveldb_options_set_filter_policy(options, bd->filter_policy);
+	}
+
 	for (guint i = 0; i < G_N_ELEMENTS(compressions); i++)
 	{
 		g_autofree gchar* error = NULL;
 
 		leveldb_options_set_compression(options, compressions[i]);
-		bd->db = leveldb_open(options, path, &error);
+		bd->db = leveldb_open(options, db_path, &error);
 
 		if (bd->db != NULL)
 		{
@@ -315,12 +783,23 @@ backend_fini(gpointer backend_data)
 	leveldb_readoptions_destroy(bd->read_options);
 	leveldb_writeoptions_destroy(bd->write_options);
 	leveldb_writeoptions_destroy(bd->write_options_sync);
+	g_mutex_clear(&(bd->lock));
 
 	if (bd->db != NULL)
 	{
 		leveldb_close(bd->db);
 	}
 
+	if (bd->filter_policy != NULL)
+	{
+		leveldb_filterpolicy_destroy(bd->filter_policy);
+	}
+
+	if (bd->cache != NULL)
+	{
+		leveldb_cache_destroy(bd->cache);
+	}
+
 	g_slice_free(JLevelDBData, bd);
 }
 
@@ -335,9 +814,16 @@ static JBackend leveldb_backend = {
 		.backend_put = backend_put,
 		.backend_delete = backend_delete,
 		.backend_get = backend_get,
+		.backend_get_borrowed = backend_get_borrowed,
+		.backend_get_multi = backend_get_multi,
+		.backend_compare_and_swap = backend_compare_and_swap,
+		.backend_add = backend_add,
+		.backend_append = backend_append,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_get_range = backend_get_range,
+		.backend_iterate = backend_iterate,
+		.backend_iterator_free = backend_iterator_free }
 };
 
 G_MODULE_EXPORT
@@ -25,9 +25,35 @@
 
 #include <julea.h>
 
+/**
+ * The maximum number of readers.
+ * Every read-only transaction occupies a reader slot until it is aborted, including reset transactions that are kept for reuse.
+ */
+#define J_LMDB_MAX_READERS 1024
+
+/**
+ * The maximum number of reset read-only transactions that are kept for reuse.
+ */
+#define J_LMDB_READ_TXN_POOL_SIZE 64
+
+/**
+ * The maximum number of open iterators.
+ * Iterators keep their transactions while clients are processing pages, so they are limited to leave reader slots for batches.
+ */
+#define J_LMDB_MAX_ITERATORS (J_LMDB_MAX_READERS / 2)
+
 struct JLMDBBatch
 {
+	/**
+	 * The write transaction, started by the first put or delete.
+	 */
 	MDB_txn* txn;
+
+	/**
+	 * The read-only transaction, used for gets as long as there is no write transaction.
+	 */
+	MDB_txn* read_txn;
+
 	gchar* namespace;
 	JSemantics* semantics;
 };
@@ -38,6 +64,17 @@ struct JLMDBData
 {
 	MDB_env* env;
 	MDB_dbi dbi;
+
+	/**
+	 * Read-only transactions that have been reset and can be renewed.
+	 * LMDB only allows one write transaction at a time but read-only transactions do not block each other.
+	 */
+	GAsyncQueue* read_txns;
+
+	/**
+	 * The number of open iterators.
+	 */
+	gint iterators;
 };
 
 typedef struct JLMDBData JLMDBData;
@@ -49,52 +86,162 @@ struct JLMDBIterator
 	gboolean first;
 	gchar* prefix;
 	gsize namespace_len;
+
+	/**
+	 * The range to iterate over, NULL if unbounded.
+	 * The start is inclusive, the end is exclusive.
+	 */
+	gchar* start;
+	gchar* end;
+	gboolean reverse;
+
+	/**
+	 * The maximum number of pairs to return, 0 for no limit.
+	 */
+	guint32 limit;
+	guint32 count;
 };
 
 typedef struct JLMDBIterator JLMDBIterator;
 
+/**
+ * Returns a read-only transaction, reusing a previously reset one if possible.
+ */
+static MDB_txn*
+lmdb_read_txn_acquire(JLMDBData* bd)
+{
+	MDB_txn* txn;
+
+	txn = g_async_queue_try_pop(bd->read_txns);
+
+	if (txn != NULL)
+	{
+		if (mdb_txn_renew(txn) == 0)
+		{
+			return txn;
+		}
+
+		mdb_txn_abort(txn);
+	}
+
+	if (mdb_txn_begin(bd->env, NULL, MDB_RDONLY, &txn) != 0)
+	{
+		return NULL;
+	}
+
+	return txn;
+}
+
+/**
+ * Resets a read-only transaction and keeps it for later reuse.
+ * Resetting releases the snapshot so that old pages can be reclaimed by writers.
+ */
+static void
+lmdb_read_txn_release(JLMDBData* bd, MDB_txn* txn)
+{
+	// Unused transactions still occupy reader slots
+	if (g_async_queue_length(bd->read_txns) >= J_LMDB_READ_TXN_POOL_SIZE)
+	{
+		mdb_txn_abort(txn);
+		return;
+	}
+
+	mdb_txn_reset(txn);
+	g_async_queue_push(bd->read_txns, txn);
+}
+
+/**
+ * Returns a read-only transaction for an iterator.
+ * Fails if too many iterators are open.
+ */
+static MDB_txn*
+lmdb_iterator_txn_acquire(JLMDBData* bd)
+{
+	MDB_txn* txn;
+
+	if (g_atomic_int_add(&(bd->iterators), 1) >= J_LMDB_MAX_ITERATORS)
+	{
+		g_atomic_int_add(&(bd->iterators), -1);
+		return NULL;
+	}
+
+	txn = lmdb_read_txn_acquire(bd);
+
+	if (txn == NULL)
+	{
+		g_atomic_int_add(&(bd->iterators), -1);
+	}
+
+	return txn;
+}
+
+static void
+lmdb_iterator_txn_release(JLMDBData* bd, MDB_txn* txn)
+{
+	lmdb_read_txn_release(bd, txn);
+	g_atomic_int_add(&(bd->iterators), -1);
+}
+
+/**
+ * Starts the batch's write transaction if necessary.
+ * LMDB only allows one write transaction at a time, so everything done within it is atomic.
+ */
+static gboolean
+lmdb_write_txn_begin(JLMDBData* bd, JLMDBBatch* batch)
+{
+	if (batch->txn == NULL && mdb_txn_begin(bd->env, NULL, 0, &(batch->txn)) != 0)
+	{
+		batch->txn = NULL;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 static gboolean
 backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* data)
 {
-	JLMDBData* bd = backend_data;
-	JLMDBBatch* batch = NULL;
-	MDB_txn* txn;
+	JLMDBBatch* batch;
+
+	(void)backend_data;
 
 	g_return_val_if_fail(namespace != NULL, FALSE);
 	g_return_val_if_fail(data != NULL, FALSE);
 
-	if (mdb_txn_begin(bd->env, NULL, 0, &txn) == 0)
-	{
-		batch = g_slice_new(JLMDBBatch);
-		batch->txn = txn;
-		batch->namespace = g_strdup(namespace);
-		batch->semantics = j_semantics_ref(semantics);
-	}
+	// Transactions are started lazily because we do not know yet whether the batch will modify data
+	batch = g_slice_new(JLMDBBatch);
+	batch->txn = NULL;
+	batch->read_txn = NULL;
+	batch->namespace = g_strdup(namespace);
+	batch->semantics = j_semantics_ref(semantics);
 
 	*data = batch;
 
-	return (batch != NULL);
+	return TRUE;
 }
 
 static gboolean
 backend_batch_execute(gpointer backend_data, gpointer data)
 {
-	gboolean ret = FALSE;
+	gboolean ret = TRUE;
 
+	JLMDBData* bd = backend_data;
 	JLMDBBatch* batch = data;
 
-	(void)backend_data;
-
 	g_return_val_if_fail(data != NULL, FALSE);
 
 	// FIXME do something with batch->semantics
 
-	if (mdb_txn_commit(batch->txn) == 0)
+	if (batch->read_txn != NULL)
 	{
-		ret = TRUE;
+		lmdb_read_txn_release(bd, batch->read_txn);
 	}
 
-	// FIXME free txn
+	if (batch->txn != NULL)
+	{
+		// mdb_txn_commit() frees the transaction, even if it fails
+		ret = (mdb_txn_commit(batch->txn) == 0);
+	}
 
 	j_semantics_unref(batch->semantics);
 	g_free(batch->namespace);
@@ -116,6 +263,11 @@ backend_put(gpointer backend_data, gpointer data, gchar const* key, gconstpointe
 	g_return_val_if_fail(key != NULL, FALSE);
 	g_return_val_if_fail(value != NULL, FALSE);
 
+	if (!lmdb_write_txn_begin(bd, batch))
+	{
+		return FALSE;
+	}
+
 	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
 
 	m_key.mv_size = strlen(nskey) + 1;
@@ -137,6 +289,11 @@ backend_delete(gpointer backend_data, gpointer data, gchar const* key)
 	g_return_val_if_fail(data != NULL, FALSE);
 	g_return_val_if_fail(key != NULL, FALSE);
 
+	if (!lmdb_write_txn_begin(bd, batch))
+	{
+		return FALSE;
+	}
+
 	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
 
 	m_key.mv_size = strlen(nskey) + 1;
@@ -145,37 +302,282 @@ backend_delete(gpointer backend_data, gpointer data, gchar const* key)
 	return (mdb_del(batch->txn, bd->dbi, &m_key, NULL) == 0);
 }
 
+static gboolean
+backend_get_borrowed(gpointer backend_data, gpointer data, gchar const* key, gconstpointer* value, guint32* len)
+{
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = data;
+	MDB_txn* txn;
+	MDB_val m_key;
+	MDB_val m_value;
+	g_autofree gchar* nskey = NULL;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(len != NULL, FALSE);
+
+	// Use the write transaction if there is one, so that the batch's own modifications are visible
+	txn = batch->txn;
+
+	if (txn == NULL)
+	{
+		if (batch->read_txn == NULL)
+		{
+			batch->read_txn = lmdb_read_txn_acquire(bd);
+		}
+
+		txn = batch->read_txn;
+	}
+
+	if (txn == NULL)
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+
+	m_key.mv_size = strlen(nskey) + 1;
+	m_key.mv_data = nskey;
+
+	if (mdb_get(txn, bd->dbi, &m_key, &m_value) != 0)
+	{
+		return FALSE;
+	}
+
+	// The value points into the memory map and stays valid until the transaction ends or, for write transactions, the next modification
+	*value = m_value.mv_data;
+	*len = m_value.mv_size;
+
+	return TRUE;
+}
+
 static gboolean
 backend_get(gpointer backend_data, gpointer data, gchar const* key, gpointer* value, guint32* len)
 {
-	gboolean ret = FALSE;
+	gconstpointer borrowed;
+
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(len != NULL, FALSE);
+
+	if (!backend_get_borrowed(backend_data, data, key, &borrowed, len))
+	{
+		return FALSE;
+	}
+
+	*value = g_memdup(borrowed, *len);
+
+	return TRUE;
+}
+
+static gint
+backend_key_compare(gconstpointer a, gconstpointer b, gpointer data)
+{
+	gchar const* const* const* keys = data;
+
+	return strcmp((*keys)[*(guint32 const*)a], (*keys)[*(guint32 const*)b]);
+}
+
+static gboolean
+backend_get_multi(gpointer backend_data, gpointer backend_batch, gchar const* const* keys, guint32 count, gconstpointer* values, guint32* lens)
+{
+	g_autofree guint32* order = NULL;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(keys != NULL, FALSE);
+	g_return_val_if_fail(values != NULL, FALSE);
+	g_return_val_if_fail(lens != NULL, FALSE);
+
+	order = g_new(guint32, count);
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		order[i] = i;
+	}
+
+	// Looking up the keys in order lets neighboring lookups traverse the same B-tree pages
+	g_qsort_with_data(order, count, sizeof(guint32), backend_key_compare, &keys);
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		guint32 j = order[i];
+
+		if (!backend_get_borrowed(backend_data, backend_batch, keys[j], &(values[j]), &(lens[j])))
+		{
+			values[j] = NULL;
+			lens[j] = 0;
+		}
+	}
+
+	return TRUE;
+}
 
+static gboolean
+backend_compare_and_swap(gpointer backend_data, gpointer data, gchar const* key, gconstpointer expected, guint32 expected_len, gconstpointer value, guint32 len, gboolean* swapped)
+{
 	JLMDBData* bd = backend_data;
 	JLMDBBatch* batch = data;
 	MDB_val m_key;
 	MDB_val m_value;
 	g_autofree gchar* nskey = NULL;
+	gint ret;
 
 	g_return_val_if_fail(data != NULL, FALSE);
 	g_return_val_if_fail(key != NULL, FALSE);
 	g_return_val_if_fail(value != NULL, FALSE);
-	g_return_val_if_fail(len != NULL, FALSE);
+	g_return_val_if_fail(swapped != NULL, FALSE);
+
+	*swapped = FALSE;
+
+	// Reading within the write transaction prevents other writers from modifying the value in the meantime
+	if (!lmdb_write_txn_begin(bd, batch))
+	{
+		return FALSE;
+	}
 
 	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
 
 	m_key.mv_size = strlen(nskey) + 1;
 	m_key.mv_data = nskey;
 
-	if (mdb_get(batch->txn, bd->dbi, &m_key, &m_value) == 0)
+	ret = mdb_get(batch->txn, bd->dbi, &m_key, &m_value);
+
+	if (ret != 0 && ret != MDB_NOTFOUND)
 	{
-		// FIXME check whether copies can be avoided
-		*value = g_memdup(m_value.mv_data, m_value.mv_size);
-		*len = m_value.mv_size;
+		return FALSE;
+	}
 
-		ret = TRUE;
+	if (expected == NULL)
+	{
+		*swapped = (ret == MDB_NOTFOUND);
+	}
+	else
+	{
+		*swapped = (ret == 0 && m_value.mv_size == expected_len && memcmp(m_value.mv_data, expected, expected_len) == 0);
 	}
 
-	return ret;
+	if (!*swapped)
+	{
+		return TRUE;
+	}
+
+	m_value.mv_size = len;
+	m_value.mv_data = value;
+
+	return (mdb_put(batch->txn, bd->dbi, &m_key, &m_value, 0) == 0);
+}
+
+static gboolean
+backend_add(gpointer backend_data, gpointer data, gchar const* key, gint64 delta, gint64* result)
+{
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = data;
+	MDB_val m_key;
+	MDB_val m_value;
+	g_autofree gchar* nskey = NULL;
+	gint64 current = 0;
+	gint ret;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+
+	if (!lmdb_write_txn_begin(bd, batch))
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+
+	m_key.mv_size = strlen(nskey) + 1;
+	m_key.mv_data = nskey;
+
+	ret = mdb_get(batch->txn, bd->dbi, &m_key, &m_value);
+
+	if (ret == 0)
+	{
+		if (m_value.mv_size != sizeof(current))
+		{
+			return FALSE;
+		}
+
+		memcpy(&current, m_value.mv_data, sizeof(current));
+	}
+	else if (ret != MDB_NOTFOUND)
+	{
+		return FALSE;
+	}
+
+	current += delta;
+
+	m_value.mv_size = sizeof(current);
+	m_value.mv_data = &current;
+
+	if (mdb_put(batch->txn, bd->dbi, &m_key, &m_value, 0) != 0)
+	{
+		return FALSE;
+	}
+
+	*result = current;
+
+	return TRUE;
+}
+
+static gboolean
+backend_append(gpointer backend_data, gpointer data, gchar const* key, gconstpointer value, guint32 len)
+{
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = data;
+	MDB_val m_key;
+	MDB_val m_value;
+	g_autofree gchar* nskey = NULL;
+	g_autofree gchar* old_value = NULL;
+	gsize old_len = 0;
+	gint ret;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+
+	if (!lmdb_write_txn_begin(bd, batch))
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+
+	m_key.mv_size = strlen(nskey) + 1;
+	m_key.mv_data = nskey;
+
+	ret = mdb_get(batch->txn, bd->dbi, &m_key, &m_value);
+
+	if (ret == 0)
+	{
+		// The old value might be moved by the following put, copy it first
+		old_len = m_value.mv_size;
+		old_value = g_memdup(m_value.mv_data, old_len);
+	}
+	else if (ret != MDB_NOTFOUND)
+	{
+		return FALSE;
+	}
+
+	// Reserve space for the new value and fill it in place
+	m_value.mv_size = old_len + len;
+
+	if (mdb_put(batch->txn, bd->dbi, &m_key, &m_value, MDB_RESERVE) != 0)
+	{
+		return FALSE;
+	}
+
+	if (old_len > 0)
+	{
+		memcpy(m_value.mv_data, old_value, old_len);
+	}
+
+	memcpy((gchar*)m_value.mv_data + old_len, value, len);
+
+	return TRUE;
 }
 
 static gboolean
@@ -191,13 +593,32 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* data)
 	iterator->first = TRUE;
 	iterator->prefix = g_strdup_printf("%s:", namespace);
 	iterator->namespace_len = strlen(namespace) + 1;
+	iterator->start = NULL;
+	iterator->end = NULL;
+	iterator->reverse = FALSE;
+	iterator->limit = 0;
+	iterator->count = 0;
+
+	iterator->txn = lmdb_iterator_txn_acquire(bd);
+
+	if (iterator->txn == NULL || mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor)) != 0)
+	{
+		if (iterator->txn != NULL)
+		{
+			lmdb_iterator_txn_release(bd, iterator->txn);
+		}
 
-	mdb_txn_begin(bd->env, NULL, 0, &(iterator->txn));
-	mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor));
+		g_free(iterator->prefix);
+		g_free(iterator->start);
+		g_free(iterator->end);
+		g_slice_free(JLMDBIterator, iterator);
+
+		return FALSE;
+	}
 
 	*data = iterator;
 
-	return (iterator != NULL);
+	return TRUE;
 }
 
 static gboolean
@@ -214,41 +635,147 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	iterator->first = TRUE;
 	iterator->prefix = g_strdup_printf("%s:%s", namespace, prefix);
 	iterator->namespace_len = strlen(namespace) + 1;
+	iterator->start = NULL;
+	iterator->end = NULL;
+	iterator->reverse = FALSE;
+	iterator->limit = 0;
+	iterator->count = 0;
+
+	iterator->txn = lmdb_iterator_txn_acquire(bd);
+
+	if (iterator->txn == NULL || mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor)) != 0)
+	{
+		if (iterator->txn != NULL)
+		{
+			lmdb_iterator_txn_release(bd, iterator->txn);
+		}
+
+		g_free(iterator->prefix);
+		g_free(iterator->start);
+		g_free(iterator->end);
+		g_slice_free(JLMDBIterator, iterator);
+
+		return FALSE;
+	}
+
+	*data = iterator;
+
+	return TRUE;
+}
+
+static gboolean
+backend_get_range(gpointer backend_data, gchar const* namespace, gchar const* start, gchar const* end, guint32 limit, gboolean reverse, gpointer* data)
+{
+	JLMDBData* bd = backend_data;
+	JLMDBIterator* iterator = NULL;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	iterator = g_slice_new(JLMDBIterator);
+	iterator->first = TRUE;
+	iterator->prefix = g_strdup_printf("%s:", namespace);
+	iterator->namespace_len = strlen(namespace) + 1;
+	iterator->start = (start != NULL) ? g_strdup_printf("%s:%s", namespace, start) : NULL;
+	iterator->end = (end != NULL) ? g_strdup_printf("%s:%s", namespace, end) : NULL;
+	iterator->reverse = reverse;
+	iterator->limit = limit;
+	iterator->count = 0;
+
+	iterator->txn = lmdb_iterator_txn_acquire(bd);
+
+	if (iterator->txn == NULL || mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor)) != 0)
+	{
+		if (iterator->txn != NULL)
+		{
+			lmdb_iterator_txn_release(bd, iterator->txn);
+		}
 
-	mdb_txn_begin(bd->env, NULL, 0, &(iterator->txn));
-	mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor));
+		g_free(iterator->prefix);
+		g_free(iterator->start);
+		g_free(iterator->end);
+		g_slice_free(JLMDBIterator, iterator);
+
+		return FALSE;
+	}
 
 	*data = iterator;
 
-	return (iterator != NULL);
+	return TRUE;
+}
+
+static void
+backend_iterator_free(gpointer backend_data, gpointer data)
+{
+	JLMDBData* bd = backend_data;
+	JLMDBIterator* iterator = data;
+
+	mdb_cursor_close(iterator->cursor);
+	lmdb_iterator_txn_release(bd, iterator->txn);
+
+	g_free(iterator->prefix);
+	g_free(iterator->start);
+	g_free(iterator->end);
+	g_slice_free(JLMDBIterator, iterator);
 }
 
 static gboolean
 backend_iterate(gpointer backend_data, gpointer data, gchar const** key, gconstpointer* value, guint32* len)
 {
+	JLMDBData* bd = backend_data;
 	JLMDBIterator* iterator = data;
-	MDB_cursor_op cursor_op = MDB_NEXT;
 	MDB_val m_key;
 	MDB_val m_value;
-
-	(void)backend_data;
+	gint rc;
 
 	g_return_val_if_fail(data != NULL, FALSE);
 	g_return_val_if_fail(value != NULL, FALSE);
 	g_return_val_if_fail(len != NULL, FALSE);
 
+	if (iterator->limit > 0 && iterator->count >= iterator->limit)
+	{
+		goto out;
+	}
+
 	if (iterator->first)
 	{
+		g_autofree gchar* upper = NULL;
+
+		if (!iterator->reverse)
+		{
+			m_key.mv_data = (iterator->start != NULL) ? iterator->start : iterator->prefix;
+		}
+		else if (iterator->end != NULL)
+		{
+			m_key.mv_data = iterator->end;
+		}
+		else
+		{
+			// The first key after the namespace
+			upper = g_strdup(iterator->prefix);
+			upper[iterator->namespace_len - 1]++;
+			m_key.mv_data = upper;
+		}
+
 		// FIXME check +1
-		m_key.mv_size = strlen(iterator->prefix) + 1;
-		m_key.mv_data = iterator->prefix;
+		m_key.mv_size = strlen(m_key.mv_data) + 1;
 
-		cursor_op = MDB_SET_RANGE;
+		rc = mdb_cursor_get(iterator->cursor, &m_key, &m_value, MDB_SET_RANGE);
+
+		if (iterator->reverse)
+		{
+			// The cursor is positioned on the first key not in the range, go back one key
+			rc = mdb_cursor_get(iterator->cursor, &m_key, &m_value, (rc == 0) ? MDB_PREV : MDB_LAST);
+		}
 
 		iterator->first = FALSE;
 	}
+	else
+	{
+		rc = mdb_cursor_get(iterator->cursor, &m_key, &m_value, (iterator->reverse) ? MDB_PREV : MDB_NEXT);
+	}
 
-	if (mdb_cursor_get(iterator->cursor, &m_key, &m_value, cursor_op) == 0)
+	if (rc == 0)
 	{
 		if (!g_str_has_prefix(m_key.mv_data, iterator->prefix))
 		{
@@ -256,6 +783,13 @@ backend_iterate(gpointer backend_data, gpointer data, gchar const** key, gconstp
 			goto out;
 		}
 
+		if ((iterator->end != NULL && strcmp(m_key.mv_data, iterator->end) >= 0) || (iterator->start != NULL && strcmp(m_key.mv_data, iterator->start) < 0))
+		{
+			goto out;
+		}
+
+		iterator->count++;
+
 		*key = (gchar const*)m_key.mv_data + iterator->namespace_len;
 		*value = m_value.mv_data;
 		*len = m_value.mv_size;
@@ -264,10 +798,7 @@ backend_iterate(gpointer backend_data, gpointer data, gchar const** key, gconstp
 	}
 
 out:
-	mdb_txn_commit(iterator->txn);
-
-	g_free(iterator->prefix);
-	g_slice_free(JLMDBIterator, iterator);
+	backend_iterator_free(bd, iterator);
 
 	return FALSE;
 }
@@ -283,6 +814,8 @@ backend_init(gchar const* path, gpointer* backend_data)
 	g_mkdir_with_parents(path, 0700);
 
 	bd = g_slice_new(JLMDBData);
+	bd->read_txns = g_async_queue_new();
+	bd->iterators = 0;
 
 	if (mdb_env_create(&(bd->env)) == 0)
 	{
@@ -292,7 +825,13 @@ backend_init(gchar const* path, gpointer* backend_data)
 			goto error;
 		}
 
-		if (mdb_env_open(bd->env, path, 0, 0600) != 0)
+		if (mdb_env_set_maxreaders(bd->env, J_LMDB_MAX_READERS) != 0)
+		{
+			goto error;
+		}
+
+		// MDB_NOTLS ties reader slots to transactions instead of threads, allowing reset transactions to be renewed by any server thread
+		if (mdb_env_open(bd->env, path, MDB_NOTLS, 0600) != 0)
 		{
 			goto error;
 		}
@@ -319,6 +858,7 @@ backend_init(gchar const* path, gpointer* backend_data)
 
 error:
 	mdb_env_close(bd->env);
+	g_async_queue_unref(bd->read_txns);
 	g_slice_free(JLMDBData, bd);
 
 	return FALSE;
@@ -328,6 +868,14 @@ static void
 backend_fini(gpointer backend_data)
 {
 	JLMDBData* bd = backend_data;
+	MDB_txn* txn;
+
+	while ((txn = g_async_queue_try_pop(bd->read_txns)) != NULL)
+	{
+		mdb_txn_abort(txn);
+	}
+
+	g_async_queue_unref(bd->read_txns);
 
 	if (bd->env != NULL)
 	{
@@ -348,9 +896,16 @@ static JBackend lmdb_backend = {
 		.backend_put = backend_put,
 		.backend_delete = backend_delete,
 		.backend_get = backend_get,
+		.backend_get_borrowed = backend_get_borrowed,
+		.backend_get_multi = backend_get_multi,
+		.backend_compare_and_swap = backend_compare_and_swap,
+		.backend_add = backend_add,
+		.backend_append = backend_append,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_get_range = backend_get_range,
+		.backend_iterate = backend_iterate,
+		.backend_iterator_free = backend_iterator_free }
 };
 
 G_MODULE_EXPORT
@@ -0,0 +1,1022 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+#include <gmodule.h>
+
+#include <string.h>
+
+#include <julea.h>
+
+#define JD_MEMORY_SHARDS 16
+
+/**
+ * The maximum height of the skip list, enough for about 4^16 pairs.
+ */
+#define JD_MEMORY_LEVELS 16
+
+/**
+ * The number of pairs an iterator fetches while holding the lock.
+ */
+#define JD_MEMORY_ITERATOR_BATCH 64
+
+/**
+ * A key-value pair.
+ * Pairs are immutable and reference counted, so that readers can keep using them while they are being replaced.
+ */
+struct JMemoryEntry
+{
+	/**
+	 * The key, prefixed with the namespace.
+	 */
+	gchar* key;
+
+	gpointer value;
+	guint32 len;
+
+	gint ref_count;
+};
+
+typedef struct JMemoryEntry JMemoryEntry;
+
+/**
+ * A skip list node.
+ */
+struct JMemoryNode
+{
+	JMemoryEntry* entry;
+
+	guint level;
+	struct JMemoryNode* next[];
+};
+
+typedef struct JMemoryNode JMemoryNode;
+
+struct JMemoryShard
+{
+	/**
+	 * Serializes the modifications of the shard's pairs.
+	 * This makes compare-and-swap, add and append atomic without blocking modifications of other shards.
+	 */
+	GMutex modify;
+
+	GRWLock lock;
+
+	/**
+	 * The pairs, indexed by namespace and key.
+	 */
+	GHashTable* entries;
+};
+
+typedef struct JMemoryShard JMemoryShard;
+
+struct JMemoryData
+{
+	/**
+	 * Protects the skip list.
+	 * Modifications only hold it for writing while linking or unlinking a node.
+	 * Lookups only lock their shard and do not block each other.
+	 */
+	GRWLock lock;
+
+	/**
+	 * The skip list's head, ordering all pairs for prefix and range iteration.
+	 */
+	JMemoryNode* head;
+
+	JMemoryShard shards[JD_MEMORY_SHARDS];
+};
+
+typedef struct JMemoryData JMemoryData;
+
+struct JMemoryBatch
+{
+	gchar* namespace;
+
+	/**
+	 * Pairs returned by backend_get_borrowed(), kept alive until the batch is executed.
+	 */
+	GPtrArray* borrowed;
+};
+
+typedef struct JMemoryBatch JMemoryBatch;
+
+/**
+ * An iterator walking the skip list.
+ * Pairs are fetched in small batches, continuing after the last fetched pair.
+ * Therefore, the lock does not have to be held between iterate calls.
+ */
+struct JMemoryIterator
+{
+	/**
+	 * The fetched pairs that have not been returned yet.
+	 */
+	GPtrArray* entries;
+	guint index;
+
+	/**
+	 * The last fetched pair, NULL if nothing has been fetched yet.
+	 */
+	JMemoryEntry* position;
+
+	gchar* prefix;
+	gchar* start;
+	gchar* end;
+	gsize namespace_len;
+
+	guint32 limit;
+	guint32 count;
+	gboolean reverse;
+	gboolean done;
+};
+
+typedef struct JMemoryIterator JMemoryIterator;
+
+static JMemoryEntry*
+backend_entry_new(gchar* key, gconstpointer value, guint32 len)
+{
+	JMemoryEntry* entry;
+
+	entry = g_slice_new(JMemoryEntry);
+	entry->key = key;
+	entry->value = g_malloc(len);
+	entry->len = len;
+	entry->ref_count = 1;
+
+	if (len > 0)
+	{
+		memcpy(entry->value, value, len);
+	}
+
+	return entry;
+}
+
+static JMemoryEntry*
+backend_entry_ref(JMemoryEntry* entry)
+{
+	g_atomic_int_inc(&(entry->ref_count));
+
+	return entry;
+}
+
+static void
+backend_entry_unref(gpointer data)
+{
+	JMemoryEntry* entry = data;
+
+	if (g_atomic_int_dec_and_test(&(entry->ref_count)))
+	{
+		g_free(entry->key);
+		g_free(entry->value);
+		g_slice_free(JMemoryEntry, entry);
+	}
+}
+
+static JMemoryShard*
+backend_get_shard(JMemoryData* bd, gchar const* key)
+{
+	return &(bd->shards[g_str_hash(key) % JD_MEMORY_SHARDS]);
+}
+
+static JMemoryNode*
+backend_node_new(JMemoryEntry* entry, guint level)
+{
+	JMemoryNode* node;
+
+	node = g_malloc0(sizeof(JMemoryNode) + level * sizeof(JMemoryNode*));
+	node->entry = entry;
+	node->level = level;
+
+	return node;
+}
+
+static guint
+backend_node_random_level(void)
+{
+	guint level = 1;
+
+	// Every level contains a quarter of the nodes of the level below
+	while (level < JD_MEMORY_LEVELS && (g_random_int() & 3) == 0)
+	{
+		level++;
+	}
+
+	return level;
+}
+
+/**
+ * Finds the first node whose key is not less than the given key.
+ * Has to be called with the lock held.
+ *
+ * \param update Filled with the last node before the key on each level, can be NULL.
+ */
+static JMemoryNode*
+backend_lower_bound(JMemoryData* bd, gchar const* key, JMemoryNode** update)
+{
+	JMemoryNode* node = bd->head;
+
+	for (guint i = JD_MEMORY_LEVELS; i-- > 0;)
+	{
+		while (node->next[i] != NULL && strcmp(node->next[i]->entry->key, key) < 0)
+		{
+			node = node->next[i];
+		}
+
+		if (update != NULL)
+		{
+			update[i] = node;
+		}
+	}
+
+	return node->next[0];
+}
+
+/**
+ * Looks up a pair.
+ *
+ * \return A new reference to the pair, NULL if it does not exist.
+ */
+static JMemoryEntry*
+backend_lookup(JMemoryData* bd, gchar const* key)
+{
+	JMemoryShard* shard;
+	JMemoryEntry* entry;
+
+	shard = backend_get_shard(bd, key);
+
+	g_rw_lock_reader_lock(&(shard->lock));
+
+	entry = g_hash_table_lookup(shard->entries, key);
+
+	if (entry != NULL)
+	{
+		backend_entry_ref(entry);
+	}
+
+	g_rw_lock_reader_unlock(&(shard->lock));
+
+	return entry;
+}
+
+/**
+ * Finds the last node whose key is less than the given key.
+ * Has to be called with the lock held.
+ *
+ * \param key The key, NULL to find the last node.
+ *
+ * \return The node, NULL if there is none.
+ */
+static JMemoryNode*
+backend_predecessor(JMemoryData* bd, gchar const* key)
+{
+	JMemoryNode* node = bd->head;
+
+	for (guint i = JD_MEMORY_LEVELS; i-- > 0;)
+	{
+		while (node->next[i] != NULL && (key == NULL || strcmp(node->next[i]->entry->key, key) < 0))
+		{
+			node = node->next[i];
+		}
+	}
+
+	return (node != bd->head) ? node : NULL;
+}
+
+/**
+ * Stores a pair, replacing an existing one.
+ * Has to be called with the key's shard locked for modification.
+ */
+static void
+backend_store(JMemoryData* bd, gchar* key, gconstpointer value, guint32 len)
+{
+	JMemoryNode* update[JD_MEMORY_LEVELS];
+	JMemoryShard* shard;
+	JMemoryEntry* entry;
+	JMemoryNode* node;
+
+	// Copy the value before taking the lock
+	entry = backend_entry_new(key, value, len);
+
+	g_rw_lock_writer_lock(&(bd->lock));
+
+	node = backend_lower_bound(bd, key, update);
+
+	if (node != NULL && strcmp(node->entry->key, key) == 0)
+	{
+		backend_entry_unref(node->entry);
+		node->entry = entry;
+	}
+	else
+	{
+		node = backend_node_new(entry, backend_node_random_level());
+
+		for (guint i = 0; i < node->level; i++)
+		{
+			node->next[i] = update[i]->next[i];
+			update[i]->next[i] = node;
+		}
+	}
+
+	g_rw_lock_writer_unlock(&(bd->lock));
+
+	backend_entry_ref(entry);
+
+	shard = backend_get_shard(bd, key);
+
+	g_rw_lock_writer_lock(&(shard->lock));
+	g_hash_table_replace(shard->entries, entry->key, entry);
+	g_rw_lock_writer_unlock(&(shard->lock));
+}
+
+/**
+ * Removes a pair.
+ * Has to be called with the key's shard locked for modification.
+ *
+ * \return TRUE if the pair existed, FALSE otherwise.
+ */
+static gboolean
+backend_remove(JMemoryData* bd, gchar const* key)
+{
+	JMemoryNode* update[JD_MEMORY_LEVELS];
+	JMemoryShard* shard;
+	JMemoryNode* node;
+
+	g_rw_lock_writer_lock(&(bd->lock));
+
+	node = backend_lower_bound(bd, key, update);
+
+	if (node == NULL || strcmp(node->entry->key, key) != 0)
+	{
+		g_rw_lock_writer_unlock(&(bd->lock));
+
+		return FALSE;
+	}
+
+	for (guint i = 0; i < node->level; i++)
+	{
+		update[i]->next[i] = node->next[i];
+	}
+
+	g_rw_lock_writer_unlock(&(bd->lock));
+
+	shard = backend_get_shard(bd, key);
+
+	g_rw_lock_writer_lock(&(shard->lock));
+	g_hash_table_remove(shard->entries, key);
+	g_rw_lock_writer_unlock(&(shard->lock));
+
+	backend_entry_unref(node->entry);
+	g_free(node);
+
+	return TRUE;
+}
+
+/**
+ * Returns the smallest key that is greater than all keys starting with prefix.
+ *
+ * \return The key, NULL if there is none.
+ */
+static gchar*
+backend_prefix_successor(gchar const* prefix)
+{
+	gchar* successor;
+	gsize len;
+
+	successor = g_strdup(prefix);
+	len = strlen(successor);
+
+	while (len > 0 && (guchar)successor[len - 1] == 0xff)
+	{
+		len--;
+	}
+
+	if (len == 0)
+	{
+		g_free(successor);
+		return NULL;
+	}
+
+	successor[len - 1] = (guchar)successor[len - 1] + 1;
+	successor[len] = '\0';
+
+	return successor;
+}
+
+/**
+ * Creates an iterator over all pairs starting with prefix, beginning at start and stopping before end.
+ * The pairs are fetched lazily by backend_iterator_fetch().
+ */
+static JMemoryIterator*
+backend_iterator_new(gsize namespace_len, gchar const* prefix, gchar const* start, gchar const* end, guint32 limit, gboolean reverse)
+{
+	JMemoryIterator* iterator;
+
+	iterator = g_slice_new(JMemoryIterator);
+	iterator->entries = g_ptr_array_new_with_free_func(backend_entry_unref);
+	iterator->index = 0;
+	iterator->position = NULL;
+	iterator->prefix = g_strdup(prefix);
+	iterator->start = g_strdup(start);
+	// Reverse scans start before the end, which is derived from the prefix if necessary
+	iterator->end = (end != NULL || !reverse) ? g_strdup(end) : backend_prefix_successor(prefix);
+	iterator->namespace_len = namespace_len;
+	iterator->limit = limit;
+	iterator->count = 0;
+	iterator->reverse = reverse;
+	iterator->done = FALSE;
+
+	return iterator;
+}
+
+/**
+ * Returns whether a pair is part of the iterator's range.
+ */
+static gboolean
+backend_iterator_contains(JMemoryIterator* iterator, gchar const* key)
+{
+	if (!g_str_has_prefix(key, iterator->prefix))
+	{
+		return FALSE;
+	}
+
+	if (iterator->start != NULL && strcmp(key, iterator->start) < 0)
+	{
+		return FALSE;
+	}
+
+	if (iterator->end != NULL && strcmp(key, iterator->end) >= 0)
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Fetches the next batch of pairs, continuing after the last fetched pair.
+ * Pairs that have been inserted or removed in the meantime are taken into account.
+ */
+static void
+backend_iterator_fetch(JMemoryData* bd, JMemoryIterator* iterator)
+{
+	JMemoryNode* node;
+
+	g_ptr_array_set_size(iterator->entries, 0);
+	iterator->index = 0;
+
+	g_rw_lock_reader_lock(&(bd->lock));
+
+	if (!iterator->reverse)
+	{
+		if (iterator->position == NULL)
+		{
+			node = backend_lower_bound(bd, (iterator->start != NULL) ? iterator->start : iterator->prefix, NULL);
+		}
+		else
+		{
+			node = backend_lower_bound(bd, iterator->position->key, NULL);
+
+			if (node != NULL && strcmp(node->entry->key, iterator->position->key) == 0)
+			{
+				node = node->next[0];
+			}
+		}
+	}
+	else
+	{
+		node = backend_predecessor(bd, (iterator->position != NULL) ? iterator->position->key : iterator->end);
+	}
+
+	while (iterator->entries->len < JD_MEMORY_ITERATOR_BATCH)
+	{
+		if (node == NULL || !backend_iterator_contains(iterator, node->entry->key) || (iterator->limit > 0 && iterator->count >= iterator->limit))
+		{
+			iterator->done = TRUE;
+			break;
+		}
+
+		g_ptr_array_add(iterator->entries, backend_entry_ref(node->entry));
+		iterator->count++;
+
+		// The skip list is only linked forward, so reverse scans have to search for each predecessor
+		node = (iterator->reverse) ? backend_predecessor(bd, node->entry->key) : node->next[0];
+	}
+
+	g_rw_lock_reader_unlock(&(bd->lock));
+
+	if (iterator->entries->len > 0)
+	{
+		if (iterator->position != NULL)
+		{
+			backend_entry_unref(iterator->position);
+		}
+
+		iterator->position = backend_entry_ref(g_ptr_array_index(iterator->entries, iterator->entries->len - 1));
+	}
+}
+
+static gboolean
+backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* data)
+{
+	JMemoryBatch* batch;
+
+	(void)backend_data;
+	(void)semantics;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	batch = g_slice_new(JMemoryBatch);
+	batch->namespace = g_strdup(namespace);
+	batch->borrowed = NULL;
+
+	*data = batch;
+
+	return TRUE;
+}
+
+static gboolean
+backend_batch_execute(gpointer backend_data, gpointer data)
+{
+	JMemoryBatch* batch = data;
+
+	(void)backend_data;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	// Operations are applied immediately, only the borrowed values have to be released
+	if (batch->borrowed != NULL)
+	{
+		g_ptr_array_unref(batch->borrowed);
+	}
+
+	g_free(batch->namespace);
+	g_slice_free(JMemoryBatch, batch);
+
+	return TRUE;
+}
+
+static gboolean
+backend_put(gpointer backend_data, gpointer data, gchar const* key, gconstpointer value, guint32 len)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryBatch* batch = data;
+	JMemoryShard* shard;
+	gchar* nskey;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	shard = backend_get_shard(bd, nskey);
+
+	g_mutex_lock(&(shard->modify));
+	backend_store(bd, nskey, value, len);
+	g_mutex_unlock(&(shard->modify));
+
+	return TRUE;
+}
+
+static gboolean
+backend_delete(gpointer backend_data, gpointer data, gchar const* key)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryBatch* batch = data;
+	JMemoryShard* shard;
+	g_autofree gchar* nskey = NULL;
+	gboolean ret;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	shard = backend_get_shard(bd, nskey);
+
+	g_mutex_lock(&(shard->modify));
+	ret = backend_remove(bd, nskey);
+	g_mutex_unlock(&(shard->modify));
+
+	return ret;
+}
+
+static gboolean
+backend_get_borrowed(gpointer backend_data, gpointer data, gchar const* key, gconstpointer* value, guint32* len)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryBatch* batch = data;
+	JMemoryEntry* entry;
+	g_autofree gchar* nskey = NULL;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(len != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	entry = backend_lookup(bd, nskey);
+
+	if (entry == NULL)
+	{
+		return FALSE;
+	}
+
+	if (batch->borrowed == NULL)
+	{
+		batch->borrowed = g_ptr_array_new_with_free_func(backend_entry_unref);
+	}
+
+	// The pair is kept alive by the batch even if it is replaced in the meantime
+	g_ptr_array_add(batch->borrowed, entry);
+
+	*value = entry->value;
+	*len = entry->len;
+
+	return TRUE;
+}
+
+static gboolean
+backend_get(gpointer backend_data, gpointer data, gchar const* key, gpointer* value, guint32* len)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryBatch* batch = data;
+	JMemoryEntry* entry;
+	g_autofree gchar* nskey = NULL;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(len != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	entry = backend_lookup(bd, nskey);
+
+	if (entry == NULL)
+	{
+		return FALSE;
+	}
+
+	*value = g_memdup(entry->value, entry->len);
+	*len = entry->len;
+
+	backend_entry_unref(entry);
+
+	return TRUE;
+}
+
+static gboolean
+backend_compare_and_swap(gpointer backend_data, gpointer data, gchar const* key, gconstpointer expected, guint32 expected_len, gconstpointer value, guint32 len, gboolean* swapped)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryBatch* batch = data;
+	JMemoryShard* shard;
+	JMemoryEntry* entry;
+	gchar* nskey;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(swapped != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	shard = backend_get_shard(bd, nskey);
+
+	// Locking the shard prevents other modifications of the pair between the comparison and the replacement
+	g_mutex_lock(&(shard->modify));
+
+	entry = backend_lookup(bd, nskey);
+
+	if (expected == NULL)
+	{
+		*swapped = (entry == NULL);
+	}
+	else
+	{
+		*swapped = (entry != NULL && entry->len == expected_len && memcmp(entry->value, expected, expected_len) == 0);
+	}
+
+	if (*swapped)
+	{
+		backend_store(bd, nskey, value, len);
+	}
+	else
+	{
+		g_free(nskey);
+	}
+
+	g_mutex_unlock(&(shard->modify));
+
+	if (entry != NULL)
+	{
+		backend_entry_unref(entry);
+	}
+
+	return TRUE;
+}
+
+static gboolean
+backend_add(gpointer backend_data, gpointer data, gchar const* key, gint64 delta, gint64* result)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryBatch* batch = data;
+	JMemoryShard* shard;
+	JMemoryEntry* entry;
+	gchar* nskey;
+	gint64 current = 0;
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	shard = backend_get_shard(bd, nskey);
+
+	g_mutex_lock(&(shard->modify));
+
+	entry = backend_lookup(bd, nskey);
+
+	if (entry != NULL)
+	{
+		if (entry->len == sizeof(current))
+		{
+			memcpy(&current, entry->value, sizeof(current));
+		}
+		else
+		{
+			ret = FALSE;
+		}
+
+		backend_entry_unref(entry);
+	}
+
+	if (ret)
+	{
+		current += delta;
+		backend_store(bd, nskey, &current, sizeof(current));
+
+		*result = current;
+	}
+	else
+	{
+		g_free(nskey);
+	}
+
+	g_mutex_unlock(&(shard->modify));
+
+	return ret;
+}
+
+static gboolean
+backend_append(gpointer backend_data, gpointer data, gchar const* key, gconstpointer value, guint32 len)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryBatch* batch = data;
+	JMemoryShard* shard;
+	JMemoryEntry* entry;
+	gchar* nskey;
+	g_autofree gchar* new_value = NULL;
+	guint32 old_len = 0;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	shard = backend_get_shard(bd, nskey);
+
+	g_mutex_lock(&(shard->modify));
+
+	entry = backend_lookup(bd, nskey);
+
+	if (entry != NULL)
+	{
+		old_len = entry->len;
+	}
+
+	new_value = g_malloc(old_len + len);
+
+	if (entry != NULL)
+	{
+		memcpy(new_value, entry->value, old_len);
+		backend_entry_unref(entry);
+	}
+
+	memcpy(new_value + old_len, value, len);
+
+	backend_store(bd, nskey, new_value, old_len + len);
+
+	g_mutex_unlock(&(shard->modify));
+
+	return TRUE;
+}
+
+static gboolean
+backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* data)
+{
+	g_autofree gchar* prefix = NULL;
+
+	(void)backend_data;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	prefix = g_strdup_printf("%s:", namespace);
+
+	*data = backend_iterator_new(strlen(prefix), prefix, NULL, NULL, 0, FALSE);
+
+	return TRUE;
+}
+
+static gboolean
+backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const* prefix, gpointer* data)
+{
+	g_autofree gchar* nsprefix = NULL;
+
+	(void)backend_data;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(prefix != NULL, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	nsprefix = g_strdup_printf("%s:%s", namespace, prefix);
+
+	*data = backend_iterator_new(strlen(namespace) + 1, nsprefix, NULL, NULL, 0, FALSE);
+
+	return TRUE;
+}
+
+static gboolean
+backend_get_range(gpointer backend_data, gchar const* namespace, gchar const* start, gchar const* end, guint32 limit, gboolean reverse, gpointer* data)
+{
+	g_autofree gchar* prefix = NULL;
+	g_autofree gchar* nsstart = NULL;
+	g_autofree gchar* nsend = NULL;
+
+	(void)backend_data;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	prefix = g_strdup_printf("%s:", namespace);
+	nsstart = (start != NULL) ? g_strdup_printf("%s:%s", namespace, start) : NULL;
+	nsend = (end != NULL) ? g_strdup_printf("%s:%s", namespace, end) : NULL;
+
+	*data = backend_iterator_new(strlen(prefix), prefix, nsstart, nsend, limit, reverse);
+
+	return TRUE;
+}
+
+static void
+backend_iterator_free(gpointer backend_data, gpointer data)
+{
+	JMemoryIterator* iterator = data;
+
+	(void)backend_data;
+
+	if (iterator->position != NULL)
+	{
+		backend_entry_unref(iterator->position);
+	}
+
+	g_ptr_array_unref(iterator->entries);
+	g_free(iterator->prefix);
+	g_free(iterator->start);
+	g_free(iterator->end);
+	g_slice_free(JMemoryIterator, iterator);
+}
+
+static gboolean
+backend_iterate(gpointer backend_data, gpointer data, gchar const** key, gconstpointer* value, guint32* len)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryIterator* iterator = data;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(len != NULL, FALSE);
+
+	if (iterator->index >= iterator->entries->len && !iterator->done)
+	{
+		backend_iterator_fetch(bd, iterator);
+	}
+
+	if (iterator->index < iterator->entries->len)
+	{
+		JMemoryEntry* entry = g_ptr_array_index(iterator->entries, iterator->index);
+
+		iterator->index++;
+
+		*key = entry->key + iterator->namespace_len;
+		*value = entry->value;
+		*len = entry->len;
+
+		return TRUE;
+	}
+
+	backend_iterator_free(backend_data, iterator);
+
+	return FALSE;
+}
+
+static gboolean
+backend_init(gchar const* path, gpointer* backend_data)
+{
+	JMemoryData* bd;
+
+	(void)path;
+
+	bd = g_slice_new(JMemoryData);
+	bd->head = backend_node_new(NULL, JD_MEMORY_LEVELS);
+
+	g_rw_lock_init(&(bd->lock));
+
+	for (guint i = 0; i < JD_MEMORY_SHARDS; i++)
+	{
+		g_mutex_init(&(bd->shards[i].modify));
+		g_rw_lock_init(&(bd->shards[i].lock));
+		// The keys belong to the pairs
+		bd->shards[i].entries = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, backend_entry_unref);
+	}
+
+	*backend_data = bd;
+
+	return TRUE;
+}
+
+static void
+backend_fini(gpointer backend_data)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryNode* node;
+
+	for (guint i = 0; i < JD_MEMORY_SHARDS; i++)
+	{
+		g_hash_table_destroy(bd->shards[i].entries);
+		g_rw_lock_clear(&(bd->shards[i].lock));
+		g_mutex_clear(&(bd->shards[i].modify));
+	}
+
+	node = bd->head->next[0];
+
+	while (node != NULL)
+	{
+		JMemoryNode* next = node->next[0];
+
+		backend_entry_unref(node->entry);
+		g_free(node);
+
+		node = next;
+	}
+
+	g_free(bd->head);
+	g_rw_lock_clear(&(bd->lock));
+
+	g_slice_free(JMemoryData, bd);
+}
+
+static JBackend memory_backend = {
+	.type = J_BACKEND_TYPE_KV,
+	.component = J_BACKEND_COMPONENT_CLIENT | J_BACKEND_COMPONENT_SERVER,
+	.kv = {
+		.backend_init = backend_init,
+		.backend_fini = backend_fini,
+		.backend_batch_start = backend_batch_start,
+		.backend_batch_execute = backend_batch_execute,
+		.backend_put = backend_put,
+		.backend_delete = backend_delete,
+		.backend_get = backend_get,
+		.backend_get_borrowed = backend_get_borrowed,
+		.backend_compare_and_swap = backend_compare_and_swap,
+		.backend_add = backend_add,
+		.backend_append = backend_append,
+		.backend_get_all = backend_get_all,
+		.backend_get_by_prefix = backend_get_by_prefix,
+		.backend_get_range = backend_get_range,
+		.backend_iterate = backend_iterate,
+		.backend_iterator_free = backend_iterator_free }
+};
+
+G_MODULE_EXPORT
+JBackend*
+backend_info(void)
+{
+	return &memory_backend;
+}
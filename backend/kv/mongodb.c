@@ -278,6 +278,77 @@ backend_get(gpointer backend_data, gpointer backend_batch, gchar const* key, gpo
 	return ret;
 }
 
+static gboolean
+backend_compare_and_swap(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer expected, guint32 expected_len, gconstpointer value, guint32 len, gboolean* swapped)
+{
+	gboolean ret = FALSE;
+
+	JMongoDBBatch* batch = backend_batch;
+	JMongoDBData* bd = backend_data;
+
+	bson_error_t error;
+	bson_t document[1];
+	bson_t reply[1];
+	mongoc_collection_t* m_collection;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(swapped != NULL, FALSE);
+
+	*swapped = FALSE;
+
+	bson_init(document);
+	bson_append_utf8(document, "key", -1, key, -1);
+	bson_append_binary(document, "value", -1, BSON_SUBTYPE_BINARY, value, len);
+
+	m_collection = mongoc_client_get_collection(bd->connection, bd->database, batch->namespace);
+
+	if (expected == NULL)
+	{
+		// The unique index on the key makes the insert fail if the pair already exists
+		if (mongoc_collection_insert_one(m_collection, document, NULL, reply, &error))
+		{
+			*swapped = TRUE;
+			ret = TRUE;
+		}
+		else
+		{
+			ret = (error.code == MONGOC_ERROR_DUPLICATE_KEY);
+		}
+	}
+	else
+	{
+		bson_iter_t iter;
+		bson_t selector[1];
+		mongoc_find_and_modify_opts_t* opts;
+
+		bson_init(selector);
+		bson_append_utf8(selector, "key", -1, key, -1);
+		bson_append_binary(selector, "value", -1, BSON_SUBTYPE_BINARY, expected, expected_len);
+
+		opts = mongoc_find_and_modify_opts_new();
+		mongoc_find_and_modify_opts_set_update(opts, document);
+
+		// The document is only replaced if it still contains the expected value
+		if (mongoc_collection_find_and_modify_with_opts(m_collection, selector, opts, reply, &error))
+		{
+			*swapped = (bson_iter_init_find(&iter, reply, "value") && BSON_ITER_HOLDS_DOCUMENT(&iter));
+			ret = TRUE;
+		}
+
+		mongoc_find_and_modify_opts_destroy(opts);
+		bson_destroy(selector);
+	}
+
+	bson_destroy(reply);
+	bson_destroy(document);
+
+	mongoc_collection_destroy(m_collection);
+
+	return ret;
+}
+
 static gboolean
 backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend_iterator)
 {
@@ -285,6 +356,8 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend
 	gboolean ret = FALSE;
 
 	bson_t document[1];
+	bson_t opts[1];
+	bson_t sort[1];
 	mongoc_collection_t* m_collection;
 	mongoc_cursor_t* cursor;
 
@@ -293,8 +366,14 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend
 
 	bson_init(document);
 
+	// Return the pairs in key order, the unique index on the key makes this cheap
+	bson_init(opts);
+	bson_append_document_begin(opts, "sort", -1, sort);
+	bson_append_int32(sort, "key", -1, 1);
+	bson_append_document_end(opts, sort);
+
 	m_collection = mongoc_client_get_collection(bd->connection, bd->database, namespace);
-	cursor = mongoc_collection_find_with_opts(m_collection, document, NULL, NULL);
+	cursor = mongoc_collection_find_with_opts(m_collection, document, opts, NULL);
 
 	if (cursor != NULL)
 	{
@@ -305,6 +384,7 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend
 	mongoc_collection_destroy(m_collection);
 
 	bson_destroy(document);
+	bson_destroy(opts);
 
 	return ret;
 }
@@ -316,6 +396,8 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	gboolean ret = FALSE;
 
 	bson_t document[1];
+	bson_t opts[1];
+	bson_t sort[1];
 	mongoc_collection_t* m_collection;
 	mongoc_cursor_t* cursor;
 	g_autofree gchar* escaped_prefix = NULL;
@@ -331,8 +413,14 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	bson_init(document);
 	bson_append_regex(document, "key", -1, regex_prefix, NULL);
 
+	// Return the pairs in key order, the unique index on the key makes this cheap
+	bson_init(opts);
+	bson_append_document_begin(opts, "sort", -1, sort);
+	bson_append_int32(sort, "key", -1, 1);
+	bson_append_document_end(opts, sort);
+
 	m_collection = mongoc_client_get_collection(bd->connection, bd->database, namespace);
-	cursor = mongoc_collection_find_with_opts(m_collection, document, NULL, NULL);
+	cursor = mongoc_collection_find_with_opts(m_collection, document, opts, NULL);
 
 	if (cursor != NULL)
 	{
@@ -343,10 +431,21 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	mongoc_collection_destroy(m_collection);
 
 	bson_destroy(document);
+	bson_destroy(opts);
 
 	return ret;
 }
 
+static void
+backend_iterator_free(gpointer backend_data, gpointer backend_iterator)
+{
+	mongoc_cursor_t* cursor = backend_iterator;
+
+	(void)backend_data;
+
+	mongoc_cursor_destroy(cursor);
+}
+
 static gboolean
 backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const** key, gconstpointer* value, guint32* len)
 {
@@ -473,9 +572,11 @@ static JBackend mongodb_backend = {
 		.backend_put = backend_put,
 		.backend_delete = backend_delete,
 		.backend_get = backend_get,
+		.backend_compare_and_swap = backend_compare_and_swap,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_iterate = backend_iterate,
+		.backend_iterator_free = backend_iterator_free }
 };
 
 G_MODULE_EXPORT
@@ -21,6 +21,8 @@
 #include <glib.h>
 #include <gmodule.h>
 
+#include <string.h>
+
 #include <rocksdb/c.h>
 
 #include <julea.h>
@@ -30,6 +32,26 @@ struct JRocksDBBatch
 	rocksdb_writebatch_t* batch;
 	gchar* namespace;
 	JSemantics* semantics;
+
+	/**
+	 * Values returned by backend_get_borrowed(), freed when the batch is executed.
+	 */
+	GPtrArray* values;
+
+	/**
+	 * Values returned by backend_get_multi(), freed when the batch is executed.
+	 */
+	GPtrArray* buffers;
+
+	/**
+	 * Whether the batch contains modifications that have not been written yet.
+	 */
+	gboolean pending;
+
+	/**
+	 * Whether the batch holds the lock for atomic operations.
+	 */
+	gboolean locked;
 };
 
 typedef struct JRocksDBBatch JRocksDBBatch;
@@ -41,6 +63,21 @@ struct JRocksDBData
 	rocksdb_readoptions_t* read_options;
 	rocksdb_writeoptions_t* write_options;
 	rocksdb_writeoptions_t* write_options_sync;
+
+	/**
+	 * Read options for iterators that stay within their namespace.
+	 */
+	rocksdb_readoptions_t* prefix_read_options;
+
+	/**
+	 * The block cache, NULL if RocksDB's default is used.
+	 */
+	rocksdb_cache_t* cache;
+
+	/**
+	 * Serializes atomic operations.
+	 */
+	GMutex lock;
 };
 
 typedef struct JRocksDBData JRocksDBData;
@@ -51,10 +88,141 @@ struct JRocksDBIterator
 	gboolean first;
 	gchar* prefix;
 	gsize namespace_len;
+
+	/**
+	 * The range to iterate over, NULL if unbounded.
+	 * The start is inclusive, the end is exclusive.
+	 */
+	gchar* start;
+	gchar* end;
+	gboolean reverse;
+
+	/**
+	 * The maximum number of pairs to return, 0 for no limit.
+	 */
+	guint32 limit;
+	guint32 count;
 };
 
 typedef struct JRocksDBIterator JRocksDBIterator;
 
+static void
+rocksdb_value_free(gpointer data)
+{
+	rocksdb_pinnableslice_destroy(data);
+}
+
+static void
+rocksdb_buffer_free(gpointer data)
+{
+	rocksdb_free(data);
+}
+
+/**
+ * Returns a numeric option from the backend path.
+ */
+static guint64
+rocksdb_option_get(GHashTable* options, gchar const* name, guint64 default_value)
+{
+	gchar const* value;
+
+	if ((value = g_hash_table_lookup(options, name)) != NULL)
+	{
+		return g_ascii_strtoull(value, NULL, 10);
+	}
+
+	return default_value;
+}
+
+/**
+ * Extracts the namespace from a key for the prefix bloom filters.
+ * Keys have the form namespace:key, the prefix ends at the first colon and includes it.
+ * Namespaces containing colons therefore share a prefix with other namespaces starting the same way.
+ * For example, all distributed-object:* namespaces use the prefix distributed-object: and one bloom filter entry.
+ * Iterations are still correct, they only cannot skip files containing the other namespaces.
+ */
+static gchar*
+rocksdb_namespace_transform(gpointer data, gchar const* key, gsize length, gsize* dst_length)
+{
+	gchar const* separator;
+
+	(void)data;
+
+	separator = memchr(key, ':', length);
+	*dst_length = separator - key + 1;
+
+	// The prefix starts at the beginning of the key
+	return (gchar*)key;
+}
+
+static guchar
+rocksdb_namespace_in_domain(gpointer data, gchar const* key, gsize length)
+{
+	(void)data;
+
+	return (memchr(key, ':', length) != NULL);
+}
+
+static guchar
+rocksdb_namespace_in_range(gpointer data, gchar const* key, gsize length)
+{
+	(void)data;
+	(void)key;
+	(void)length;
+
+	return 0;
+}
+
+static gchar const*
+rocksdb_namespace_name(gpointer data)
+{
+	(void)data;
+
+	return "julea.namespace";
+}
+
+static void
+rocksdb_namespace_destroy(gpointer data)
+{
+	(void)data;
+}
+
+/**
+ * Prepares a batch for an atomic operation.
+ * Atomic operations read the stored values directly, so the batch's previous modifications are written first.
+ * The lock is held until the batch has been executed, so that other atomic operations cannot interfere in the meantime.
+ * Batches without atomic operations do not take the lock and can be written concurrently.
+ */
+static gboolean
+rocksdb_batch_lock(JRocksDBData* bd, JRocksDBBatch* batch)
+{
+	g_autofree gchar* rocksdb_error = NULL;
+
+	rocksdb_writeoptions_t* write_options = bd->write_options;
+
+	if (!batch->locked)
+	{
+		g_mutex_lock(&(bd->lock));
+		batch->locked = TRUE;
+	}
+
+	if (!batch->pending)
+	{
+		return TRUE;
+	}
+
+	if (j_semantics_get(batch->semantics, J_SEMANTICS_SAFETY) == J_SEMANTICS_SAFETY_STORAGE)
+	{
+		write_options = bd->write_options_sync;
+	}
+
+	rocksdb_write(bd->db, write_options, batch->batch, &rocksdb_error);
+	rocksdb_writebatch_clear(batch->batch);
+	batch->pending = FALSE;
+
+	return (rocksdb_error == NULL);
+}
+
 static gboolean
 backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* backend_batch)
 {
@@ -70,6 +238,10 @@ backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* s
 	batch->batch = rocksdb_writebatch_create();
 	batch->namespace = g_strdup(namespace);
 	batch->semantics = j_semantics_ref(semantics);
+	batch->values = NULL;
+	batch->buffers = NULL;
+	batch->pending = FALSE;
+	batch->locked = FALSE;
 
 	*backend_batch = batch;
 
@@ -95,6 +267,21 @@ backend_batch_execute(gpointer backend_data, gpointer backend_batch)
 
 	rocksdb_write(bd->db, write_options, batch->batch, &rocksdb_error);
 
+	if (batch->locked)
+	{
+		g_mutex_unlock(&(bd->lock));
+	}
+
+	if (batch->values != NULL)
+	{
+		g_ptr_array_unref(batch->values);
+	}
+
+	if (batch->buffers != NULL)
+	{
+		g_ptr_array_unref(batch->buffers);
+	}
+
 	j_semantics_unref(batch->semantics);
 	g_free(batch->namespace);
 	rocksdb_writebatch_destroy(batch->batch);
@@ -117,6 +304,7 @@ backend_put(gpointer backend_data, gpointer backend_batch, gchar const* key, gco
 
 	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
 	rocksdb_writebatch_put(batch->batch, nskey, strlen(nskey) + 1, value, len);
+	batch->pending = TRUE;
 
 	return TRUE;
 }
@@ -134,6 +322,7 @@ backend_delete(gpointer backend_data, gpointer backend_batch, gchar const* key)
 
 	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
 	rocksdb_writebatch_delete(batch->batch, nskey, strlen(nskey) + 1);
+	batch->pending = TRUE;
 
 	return TRUE;
 }
@@ -164,6 +353,245 @@ backend_get(gpointer backend_data, gpointer backend_batch, gchar const* key, gpo
 	return (result != NULL);
 }
 
+static gboolean
+backend_get_borrowed(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer* value, guint32* len)
+{
+	JRocksDBBatch* batch = backend_batch;
+	JRocksDBData* bd = backend_data;
+	g_autofree gchar* nskey = NULL;
+	rocksdb_pinnableslice_t* result;
+	gsize result_len;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(len != NULL, FALSE);
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	// Pinned values reference the block cache or memtable directly instead of being copied
+	result = rocksdb_get_pinned(bd->db, bd->read_options, nskey, strlen(nskey) + 1, NULL);
+
+	if (result == NULL)
+	{
+		return FALSE;
+	}
+
+	if (batch->values == NULL)
+	{
+		batch->values = g_ptr_array_new_with_free_func(rocksdb_value_free);
+	}
+
+	g_ptr_array_add(batch->values, result);
+
+	*value = rocksdb_pinnableslice_value(result, &result_len);
+	*len = result_len;
+
+	return TRUE;
+}
+
+static gboolean
+backend_get_multi(gpointer backend_data, gpointer backend_batch, gchar const* const* keys, guint32 count, gconstpointer* values, guint32* lens)
+{
+	JRocksDBBatch* batch = backend_batch;
+	JRocksDBData* bd = backend_data;
+	g_autofree gchar** nskeys = NULL;
+	g_autofree gsize* nskey_lens = NULL;
+	g_autofree gchar** results = NULL;
+	g_autofree gsize* result_lens = NULL;
+	g_autofree gchar** errors = NULL;
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(keys != NULL, FALSE);
+	g_return_val_if_fail(values != NULL, FALSE);
+	g_return_val_if_fail(lens != NULL, FALSE);
+
+	nskeys = g_new(gchar*, count);
+	nskey_lens = g_new(gsize, count);
+	results = g_new0(gchar*, count);
+	result_lens = g_new0(gsize, count);
+	errors = g_new0(gchar*, count);
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		nskeys[i] = g_strdup_printf("%s:%s", batch->namespace, keys[i]);
+		nskey_lens[i] = strlen(nskeys[i]) + 1;
+	}
+
+	// MultiGet sorts the keys itself, looks up blocks only once and reads them in parallel where possible
+	rocksdb_multi_get(bd->db, bd->read_options, count, (gchar const* const*)nskeys, nskey_lens, results, result_lens, errors);
+
+	if (batch->buffers == NULL)
+	{
+		batch->buffers = g_ptr_array_new_with_free_func(rocksdb_buffer_free);
+	}
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		g_free(nskeys[i]);
+
+		if (errors[i] != NULL)
+		{
+			rocksdb_free(errors[i]);
+			ret = FALSE;
+		}
+
+		values[i] = results[i];
+		lens[i] = result_lens[i];
+
+		if (results[i] != NULL)
+		{
+			g_ptr_array_add(batch->buffers, results[i]);
+		}
+	}
+
+	return ret;
+}
+
+static gboolean
+backend_compare_and_swap(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer expected, guint32 expected_len, gconstpointer value, guint32 len, gboolean* swapped)
+{
+	JRocksDBBatch* batch = backend_batch;
+	JRocksDBData* bd = backend_data;
+	g_autofree gchar* nskey = NULL;
+	g_autofree gchar* current = NULL;
+	g_autofree gchar* rocksdb_error = NULL;
+	gsize current_len = 0;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(swapped != NULL, FALSE);
+
+	*swapped = FALSE;
+
+	if (!rocksdb_batch_lock(bd, batch))
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	current = rocksdb_get(bd->db, bd->read_options, nskey, strlen(nskey) + 1, &current_len, &rocksdb_error);
+
+	if (rocksdb_error != NULL)
+	{
+		return FALSE;
+	}
+
+	if (expected == NULL)
+	{
+		*swapped = (current == NULL);
+	}
+	else
+	{
+		*swapped = (current != NULL && current_len == expected_len && memcmp(current, expected, expected_len) == 0);
+	}
+
+	if (*swapped)
+	{
+		rocksdb_writebatch_put(batch->batch, nskey, strlen(nskey) + 1, value, len);
+		batch->pending = TRUE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+backend_add(gpointer backend_data, gpointer backend_batch, gchar const* key, gint64 delta, gint64* result)
+{
+	JRocksDBBatch* batch = backend_batch;
+	JRocksDBData* bd = backend_data;
+	g_autofree gchar* nskey = NULL;
+	g_autofree gchar* current = NULL;
+	g_autofree gchar* rocksdb_error = NULL;
+	gsize current_len = 0;
+	gint64 number = 0;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+
+	if (!rocksdb_batch_lock(bd, batch))
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	current = rocksdb_get(bd->db, bd->read_options, nskey, strlen(nskey) + 1, &current_len, &rocksdb_error);
+
+	if (rocksdb_error != NULL)
+	{
+		return FALSE;
+	}
+
+	if (current != NULL)
+	{
+		if (current_len != sizeof(number))
+		{
+			return FALSE;
+		}
+
+		memcpy(&number, current, sizeof(number));
+	}
+
+	number += delta;
+
+	rocksdb_writebatch_put(batch->batch, nskey, strlen(nskey) + 1, (gchar const*)&number, sizeof(number));
+	batch->pending = TRUE;
+
+	*result = number;
+
+	return TRUE;
+}
+
+static gboolean
+backend_append(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer value, guint32 len)
+{
+	JRocksDBBatch* batch = backend_batch;
+	JRocksDBData* bd = backend_data;
+	g_autofree gchar* nskey = NULL;
+	g_autofree gchar* current = NULL;
+	g_autofree gchar* new_value = NULL;
+	g_autofree gchar* rocksdb_error = NULL;
+	gsize current_len = 0;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+
+	if (!rocksdb_batch_lock(bd, batch))
+	{
+		return FALSE;
+	}
+
+	nskey = g_strdup_printf("%s:%s", batch->namespace, key);
+	current = rocksdb_get(bd->db, bd->read_options, nskey, strlen(nskey) + 1, &current_len, &rocksdb_error);
+
+	if (rocksdb_error != NULL)
+	{
+		return FALSE;
+	}
+
+	if (current == NULL)
+	{
+		current_len = 0;
+	}
+
+	new_value = g_malloc(current_len + len);
+
+	if (current_len > 0)
+	{
+		memcpy(new_value, current, current_len);
+	}
+
+	memcpy(new_value + current_len, value, len);
+
+	rocksdb_writebatch_put(batch->batch, nskey, strlen(nskey) + 1, new_value, current_len + len);
+	batch->pending = TRUE;
+
+	return TRUE;
+}
+
 static gboolean
 backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend_iterator)
 {
@@ -174,7 +602,7 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend
 	g_return_val_if_fail(namespace != NULL, FALSE);
 	g_return_val_if_fail(backend_iterator != NULL, FALSE);
 
-	it = rocksdb_create_iterator(bd->db, bd->read_options);
+	it = rocksdb_create_iterator(bd->db, bd->prefix_read_options);
 
 	if (it != NULL)
 	{
@@ -183,6 +611,11 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend
 		iterator->first = TRUE;
 		iterator->prefix = g_strdup_printf("%s:", namespace);
 		iterator->namespace_len = strlen(namespace) + 1;
+		iterator->start = NULL;
+		iterator->end = NULL;
+		iterator->reverse = FALSE;
+		iterator->limit = 0;
+		iterator->count = 0;
 
 		*backend_iterator = iterator;
 	}
@@ -201,7 +634,7 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	g_return_val_if_fail(prefix != NULL, FALSE);
 	g_return_val_if_fail(backend_iterator != NULL, FALSE);
 
-	it = rocksdb_create_iterator(bd->db, bd->read_options);
+	it = rocksdb_create_iterator(bd->db, bd->prefix_read_options);
 
 	if (it != NULL)
 	{
@@ -210,6 +643,11 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 		iterator->first = TRUE;
 		iterator->prefix = g_strdup_printf("%s:%s", namespace, prefix);
 		iterator->namespace_len = strlen(namespace) + 1;
+		iterator->start = NULL;
+		iterator->end = NULL;
+		iterator->reverse = FALSE;
+		iterator->limit = 0;
+		iterator->count = 0;
 
 		*backend_iterator = iterator;
 	}
@@ -217,6 +655,52 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	return (iterator != NULL);
 }
 
+static gboolean
+backend_get_range(gpointer backend_data, gchar const* namespace, gchar const* start, gchar const* end, guint32 limit, gboolean reverse, gpointer* backend_iterator)
+{
+	JRocksDBData* bd = backend_data;
+	JRocksDBIterator* iterator = NULL;
+	rocksdb_iterator_t* it;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(backend_iterator != NULL, FALSE);
+
+	// Reverse iterators seek past the end of the namespace and have to ignore the prefix extractor
+	it = rocksdb_create_iterator(bd->db, (reverse) ? bd->read_options : bd->prefix_read_options);
+
+	if (it != NULL)
+	{
+		iterator = g_slice_new(JRocksDBIterator);
+		iterator->iterator = it;
+		iterator->first = TRUE;
+		iterator->prefix = g_strdup_printf("%s:", namespace);
+		iterator->namespace_len = strlen(namespace) + 1;
+		iterator->start = (start != NULL) ? g_strdup_printf("%s:%s", namespace, start) : NULL;
+		iterator->end = (end != NULL) ? g_strdup_printf("%s:%s", namespace, end) : NULL;
+		iterator->reverse = reverse;
+		iterator->limit = limit;
+		iterator->count = 0;
+
+		*backend_iterator = iterator;
+	}
+
+	return (iterator != NULL);
+}
+
+static void
+backend_iterator_free(gpointer backend_data, gpointer backend_iterator)
+{
+	JRocksDBIterator* iterator = backend_iterator;
+
+	(void)backend_data;
+
+	g_free(iterator->prefix);
+	g_free(iterator->start);
+	g_free(iterator->end);
+	rocksdb_iter_destroy(iterator->iterator);
+	g_slice_free(JRocksDBIterator, iterator);
+}
+
 static gboolean
 backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const** key, gconstpointer* value, guint32* len)
 {
@@ -228,11 +712,52 @@ backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const**
 	g_return_val_if_fail(value != NULL, FALSE);
 	g_return_val_if_fail(len != NULL, FALSE);
 
+	if (iterator->limit > 0 && iterator->count >= iterator->limit)
+	{
+		goto out;
+	}
+
 	if (iterator->first)
 	{
-		rocksdb_iter_seek(iterator->iterator, iterator->prefix, strlen(iterator->prefix));
+		if (!iterator->reverse)
+		{
+			gchar const* seek;
+
+			seek = (iterator->start != NULL) ? iterator->start : iterator->prefix;
+			rocksdb_iter_seek(iterator->iterator, seek, strlen(seek));
+		}
+		else
+		{
+			g_autofree gchar* upper = NULL;
+			gchar const* seek = iterator->end;
+
+			if (seek == NULL)
+			{
+				// The first key after the namespace
+				upper = g_strdup(iterator->prefix);
+				upper[iterator->namespace_len - 1]++;
+				seek = upper;
+			}
+
+			// Position on the first key not in the range and go back one key
+			rocksdb_iter_seek(iterator->iterator, seek, strlen(seek));
+
+			if (rocksdb_iter_valid(iterator->iterator))
+			{
+				rocksdb_iter_prev(iterator->iterator);
+			}
+			else
+			{
+				rocksdb_iter_seek_to_last(iterator->iterator);
+			}
+		}
+
 		iterator->first = FALSE;
 	}
+	else if (iterator->reverse)
+	{
+		rocksdb_iter_prev(iterator->iterator);
+	}
 	else
 	{
 		rocksdb_iter_next(iterator->iterator);
@@ -250,6 +775,13 @@ backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const**
 			goto out;
 		}
 
+		if ((iterator->end != NULL && strcmp(key_, iterator->end) >= 0) || (iterator->start != NULL && strcmp(key_, iterator->start) < 0))
+		{
+			goto out;
+		}
+
+		iterator->count++;
+
 		*key = key_ + iterator->namespace_len;
 		*value = rocksdb_iter_value(iterator->iterator, &tmp);
 		*len = tmp;
@@ -258,9 +790,7 @@ backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const**
 	}
 
 out:
-	g_free(iterator->prefix);
-	rocksdb_iter_destroy(iterator->iterator);
-	g_slice_free(JRocksDBIterator, iterator);
+	backend_iterator_free(backend_data, iterator);
 
 	return FALSE;
 }
@@ -270,29 +800,69 @@ backend_init(gchar const* path, gpointer* backend_data)
 {
 	JRocksDBData* bd;
 	rocksdb_options_t* options;
+	rocksdb_block_based_table_options_t* table_options;
+	g_autoptr(GHashTable) path_options = NULL;
+	g_autofree gchar* db_path = NULL;
 	g_autofree gchar* dirname = NULL;
+	guint64 block_cache;
+	guint64 bloom_filter;
+	guint64 write_buffer;
 	gint const compressions[] = { rocksdb_lz4_compression, rocksdb_snappy_compression, rocksdb_no_compression };
 
 	g_return_val_if_fail(path != NULL, FALSE);
 
-	dirname = g_path_get_dirname(path);
+	db_path = j_backend_path_parse(path, &path_options);
+	block_cache = rocksdb_option_get(path_options, "block-cache", 0);
+	bloom_filter = rocksdb_option_get(path_options, "bloom-filter", 10);
+	write_buffer = rocksdb_option_get(path_options, "write-buffer", 0);
+
+	dirname = g_path_get_dirname(db_path);
 	g_mkdir_with_parents(dirname, 0700);
 
 	bd = g_slice_new(JRocksDBData);
 	bd->read_options = rocksdb_readoptions_create();
+	// Iterators that might leave their namespace have to see all keys in order
+	rocksdb_readoptions_set_total_order_seek(bd->read_options, 1);
+	bd->prefix_read_options = rocksdb_readoptions_create();
+	// Allows skipping files that do not contain the namespace using the prefix bloom filters
+	rocksdb_readoptions_set_prefix_same_as_start(bd->prefix_read_options, 1);
 	bd->write_options = rocksdb_writeoptions_create();
 	bd->write_options_sync = rocksdb_writeoptions_create();
 	rocksdb_writeoptions_set_sync(bd->write_options_sync, 1);
+	bd->cache = NULL;
+	g_mutex_init(&(bd->lock));
 
 	options = rocksdb_options_create();
 	rocksdb_options_set_create_if_missing(options, 1);
+	rocksdb_options_set_prefix_extractor(options, rocksdb_slicetransform_create(NULL, rocksdb_namespace_destroy, rocksdb_namespace_transform, rocksdb_namespace_in_domain, rocksdb_namespace_in_range, rocksdb_namespace_name));
+
+	if (write_buffer > 0)
+	{
+		rocksdb_options_set_write_buffer_size(options, write_buffer);
+	}
+
+	table_options = rocksdb_block_based_options_create();
+
+	if (block_cache > 0)
+	{
+		bd->cache = rocksdb_cache_create_lru(block_cache);
+		rocksdb_block_based_options_set_block_cache(table_options, bd->cache);
+	}
+
+	if (bloom_filter > 0)
+	{
+		// Whole keys are added to the filters as well, so point lookups only read files that might contain the key
+		rocksdb_block_based_options_set_filter_policy(table_options, rocksdb_filterpolicy_create_bloom(bloom_filter));
+	}
+
+	rocksdb_options_set_block_based_table_factory(options, table_options);
 
 	for (guint i = 0; i < G_N_ELEMENTS(compressions); i++)
 	{
 		g_autofree gchar* error = NULL;
 
 		rocksdb_options_set_compression(options, compressions[i]);
-		bd->db = rocksdb_open(options, path, &error);
+		bd->db = rocksdb_open(options, db_path, &error);
 
 		if (bd->db != NULL)
 		{
@@ -300,6 +870,7 @@ backend_init(gchar const* path, gpointer* backend_data)
 		}
 	}
 
+	rocksdb_block_based_options_destroy(table_options);
 	rocksdb_options_destroy(options);
 
 	*backend_data = bd;
@@ -313,14 +884,21 @@ backend_fini(gpointer backend_data)
 	JRocksDBData* bd = backend_data;
 
 	rocksdb_readoptions_destroy(bd->read_options);
+	rocksdb_readoptions_destroy(bd->prefix_read_options);
 	rocksdb_writeoptions_destroy(bd->write_options);
 	rocksdb_writeoptions_destroy(bd->write_options_sync);
+	g_mutex_clear(&(bd->lock));
 
 	if (bd->db != NULL)
 	{
 		rocksdb_close(bd->db);
 	}
 
+	if (bd->cache != NULL)
+	{
+		rocksdb_cache_destroy(bd->cache);
+	}
+
 	g_slice_free(JRocksDBData, bd);
 }
 
@@ -335,9 +913,16 @@ static JBackend rocksdb_backend = {
 		.backend_put = backend_put,
 		.backend_delete = backend_delete,
 		.backend_get = backend_get,
+		.backend_get_borrowed = backend_get_borrowed,
+		.backend_get_multi = backend_get_multi,
+		.backend_compare_and_swap = backend_compare_and_swap,
+		.backend_add = backend_add,
+		.backend_append = backend_append,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_get_range = backend_get_range,
+		.backend_iterate = backend_iterate,
+		.backend_iterator_free = backend_iterator_free }
 };
 
 G_MODULE_EXPORT
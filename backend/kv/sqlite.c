@@ -166,6 +166,96 @@ backend_get(gpointer backend_data, gpointer backend_batch, gchar const* key, gpo
 	return (result != NULL);
 }
 
+static gboolean
+backend_compare_and_swap(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer expected, guint32 expected_len, gconstpointer value, guint32 len, gboolean* swapped)
+{
+	g_autofree gpointer current = NULL;
+	guint32 current_len = 0;
+	gboolean exists;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(swapped != NULL, FALSE);
+
+	// The batch's transaction makes reading and writing atomic
+	exists = backend_get(backend_data, backend_batch, key, &current, &current_len);
+
+	if (expected == NULL)
+	{
+		*swapped = !exists;
+	}
+	else
+	{
+		*swapped = (exists && current_len == expected_len && memcmp(current, expected, expected_len) == 0);
+	}
+
+	if (!*swapped)
+	{
+		return TRUE;
+	}
+
+	return backend_put(backend_data, backend_batch, key, value, len);
+}
+
+static gboolean
+backend_add(gpointer backend_data, gpointer backend_batch, gchar const* key, gint64 delta, gint64* result)
+{
+	g_autofree gpointer current = NULL;
+	guint32 current_len = 0;
+	gint64 number = 0;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+
+	if (backend_get(backend_data, backend_batch, key, &current, &current_len))
+	{
+		if (current_len != sizeof(number))
+		{
+			return FALSE;
+		}
+
+		memcpy(&number, current, sizeof(number));
+	}
+
+	number += delta;
+
+	if (!backend_put(backend_data, backend_batch, key, &number, sizeof(number)))
+	{
+		return FALSE;
+	}
+
+	*result = number;
+
+	return TRUE;
+}
+
+static gboolean
+backend_append(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer value, guint32 len)
+{
+	g_autofree gpointer current = NULL;
+	g_autofree gchar* new_value = NULL;
+	guint32 current_len = 0;
+
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+
+	backend_get(backend_data, backend_batch, key, &current, &current_len);
+
+	new_value = g_malloc(current_len + len);
+
+	if (current_len > 0)
+	{
+		memcpy(new_value, current, current_len);
+	}
+
+	memcpy(new_value + current_len, value, len);
+
+	return backend_put(backend_data, backend_batch, key, new_value, current_len + len);
+}
+
 static gboolean
 backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend_iterator)
 {
@@ -175,9 +265,10 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend
 	g_return_val_if_fail(namespace != NULL, FALSE);
 	g_return_val_if_fail(backend_iterator != NULL, FALSE);
 
-	if (sqlite3_prepare_v2(bd->db, "SELECT key, value FROM julea WHERE namespace = ?;", -1, &stmt, NULL) == SQLITE_OK)
+	if (sqlite3_prepare_v2(bd->db, "SELECT key, value FROM julea WHERE namespace = ? ORDER BY key;", -1, &stmt, NULL) == SQLITE_OK)
 	{
-		sqlite3_bind_text(stmt, 1, namespace, -1, NULL);
+		// Iterators can outlive the message containing the namespace
+		sqlite3_bind_text(stmt, 1, namespace, -1, SQLITE_TRANSIENT);
 	}
 
 	*backend_iterator = stmt;
@@ -195,10 +286,67 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	g_return_val_if_fail(prefix != NULL, FALSE);
 	g_return_val_if_fail(backend_iterator != NULL, FALSE);
 
-	if (sqlite3_prepare_v2(bd->db, "SELECT key, value FROM julea WHERE namespace = ? AND key LIKE ? || '%';", -1, &stmt, NULL) == SQLITE_OK)
+	if (sqlite3_prepare_v2(bd->db, "SELECT key, value FROM julea WHERE namespace = ? AND key LIKE ? || '%' ORDER BY key;", -1, &stmt, NULL) == SQLITE_OK)
+	{
+		sqlite3_bind_text(stmt, 1, namespace, -1, SQLITE_TRANSIENT);
+		sqlite3_bind_text(stmt, 2, prefix, -1, SQLITE_TRANSIENT);
+	}
+
+	*backend_iterator = stmt;
+
+	return (stmt != NULL);
+}
+
+static gboolean
+backend_get_range(gpointer backend_data, gchar const* namespace, gchar const* start, gchar const* end, guint32 limit, gboolean reverse, gpointer* backend_iterator)
+{
+	JSQLiteData* bd = backend_data;
+	sqlite3_stmt* stmt = NULL;
+	g_autoptr(GString) sql = NULL;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(backend_iterator != NULL, FALSE);
+
+	// Only add the conditions that are needed, so that the index on (namespace, key) can be used
+	sql = g_string_new("SELECT key, value FROM julea WHERE namespace = ?1");
+
+	if (start != NULL)
+	{
+		g_string_append(sql, " AND key >= ?2");
+	}
+
+	if (end != NULL)
+	{
+		g_string_append(sql, " AND key < ?3");
+	}
+
+	g_string_append(sql, (reverse) ? " ORDER BY key DESC" : " ORDER BY key");
+
+	if (limit > 0)
+	{
+		g_string_append(sql, " LIMIT ?4");
+	}
+
+	g_string_append(sql, ";");
+
+	if (sqlite3_prepare_v2(bd->db, sql->str, -1, &stmt, NULL) == SQLITE_OK)
 	{
-		sqlite3_bind_text(stmt, 1, namespace, -1, NULL);
-		sqlite3_bind_text(stmt, 2, prefix, -1, NULL);
+		sqlite3_bind_text(stmt, 1, namespace, -1, SQLITE_TRANSIENT);
+
+		if (start != NULL)
+		{
+			sqlite3_bind_text(stmt, 2, start, -1, SQLITE_TRANSIENT);
+		}
+
+		if (end != NULL)
+		{
+			sqlite3_bind_text(stmt, 3, end, -1, SQLITE_TRANSIENT);
+		}
+
+		if (limit > 0)
+		{
+			sqlite3_bind_int64(stmt, 4, limit);
+		}
 	}
 
 	*backend_iterator = stmt;
@@ -206,6 +354,16 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	return (stmt != NULL);
 }
 
+static void
+backend_iterator_free(gpointer backend_data, gpointer backend_iterator)
+{
+	sqlite3_stmt* stmt = backend_iterator;
+
+	(void)backend_data;
+
+	sqlite3_finalize(stmt);
+}
+
 static gboolean
 backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const** key, gconstpointer* value, guint32* len)
 {
@@ -294,9 +452,14 @@ static JBackend sqlite_backend = {
 		.backend_put = backend_put,
 		.backend_delete = backend_delete,
 		.backend_get = backend_get,
+		.backend_compare_and_swap = backend_compare_and_swap,
+		.backend_add = backend_add,
+		.backend_append = backend_append,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_get_range = backend_get_range,
+		.backend_iterate = backend_iterate,
+		.backend_iterator_free = backend_iterator_free }
 };
 
 G_MODULE_EXPORT
@@ -273,6 +273,16 @@ backend_write(gpointer backend_data, gpointer backend_object, gconstpointer buff
 	return ret;
 }
 
+static gboolean
+backend_truncate(gpointer backend_data, gpointer backend_object, guint64 size)
+{
+	JBackendObject* bo = backend_object;
+
+	(void)backend_data;
+
+	return g_seekable_truncate(G_SEEKABLE(bo->stream), size, NULL, NULL);
+}
+
 static gboolean
 backend_init(gchar const* path, gpointer* backend_data)
 {
@@ -313,7 +323,8 @@ static JBackend gio_backend = {
 		.backend_status = backend_status,
 		.backend_sync = backend_sync,
 		.backend_read = backend_read,
-		.backend_write = backend_write }
+		.backend_write = backend_write,
+		.backend_truncate = backend_truncate }
 };
 
 G_MODULE_EXPORT
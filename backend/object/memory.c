@@ -0,0 +1,653 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+#include <gmodule.h>
+
+#include <string.h>
+
+#include <julea.h>
+
+/**
+ * Size of the chunks objects are made of.
+ */
+#define JD_MEMORY_CHUNK_SIZE (64 * 1024)
+
+/**
+ * Number of chunks allocated at once by the arena.
+ */
+#define JD_MEMORY_SLAB_CHUNKS 16
+
+#define JD_MEMORY_SHARDS 16
+#define JD_MEMORY_LOCKS 64
+
+/**
+ * An arena that hands out fixed-size chunks.
+ * Chunks are allocated in slabs and are recycled instead of being freed.
+ */
+struct JMemoryArena
+{
+	GMutex mutex;
+
+	/**
+	 * All allocated slabs.
+	 */
+	GPtrArray* slabs;
+
+	/**
+	 * The free chunks.
+	 */
+	GPtrArray* free_chunks;
+};
+
+typedef struct JMemoryArena JMemoryArena;
+
+struct JMemoryShard
+{
+	GMutex mutex;
+
+	/**
+	 * The objects, indexed by namespace and path.
+	 */
+	GHashTable* objects;
+};
+
+typedef struct JMemoryShard JMemoryShard;
+
+struct JMemoryData
+{
+	JMemoryArena arena;
+
+	JMemoryShard shards[JD_MEMORY_SHARDS];
+
+	/**
+	 * Locks protecting the objects' data.
+	 * Objects are mapped onto the locks based on their hash.
+	 */
+	GRWLock locks[JD_MEMORY_LOCKS];
+};
+
+typedef struct JMemoryData JMemoryData;
+
+struct JMemoryObject
+{
+	gchar* path;
+
+	/**
+	 * The object's data lock.
+	 */
+	GRWLock* lock;
+
+	/**
+	 * The object's chunks, NULL for holes.
+	 */
+	GPtrArray* chunks;
+
+	guint64 size;
+	gint64 modification_time;
+
+	gint ref_count;
+};
+
+typedef struct JMemoryObject JMemoryObject;
+
+static gpointer
+backend_arena_alloc(JMemoryArena* arena)
+{
+	gpointer chunk;
+
+	g_mutex_lock(&(arena->mutex));
+
+	if (arena->free_chunks->len == 0)
+	{
+		gchar* slab;
+
+		slab = g_malloc(JD_MEMORY_SLAB_CHUNKS * JD_MEMORY_CHUNK_SIZE);
+		g_ptr_array_add(arena->slabs, slab);
+
+		for (guint i = 0; i < JD_MEMORY_SLAB_CHUNKS; i++)
+		{
+			g_ptr_array_add(arena->free_chunks, slab + i * JD_MEMORY_CHUNK_SIZE);
+		}
+	}
+
+	chunk = g_ptr_array_remove_index_fast(arena->free_chunks, arena->free_chunks->len - 1);
+
+	g_mutex_unlock(&(arena->mutex));
+
+	// Chunks might be written partially, the rest has to read as zeros
+	memset(chunk, 0, JD_MEMORY_CHUNK_SIZE);
+
+	return chunk;
+}
+
+static void
+backend_arena_free(JMemoryArena* arena, gpointer chunk)
+{
+	g_mutex_lock(&(arena->mutex));
+	g_ptr_array_add(arena->free_chunks, chunk);
+	g_mutex_unlock(&(arena->mutex));
+}
+
+static JMemoryShard*
+backend_get_shard(JMemoryData* bd, gchar const* path)
+{
+	return &(bd->shards[g_str_hash(path) % JD_MEMORY_SHARDS]);
+}
+
+static void
+backend_object_unref(JMemoryData* bd, JMemoryObject* bo)
+{
+	if (g_atomic_int_dec_and_test(&(bo->ref_count)))
+	{
+		for (guint i = 0; i < bo->chunks->len; i++)
+		{
+			gpointer chunk = g_ptr_array_index(bo->chunks, i);
+
+			if (chunk != NULL)
+			{
+				backend_arena_free(&(bd->arena), chunk);
+			}
+		}
+
+		g_ptr_array_unref(bo->chunks);
+		g_free(bo->path);
+		g_slice_free(JMemoryObject, bo);
+	}
+}
+
+static gboolean
+backend_create(gpointer backend_data, gchar const* namespace, gchar const* path, gpointer* backend_object)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryShard* shard;
+	JMemoryObject* bo;
+	gchar* full_path;
+
+	full_path = g_build_filename(namespace, path, NULL);
+	shard = backend_get_shard(bd, full_path);
+
+	j_trace_file_begin(full_path, J_TRACE_FILE_CREATE);
+
+	g_mutex_lock(&(shard->mutex));
+
+	if ((bo = g_hash_table_lookup(shard->objects, full_path)) == NULL)
+	{
+		bo = g_slice_new(JMemoryObject);
+		bo->path = full_path;
+		bo->lock = &(bd->locks[g_str_hash(full_path) % JD_MEMORY_LOCKS]);
+		bo->chunks = g_ptr_array_new();
+		bo->size = 0;
+		bo->modification_time = g_get_real_time();
+		// One reference for the hash table
+		bo->ref_count = 1;
+
+		g_hash_table_insert(shard->objects, bo->path, bo);
+	}
+	else
+	{
+		g_free(full_path);
+	}
+
+	g_atomic_int_inc(&(bo->ref_count));
+
+	g_mutex_unlock(&(shard->mutex));
+
+	j_trace_file_end(bo->path, J_TRACE_FILE_CREATE, 0, 0);
+
+	*backend_object = bo;
+
+	return TRUE;
+}
+
+static gboolean
+backend_open(gpointer backend_data, gchar const* namespace, gchar const* path, gpointer* backend_object)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryShard* shard;
+	JMemoryObject* bo;
+	g_autofree gchar* full_path = NULL;
+
+	full_path = g_build_filename(namespace, path, NULL);
+	shard = backend_get_shard(bd, full_path);
+
+	j_trace_file_begin(full_path, J_TRACE_FILE_OPEN);
+
+	g_mutex_lock(&(shard->mutex));
+
+	if ((bo = g_hash_table_lookup(shard->objects, full_path)) != NULL)
+	{
+		g_atomic_int_inc(&(bo->ref_count));
+	}
+
+	g_mutex_unlock(&(shard->mutex));
+
+	j_trace_file_end(full_path, J_TRACE_FILE_OPEN, 0, 0);
+
+	*backend_object = bo;
+
+	return (bo != NULL);
+}
+
+static gboolean
+backend_delete(gpointer backend_data, gpointer backend_object)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryObject* bo = backend_object;
+	JMemoryShard* shard;
+	gboolean ret;
+
+	shard = backend_get_shard(bd, bo->path);
+
+	j_trace_file_begin(bo->path, J_TRACE_FILE_DELETE);
+
+	g_mutex_lock(&(shard->mutex));
+	ret = (g_hash_table_lookup(shard->objects, bo->path) == bo);
+
+	if (ret)
+	{
+		g_hash_table_remove(shard->objects, bo->path);
+	}
+
+	g_mutex_unlock(&(shard->mutex));
+
+	j_trace_file_end(bo->path, J_TRACE_FILE_DELETE, 0, 0);
+
+	// Drop the hash table's reference
+	if (ret)
+	{
+		backend_object_unref(bd, bo);
+	}
+
+	backend_object_unref(bd, bo);
+
+	return ret;
+}
+
+static gboolean
+backend_close(gpointer backend_data, gpointer backend_object)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryObject* bo = backend_object;
+
+	j_trace_file_begin(bo->path, J_TRACE_FILE_CLOSE);
+	j_trace_file_end(bo->path, J_TRACE_FILE_CLOSE, 0, 0);
+
+	backend_object_unref(bd, bo);
+
+	return TRUE;
+}
+
+static gboolean
+backend_status(gpointer backend_data, gpointer backend_object, gint64* modification_time, guint64* size)
+{
+	JMemoryObject* bo = backend_object;
+
+	(void)backend_data;
+
+	j_trace_file_begin(bo->path, J_TRACE_FILE_STATUS);
+
+	g_rw_lock_reader_lock(bo->lock);
+
+	if (modification_time != NULL)
+	{
+		*modification_time = bo->modification_time;
+	}
+
+	if (size != NULL)
+	{
+		*size = bo->size;
+	}
+
+	g_rw_lock_reader_unlock(bo->lock);
+
+	j_trace_file_end(bo->path, J_TRACE_FILE_STATUS, 0, 0);
+
+	return TRUE;
+}
+
+static gboolean
+backend_sync(gpointer backend_data, gpointer backend_object)
+{
+	JMemoryObject* bo = backend_object;
+
+	(void)backend_data;
+
+	// There is nothing to sync
+	j_trace_file_begin(bo->path, J_TRACE_FILE_SYNC);
+	j_trace_file_end(bo->path, J_TRACE_FILE_SYNC, 0, 0);
+
+	return TRUE;
+}
+
+static gboolean
+backend_read(gpointer backend_data, gpointer backend_object, gpointer buffer, guint64 length, guint64 offset, guint64* bytes_read)
+{
+	JMemoryObject* bo = backend_object;
+	gchar* data = buffer;
+	guint64 nbytes_total = 0;
+
+	(void)backend_data;
+
+	j_trace_file_begin(bo->path, J_TRACE_FILE_READ);
+
+	g_rw_lock_reader_lock(bo->lock);
+
+	if (offset < bo->size)
+	{
+		nbytes_total = MIN(length, bo->size - offset);
+	}
+
+	for (guint64 done = 0; done < nbytes_total;)
+	{
+		guint64 position = offset + done;
+		guint64 index = position / JD_MEMORY_CHUNK_SIZE;
+		guint64 chunk_offset = position % JD_MEMORY_CHUNK_SIZE;
+		guint64 nbytes = MIN(JD_MEMORY_CHUNK_SIZE - chunk_offset, nbytes_total - done);
+		gchar const* chunk = NULL;
+
+		if (index < bo->chunks->len)
+		{
+			chunk = g_ptr_array_index(bo->chunks, index);
+		}
+
+		if (chunk != NULL)
+		{
+			memcpy(data + done, chunk + chunk_offset, nbytes);
+		}
+		else
+		{
+			memset(data + done, 0, nbytes);
+		}
+
+		done += nbytes;
+	}
+
+	g_rw_lock_reader_unlock(bo->lock);
+
+	j_trace_file_end(bo->path, J_TRACE_FILE_READ, nbytes_total, offset);
+
+	if (bytes_read != NULL)
+	{
+		*bytes_read = nbytes_total;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+backend_write(gpointer backend_data, gpointer backend_object, gconstpointer buffer, guint64 length, guint64 offset, guint64* bytes_written)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryObject* bo = backend_object;
+	gchar const* data = buffer;
+
+	j_trace_file_begin(bo->path, J_TRACE_FILE_WRITE);
+
+	g_rw_lock_writer_lock(bo->lock);
+
+	if (length > 0 && (offset + length + JD_MEMORY_CHUNK_SIZE - 1) / JD_MEMORY_CHUNK_SIZE > bo->chunks->len)
+	{
+		g_ptr_array_set_size(bo->chunks, (offset + length + JD_MEMORY_CHUNK_SIZE - 1) / JD_MEMORY_CHUNK_SIZE);
+	}
+
+	for (guint64 done = 0; done < length;)
+	{
+		guint64 position = offset + done;
+		guint64 index = position / JD_MEMORY_CHUNK_SIZE;
+		guint64 chunk_offset = position % JD_MEMORY_CHUNK_SIZE;
+		guint64 nbytes = MIN(JD_MEMORY_CHUNK_SIZE - chunk_offset, length - done);
+		gchar* chunk;
+
+		if ((chunk = g_ptr_array_index(bo->chunks, index)) == NULL)
+		{
+			chunk = backend_arena_alloc(&(bd->arena));
+			g_ptr_array_index(bo->chunks, index) = chunk;
+		}
+
+		memcpy(chunk + chunk_offset, data + done, nbytes);
+
+		done += nbytes;
+	}
+
+	bo->size = MAX(bo->size, offset + length);
+	bo->modification_time = g_get_real_time();
+
+	g_rw_lock_writer_unlock(bo->lock);
+
+	j_trace_file_end(bo->path, J_TRACE_FILE_WRITE, length, offset);
+
+	if (bytes_written != NULL)
+	{
+		*bytes_written = length;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+backend_get_holes(gpointer backend_data, gpointer backend_object, guint64 length, guint64 offset, GArray* holes)
+{
+	JMemoryObject* bo = backend_object;
+	guint64 end = offset + length;
+	guint64 hole_start = 0;
+	gboolean in_hole = FALSE;
+
+	(void)backend_data;
+
+	g_rw_lock_reader_lock(bo->lock);
+
+	for (guint64 position = offset; position < end;)
+	{
+		guint64 index = position / JD_MEMORY_CHUNK_SIZE;
+		guint64 next = MIN((index + 1) * JD_MEMORY_CHUNK_SIZE, end);
+		gboolean is_hole;
+
+		is_hole = (index >= bo->chunks->len || g_ptr_array_index(bo->chunks, index) == NULL);
+
+		if (is_hole && !in_hole)
+		{
+			hole_start = position;
+			in_hole = TRUE;
+		}
+		else if (!is_hole && in_hole)
+		{
+			guint64 hole_length = position - hole_start;
+
+			g_array_append_val(holes, hole_start);
+			g_array_append_val(holes, hole_length);
+			in_hole = FALSE;
+		}
+
+		position = next;
+	}
+
+	if (in_hole)
+	{
+		guint64 hole_length = end - hole_start;
+
+		g_array_append_val(holes, hole_start);
+		g_array_append_val(holes, hole_length);
+	}
+
+	g_rw_lock_reader_unlock(bo->lock);
+
+	return TRUE;
+}
+
+static gboolean
+backend_copy(gpointer backend_data, gpointer backend_object, gpointer destination_object, guint64* bytes_copied)
+{
+	JMemoryData* bd = backend_data;
+	JMemoryObject* bo = backend_object;
+	JMemoryObject* destination = destination_object;
+	GRWLock* first;
+	GRWLock* second;
+
+	if (bo == destination)
+	{
+		*bytes_copied = bo->size;
+		return TRUE;
+	}
+
+	j_trace_file_begin(destination->path, J_TRACE_FILE_WRITE);
+
+	// Always lock in the same order to avoid deadlocks with concurrent copies
+	first = MIN(bo->lock, destination->lock);
+	second = MAX(bo->lock, destination->lock);
+
+	g_rw_lock_writer_lock(first);
+
+	if (second != first)
+	{
+		g_rw_lock_writer_lock(second);
+	}
+
+	for (guint i = 0; i < destination->chunks->len; i++)
+	{
+		gpointer chunk = g_ptr_array_index(destination->chunks, i);
+
+		if (chunk != NULL)
+		{
+			backend_arena_free(&(bd->arena), chunk);
+		}
+	}
+
+	g_ptr_array_set_size(destination->chunks, bo->chunks->len);
+
+	for (guint i = 0; i < bo->chunks->len; i++)
+	{
+		gchar const* chunk = g_ptr_array_index(bo->chunks, i);
+		gpointer copy = NULL;
+
+		// Holes stay holes
+		if (chunk != NULL)
+		{
+			copy = backend_arena_alloc(&(bd->arena));
+			memcpy(copy, chunk, JD_MEMORY_CHUNK_SIZE);
+		}
+
+		g_ptr_array_index(destination->chunks, i) = copy;
+	}
+
+	destination->size = bo->size;
+	destination->modification_time = g_get_real_time();
+	*bytes_copied = bo->size;
+
+	if (second != first)
+	{
+		g_rw_lock_writer_unlock(second);
+	}
+
+	g_rw_lock_writer_unlock(first);
+
+	j_trace_file_end(destination->path, J_TRACE_FILE_WRITE, *bytes_copied, 0);
+
+	return TRUE;
+}
+
+static gboolean
+backend_init(gchar const* path, gpointer* backend_data)
+{
+	JMemoryData* bd;
+
+	(void)path;
+
+	bd = g_slice_new(JMemoryData);
+
+	g_mutex_init(&(bd->arena.mutex));
+	bd->arena.slabs = g_ptr_array_new_with_free_func(g_free);
+	bd->arena.free_chunks = g_ptr_array_new();
+
+	for (guint i = 0; i < JD_MEMORY_SHARDS; i++)
+	{
+		g_mutex_init(&(bd->shards[i].mutex));
+		bd->shards[i].objects = g_hash_table_new(g_str_hash, g_str_equal);
+	}
+
+	for (guint i = 0; i < JD_MEMORY_LOCKS; i++)
+	{
+		g_rw_lock_init(&(bd->locks[i]));
+	}
+
+	*backend_data = bd;
+
+	return TRUE;
+}
+
+static void
+backend_fini(gpointer backend_data)
+{
+	JMemoryData* bd = backend_data;
+
+	for (guint i = 0; i < JD_MEMORY_SHARDS; i++)
+	{
+		GHashTableIter iter;
+		gpointer value;
+
+		g_hash_table_iter_init(&iter, bd->shards[i].objects);
+
+		while (g_hash_table_iter_next(&iter, NULL, &value))
+		{
+			g_hash_table_iter_steal(&iter);
+			backend_object_unref(bd, value);
+		}
+
+		g_hash_table_destroy(bd->shards[i].objects);
+		g_mutex_clear(&(bd->shards[i].mutex));
+	}
+
+	for (guint i = 0; i < JD_MEMORY_LOCKS; i++)
+	{
+		g_rw_lock_clear(&(bd->locks[i]));
+	}
+
+	g_ptr_array_unref(bd->arena.free_chunks);
+	// Frees all chunks at once
+	g_ptr_array_unref(bd->arena.slabs);
+	g_mutex_clear(&(bd->arena.mutex));
+
+	g_slice_free(JMemoryData, bd);
+}
+
+static JBackend memory_backend = {
+	.type = J_BACKEND_TYPE_OBJECT,
+	.component = J_BACKEND_COMPONENT_CLIENT | J_BACKEND_COMPONENT_SERVER,
+	.object = {
+		.backend_init = backend_init,
+		.backend_fini = backend_fini,
+		.backend_create = backend_create,
+		.backend_delete = backend_delete,
+		.backend_open = backend_open,
+		.backend_close = backend_close,
+		.backend_status = backend_status,
+		.backend_sync = backend_sync,
+		.backend_read = backend_read,
+		.backend_write = backend_write,
+		.backend_get_holes = backend_get_holes,
+		.backend_copy = backend_copy }
+};
+
+G_MODULE_EXPORT
+JBackend*
+backend_info(void)
+{
+	return &memory_backend;
+}
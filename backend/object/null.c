@@ -161,6 +161,16 @@ backend_write(gpointer backend_data, gpointer backend_object, gconstpointer buff
 	return TRUE;
 }
 
+static gboolean
+backend_truncate(gpointer backend_data, gpointer backend_object, guint64 size)
+{
+	(void)backend_data;
+	(void)backend_object;
+	(void)size;
+
+	return TRUE;
+}
+
 static gboolean
 backend_init(gchar const* path, gpointer* backend_data)
 {
@@ -189,7 +199,8 @@ static JBackend null_backend = {
 		.backend_status = backend_status,
 		.backend_sync = backend_sync,
 		.backend_read = backend_read,
-		.backend_write = backend_write }
+		.backend_write = backend_write,
+		.backend_truncate = backend_truncate }
 };
 
 G_MODULE_EXPORT
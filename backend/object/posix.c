@@ -16,23 +16,97 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+// Needed for SEEK_DATA and SEEK_HOLE
+#define _GNU_SOURCE
+
 #include <julea-config.h>
 
 #include <glib.h>
 #include <glib/gstdio.h>
 #include <gmodule.h>
 
+#include <errno.h>
 #include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#ifdef HAVE_FICLONE
+#include <linux/fs.h>
+#endif
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
 #include <julea.h>
 
+/**
+ * Number of shards the file cache is split into.
+ * Each shard has its own lock to reduce contention between server threads.
+ */
+#define JD_BACKEND_FILE_CACHE_SHARDS 16
+
+struct JBackendFileCacheShard
+{
+	GMutex mutex;
+
+	/**
+	 * The cached files, indexed by path.
+	 */
+	GHashTable* files;
+
+	/**
+	 * The idle (unreferenced) files, the most recently used file is at the head.
+	 */
+	GQueue lru;
+
+	/**
+	 * The number of open files in this shard.
+	 */
+	guint open_files;
+};
+
+typedef struct JBackendFileCacheShard JBackendFileCacheShard;
+
+/**
+ * How objects are placed within a namespace's directory.
+ */
+enum JBackendLayout
+{
+	/**
+	 * All objects are stored directly in the namespace's directory.
+	 */
+	J_BACKEND_LAYOUT_FLAT,
+
+	/**
+	 * Objects are stored in two levels of 256 subdirectories each, based on the hash of their name.
+	 * This keeps directories small for namespaces containing many objects.
+	 */
+	J_BACKEND_LAYOUT_HASHED
+};
+
+typedef enum JBackendLayout JBackendLayout;
+
 struct JBackendData
 {
 	gchar* path;
-	// FIXME check whether hash tables can stay global
+
+	JBackendLayout layout;
+
+	JBackendFileCacheShard shards[JD_BACKEND_FILE_CACHE_SHARDS];
+
+	/**
+	 * The maximum number of open files per shard.
+	 * Files that are in use are never closed, so this limit can be exceeded temporarily.
+	 */
+	guint max_open_files;
+
+	guint64 cache_hits;
+	guint64 cache_misses;
+	guint64 cache_evictions;
 };
 
 typedef struct JBackendData JBackendData;
@@ -41,200 +115,517 @@ struct JBackendObject
 {
 	gchar* path;
 	gint fd;
+
+	/**
+	 * The number of users, protected by the shard's lock.
+	 */
 	guint ref_count;
+
+	/**
+	 * The shard the file belongs to, NULL if the file could not be opened.
+	 */
+	JBackendFileCacheShard* shard;
+
+	/**
+	 * Whether the file is still contained in the shard's hash table.
+	 */
+	gboolean cached;
+
+	/**
+	 * The link within the shard's LRU list, only used while the file is idle.
+	 */
+	GList lru_link;
 };
 
 typedef struct JBackendObject JBackendObject;
 
-static guint jd_num_backends = 0;
+static JBackendObject*
+backend_file_new(gchar* path, gint fd)
+{
+	JBackendObject* bo;
 
-static GHashTable* jd_backend_file_cache = NULL;
+	bo = g_slice_new(JBackendObject);
+	bo->path = path;
+	bo->fd = fd;
+	bo->ref_count = 1;
+	bo->shard = NULL;
+	bo->cached = FALSE;
+	bo->lru_link.data = bo;
+	bo->lru_link.next = NULL;
+	bo->lru_link.prev = NULL;
 
-G_LOCK_DEFINE_STATIC(jd_backend_file_cache);
+	return bo;
+}
 
 static void
-jd_backend_files_free(gpointer data)
+backend_file_free(JBackendObject* bo)
+{
+	if (bo->fd != -1)
+	{
+		j_trace_file_begin(bo->path, J_TRACE_FILE_CLOSE);
+		close(bo->fd);
+		j_trace_file_end(bo->path, J_TRACE_FILE_CLOSE, 0, 0);
+	}
+
+	g_free(bo->path);
+	g_slice_free(JBackendObject, bo);
+}
+
+/**
+ * Returns the full path of an object according to the backend's layout.
+ *
+ * The hashed layout has to be kept in sync with the julea-posix-migrate tool.
+ **/
+static gchar*
+backend_build_path(JBackendData* bd, gchar const* namespace, gchar const* path)
 {
-	GHashTable* files = data;
+	if (bd->layout == J_BACKEND_LAYOUT_HASHED)
+	{
+		guint32 hash;
+		gchar level1[3];
+		gchar level2[3];
 
-	g_hash_table_destroy(files);
+		hash = j_helper_hash_fnv1a(path);
+
+		g_snprintf(level1, sizeof(level1), "%02x", (hash >> 24) & 0xff);
+		g_snprintf(level2, sizeof(level2), "%02x", (hash >> 16) & 0xff);
+
+		return g_build_filename(bd->path, namespace, level1, level2, path, NULL);
+	}
+
+	return g_build_filename(bd->path, namespace, path, NULL);
 }
 
-// FIXME not deleted?
-static GPrivate jd_backend_files = G_PRIVATE_INIT(jd_backend_files_free);
+static JBackendFileCacheShard*
+backend_file_get_shard(JBackendData* bd, gchar const* path)
+{
+	return &(bd->shards[g_str_hash(path) % JD_BACKEND_FILE_CACHE_SHARDS]);
+}
 
+/**
+ * Closes idle files until the shard is within its limit.
+ * Must be called with the shard's lock held.
+ **/
 static void
-backend_file_unref(gpointer data)
+backend_file_evict(JBackendData* bd, JBackendFileCacheShard* shard)
 {
-	JBackendObject* bo = data;
+	while (shard->open_files > bd->max_open_files && !g_queue_is_empty(&(shard->lru)))
+	{
+		GList* link;
+		JBackendObject* bo;
+
+		link = g_queue_pop_tail_link(&(shard->lru));
+		bo = link->data;
+
+		g_hash_table_remove(shard->files, bo->path);
+		shard->open_files--;
+
+		backend_file_free(bo);
+
+		j_helper_atomic_add(&(bd->cache_evictions), 1);
+	}
+}
 
-	g_return_if_fail(bo != NULL);
+/**
+ * Returns the cached file for the given path, opening it if necessary.
+ * Takes ownership of full_path.
+ *
+ * \return The file, NULL if it could not be opened.
+ **/
+static JBackendObject*
+backend_file_get(JBackendData* bd, gchar* full_path, gboolean create)
+{
+	JBackendFileCacheShard* shard;
+	JBackendObject* bo;
+	JBackendObject* existing;
+	gint fd;
+
+	shard = backend_file_get_shard(bd, full_path);
 
-	G_LOCK(jd_backend_file_cache);
+	g_mutex_lock(&(shard->mutex));
 
-	if (g_atomic_int_dec_and_test(&(bo->ref_count)))
+	if ((bo = g_hash_table_lookup(shard->files, full_path)) != NULL)
 	{
-		g_hash_table_remove(jd_backend_file_cache, bo->path);
+		if (bo->ref_count == 0)
+		{
+			g_queue_unlink(&(shard->lru), &(bo->lru_link));
+		}
 
-		j_trace_file_begin(bo->path, J_TRACE_FILE_CLOSE);
-		close(bo->fd);
-		j_trace_file_end(bo->path, J_TRACE_FILE_CLOSE, 0, 0);
+		bo->ref_count++;
+
+		g_mutex_unlock(&(shard->mutex));
+
+		j_helper_atomic_add(&(bd->cache_hits), 1);
+		g_free(full_path);
 
-		g_free(bo->path);
-		g_slice_free(JBackendObject, bo);
+		return bo;
 	}
 
-	G_UNLOCK(jd_backend_file_cache);
-}
+	g_mutex_unlock(&(shard->mutex));
 
-static GHashTable*
-jd_backend_files_get_thread(void)
-{
-	GHashTable* files;
+	j_helper_atomic_add(&(bd->cache_misses), 1);
+
+	// Open the file without holding the lock, opening and creating files might be slow
+	if (create)
+	{
+		g_autofree gchar* parent = NULL;
+
+		j_trace_file_begin(full_path, J_TRACE_FILE_CREATE);
 
-	files = g_private_get(&jd_backend_files);
+		parent = g_path_get_dirname(full_path);
+		g_mkdir_with_parents(parent, 0700);
 
-	if (G_UNLIKELY(files == NULL))
+		fd = open(full_path, O_RDWR | O_CREAT, 0600);
+
+		j_trace_file_end(full_path, J_TRACE_FILE_CREATE, 0, 0);
+	}
+	else
 	{
-		files = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, backend_file_unref);
-		g_private_replace(&jd_backend_files, files);
+		j_trace_file_begin(full_path, J_TRACE_FILE_OPEN);
+		fd = open(full_path, O_RDWR);
+		j_trace_file_end(full_path, J_TRACE_FILE_OPEN, 0, 0);
+	}
+
+	if (fd == -1)
+	{
+		g_free(full_path);
+		return NULL;
+	}
+
+	bo = backend_file_new(full_path, fd);
+
+	g_mutex_lock(&(shard->mutex));
+
+	// Another thread might have opened the same file in the meantime
+	if ((existing = g_hash_table_lookup(shard->files, full_path)) != NULL)
+	{
+		if (existing->ref_count == 0)
+		{
+			g_queue_unlink(&(shard->lru), &(existing->lru_link));
+		}
+
+		existing->ref_count++;
+
+		g_mutex_unlock(&(shard->mutex));
+
+		backend_file_free(bo);
+
+		return existing;
 	}
 
-	return files;
+	bo->shard = shard;
+	bo->cached = TRUE;
+
+	g_hash_table_insert(shard->files, bo->path, bo);
+	shard->open_files++;
+
+	backend_file_evict(bd, shard);
+
+	g_mutex_unlock(&(shard->mutex));
+
+	return bo;
 }
 
-static JBackendObject*
-backend_file_get(GHashTable* files, gchar const* key)
+/**
+ * Releases a file.
+ * If forget is TRUE, the file is removed from the cache and closed as soon as it is not used anymore.
+ **/
+static gboolean
+backend_file_release(JBackendData* bd, JBackendObject* bo, gboolean forget)
 {
-	JBackendObject* bo;
+	JBackendFileCacheShard* shard = bo->shard;
+	gboolean free_file = FALSE;
+
+	if (shard == NULL)
+	{
+		backend_file_free(bo);
+
+		return TRUE;
+	}
+
+	g_mutex_lock(&(shard->mutex));
 
-	if ((bo = g_hash_table_lookup(files, key)) != NULL)
+	if (forget && bo->cached)
 	{
-		goto end;
+		g_hash_table_remove(shard->files, bo->path);
+		bo->cached = FALSE;
 	}
 
-	G_LOCK(jd_backend_file_cache);
+	g_assert(bo->ref_count > 0);
 
-	if ((bo = g_hash_table_lookup(jd_backend_file_cache, key)) != NULL)
+	bo->ref_count--;
+
+	if (bo->ref_count == 0)
 	{
-		g_atomic_int_inc(&(bo->ref_count));
-		g_hash_table_insert(files, bo->path, bo);
-		G_UNLOCK(jd_backend_file_cache);
+		if (bo->cached)
+		{
+			g_queue_push_head_link(&(shard->lru), &(bo->lru_link));
+			backend_file_evict(bd, shard);
+		}
+		else
+		{
+			shard->open_files--;
+			free_file = TRUE;
+		}
 	}
 
-	/* Attention: The caller must call backend_file_add() if NULL is returned! */
+	g_mutex_unlock(&(shard->mutex));
 
-end:
-	return bo;
+	if (free_file)
+	{
+		backend_file_free(bo);
+	}
+
+	return TRUE;
 }
 
+#ifdef HAVE_LIBURING
+/**
+ * Number of submission queue entries per ring.
+ * Requests are split into at most this many segments per batch.
+ */
+#define JD_BACKEND_RING_ENTRIES 64
+
+/**
+ * Size of a single segment submitted to the ring.
+ */
+#define JD_BACKEND_RING_SEGMENT_SIZE (256 * 1024)
+
+static gint jd_backend_ring_unavailable = 0;
+
 static void
-backend_file_add(GHashTable* files, JBackendObject* object)
+jd_backend_ring_free(gpointer data)
 {
-	g_hash_table_insert(jd_backend_file_cache, object->path, object);
-	g_hash_table_insert(files, object->path, object);
+	struct io_uring* ring = data;
 
-	G_UNLOCK(jd_backend_file_cache);
+	io_uring_queue_exit(ring);
+	g_slice_free(struct io_uring, ring);
 }
 
-static gboolean
-backend_create(gpointer backend_data, gchar const* namespace, gchar const* path, gpointer* backend_object)
+static GPrivate jd_backend_ring = G_PRIVATE_INIT(jd_backend_ring_free);
+
+static struct io_uring*
+jd_backend_ring_get_thread(void)
 {
-	JBackendData* bd = backend_data;
-	GHashTable* files = jd_backend_files_get_thread();
+	struct io_uring* ring;
 
-	JBackendObject* bo = NULL;
-	g_autofree gchar* parent = NULL;
-	gchar* full_path;
-	gint fd;
+	if (g_atomic_int_get(&jd_backend_ring_unavailable))
+	{
+		return NULL;
+	}
 
-	full_path = g_build_filename(bd->path, namespace, path, NULL);
+	ring = g_private_get(&jd_backend_ring);
 
-	if ((bo = backend_file_get(files, full_path)) != NULL)
+	if (G_UNLIKELY(ring == NULL))
 	{
-		g_free(full_path);
+		ring = g_slice_new(struct io_uring);
 
-		// FIXME
-		fd = bo->fd;
+		if (io_uring_queue_init(JD_BACKEND_RING_ENTRIES, ring, 0) < 0)
+		{
+			// The kernel does not support io_uring (or it is disabled), fall back to pread/pwrite.
+			g_slice_free(struct io_uring, ring);
+			g_atomic_int_set(&jd_backend_ring_unavailable, 1);
+
+			return NULL;
+		}
 
-		goto end;
+		g_private_replace(&jd_backend_ring, ring);
 	}
 
-	j_trace_file_begin(full_path, J_TRACE_FILE_CREATE);
+	return ring;
+}
 
-	parent = g_path_get_dirname(full_path);
-	g_mkdir_with_parents(parent, 0700);
+/**
+ * Reads or writes buffers using the thread's ring.
+ *
+ * The requests are split into segments that are submitted in batches and reaped together, so multiple ranges can share a batch.
+ * Only the contiguous prefix of each range that has been transferred completely is reported.
+ * The caller is responsible for handling the remainder (for example, at the end of a file or after an error).
+ * Writes to overlapping ranges are not ordered.
+ *
+ * \param ring        The ring.
+ * \param fd          The file descriptor.
+ * \param is_write    Whether to write instead of read.
+ * \param buffers     The buffers.
+ * \param lengths     The buffers' lengths.
+ * \param offsets     The offsets within the file.
+ * \param count       The number of buffers.
+ * \param transferred The number of bytes transferred per buffer.
+ **/
+static void
+jd_backend_ring_transfer(struct io_uring* ring, gint fd, gboolean is_write, gchar* const* buffers, guint64 const* lengths, guint64 const* offsets, guint32 count, guint64* transferred)
+{
+	g_autofree gboolean* stopped = NULL;
+	guint32 current = 0;
+	guint64 position = 0;
 
-	fd = open(full_path, O_RDWR | O_CREAT, 0600);
+	stopped = g_new0(gboolean, count);
 
-	j_trace_file_end(full_path, J_TRACE_FILE_CREATE, 0, 0);
+	for (guint32 i = 0; i < count; i++)
+	{
+		transferred[i] = 0;
+	}
 
-	bo = g_slice_new(JBackendObject);
-	bo->path = full_path;
-	bo->fd = fd;
-	bo->ref_count = 1;
+	while (TRUE)
+	{
+		gsize expected[JD_BACKEND_RING_ENTRIES];
+		gint result[JD_BACKEND_RING_ENTRIES];
+		guint32 segment_buffer[JD_BACKEND_RING_ENTRIES];
+		guint prepared = 0;
+		gint submitted;
+		gboolean broken = FALSE;
+
+		while (prepared < JD_BACKEND_RING_ENTRIES && current < count)
+		{
+			struct io_uring_sqe* sqe;
+			gsize segment;
 
-	backend_file_add(files, bo);
+			if (position >= lengths[current] || stopped[current])
+			{
+				current++;
+				position = 0;
+				continue;
+			}
 
-end:
-	*backend_object = bo;
+			if ((sqe = io_uring_get_sqe(ring)) == NULL)
+			{
+				break;
+			}
+
+			segment = MIN(JD_BACKEND_RING_SEGMENT_SIZE, lengths[current] - position);
+
+			if (is_write)
+			{
+				io_uring_prep_write(sqe, fd, buffers[current] + position, segment, offsets[current] + position);
+			}
+			else
+			{
+				io_uring_prep_read(sqe, fd, buffers[current] + position, segment, offsets[current] + position);
+			}
+
+			sqe->user_data = prepared;
+
+			expected[prepared] = segment;
+			result[prepared] = 0;
+			segment_buffer[prepared] = current;
+
+			position += segment;
+			prepared++;
+		}
+
+		if (prepared == 0)
+		{
+			break;
+		}
 
-	return (fd != -1);
+		submitted = io_uring_submit(ring);
+
+		if (submitted < (gint)prepared)
+		{
+			// Segments that have not been submitted keep a result of 0 and are handled by the caller
+			broken = TRUE;
+		}
+
+		/**
+		 * Submitted segments still use the caller's buffers, so all of them have to be reaped, even if the ring is going to be dropped.
+		 * Otherwise, the kernel could access the buffers after they have been returned to the caller.
+		 */
+		for (gint i = 0; i < submitted; i++)
+		{
+			struct io_uring_cqe* cqe;
+			gint ret;
+
+			while ((ret = io_uring_wait_cqe(ring, &cqe)) < 0)
+			{
+				if (ret != -EINTR)
+				{
+					broken = TRUE;
+				}
+			}
+
+			if (cqe->user_data < prepared)
+			{
+				result[cqe->user_data] = cqe->res;
+			}
+
+			io_uring_cqe_seen(ring, cqe);
+		}
+
+		// Segments are prepared in order, so each buffer's segments are accounted for in order, too
+		for (guint i = 0; i < prepared; i++)
+		{
+			guint32 b = segment_buffer[i];
+
+			if (stopped[b])
+			{
+				continue;
+			}
+
+			if (result[i] > 0)
+			{
+				transferred[b] += result[i];
+			}
+
+			if (result[i] < 0 || (gsize)result[i] != expected[i])
+			{
+				stopped[b] = TRUE;
+			}
+		}
+
+		if (broken)
+		{
+			// The ring is in an unknown state, drop it so the next request gets a fresh one
+			g_private_replace(&jd_backend_ring, NULL);
+			break;
+		}
+	}
 }
+#endif
 
 static gboolean
-backend_open(gpointer backend_data, gchar const* namespace, gchar const* path, gpointer* backend_object)
+backend_create(gpointer backend_data, gchar const* namespace, gchar const* path, gpointer* backend_object)
 {
 	JBackendData* bd = backend_data;
-	GHashTable* files = jd_backend_files_get_thread();
-
-	JBackendObject* bo = NULL;
-	gchar* full_path;
-	gint fd;
-
-	full_path = g_build_filename(bd->path, namespace, path, NULL);
+	JBackendObject* bo;
 
-	if ((bo = backend_file_get(files, full_path)) != NULL)
+	if ((bo = backend_file_get(bd, backend_build_path(bd, namespace, path), TRUE)) == NULL)
 	{
-		g_free(full_path);
-
-		// FIXME
-		fd = bo->fd;
-
-		goto end;
+		return FALSE;
 	}
 
-	j_trace_file_begin(full_path, J_TRACE_FILE_OPEN);
-	fd = open(full_path, O_RDWR);
-	j_trace_file_end(full_path, J_TRACE_FILE_OPEN, 0, 0);
+	*backend_object = bo;
 
-	bo = g_slice_new(JBackendObject);
-	bo->path = full_path;
-	bo->fd = fd;
-	bo->ref_count = 1;
+	return TRUE;
+}
+
+static gboolean
+backend_open(gpointer backend_data, gchar const* namespace, gchar const* path, gpointer* backend_object)
+{
+	JBackendData* bd = backend_data;
+	JBackendObject* bo;
 
-	backend_file_add(files, bo);
+	if ((bo = backend_file_get(bd, backend_build_path(bd, namespace, path), FALSE)) == NULL)
+	{
+		return FALSE;
+	}
 
-end:
 	*backend_object = bo;
 
-	return (fd != -1);
+	return TRUE;
 }
 
 static gboolean
 backend_delete(gpointer backend_data, gpointer backend_object)
 {
+	JBackendData* bd = backend_data;
 	JBackendObject* bo = backend_object;
-	GHashTable* files = jd_backend_files_get_thread();
 	gboolean ret;
 
-	(void)backend_data;
-
 	j_trace_file_begin(bo->path, J_TRACE_FILE_DELETE);
 	ret = (g_unlink(bo->path) == 0);
 	j_trace_file_end(bo->path, J_TRACE_FILE_DELETE, 0, 0);
 
-	g_hash_table_remove(files, bo->path);
+	backend_file_release(bd, bo, TRUE);
 
 	return ret;
 }
@@ -242,15 +633,10 @@ backend_delete(gpointer backend_data, gpointer backend_object)
 static gboolean
 backend_close(gpointer backend_data, gpointer backend_object)
 {
+	JBackendData* bd = backend_data;
 	JBackendObject* bo = backend_object;
-	GHashTable* files = jd_backend_files_get_thread();
-	gboolean ret;
-
-	(void)backend_data;
 
-	ret = g_hash_table_remove(files, bo->path);
-
-	return ret;
+	return backend_file_release(bd, bo, FALSE);
 }
 
 static gboolean
@@ -302,45 +688,85 @@ backend_sync(gpointer backend_data, gpointer backend_object)
 }
 
 static gboolean
-backend_read(gpointer backend_data, gpointer backend_object, gpointer buffer, guint64 length, guint64 offset, guint64* bytes_read)
+backend_read_multi(gpointer backend_data, gpointer backend_object, gpointer const* buffers, guint64 const* lengths, guint64 const* offsets, guint32 count, guint64* bytes_read)
 {
 	JBackendObject* bo = backend_object;
 
-	gsize nbytes_total = 0;
+	gboolean ret = TRUE;
+	guint64 nbytes_total = 0;
+
+#ifdef HAVE_LIBURING
+	struct io_uring* ring;
+#endif
 
 	(void)backend_data;
 
-	j_trace_file_begin(bo->path, J_TRACE_FILE_READ);
+	g_return_val_if_fail(count > 0, FALSE);
 
-	while (nbytes_total < length)
+	for (guint32 i = 0; i < count; i++)
 	{
-		gssize nbytes;
+		bytes_read[i] = 0;
+	}
 
-		nbytes = pread(bo->fd, (gchar*)buffer + nbytes_total, length - nbytes_total, offset + nbytes_total);
+	j_trace_file_begin(bo->path, J_TRACE_FILE_READ);
 
-		if (nbytes == 0)
-		{
-			break;
-		}
-		else if (nbytes < 0)
+#ifdef HAVE_LIBURING
+	if ((ring = jd_backend_ring_get_thread()) != NULL)
+	{
+		// All ranges share the ring's batches
+		jd_backend_ring_transfer(ring, bo->fd, FALSE, (gchar* const*)buffers, lengths, offsets, count, bytes_read);
+	}
+#endif
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		// Handle short reads and systems without io_uring
+		while (bytes_read[i] < lengths[i])
 		{
-			if (errno != EINTR)
+			gssize nbytes;
+
+			nbytes = pread(bo->fd, (gchar*)buffers[i] + bytes_read[i], lengths[i] - bytes_read[i], offsets[i] + bytes_read[i]);
+
+			if (nbytes == 0)
 			{
 				break;
 			}
+			else if (nbytes < 0)
+			{
+				if (errno != EINTR)
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			bytes_read[i] += nbytes;
 		}
 
-		nbytes_total += nbytes;
+		nbytes_total += bytes_read[i];
+		ret = (bytes_read[i] == lengths[i]) && ret;
 	}
 
-	j_trace_file_end(bo->path, J_TRACE_FILE_READ, nbytes_total, offset);
+	j_trace_file_end(bo->path, J_TRACE_FILE_READ, nbytes_total, offsets[0]);
+
+	return ret;
+}
+
+static gboolean
+backend_read(gpointer backend_data, gpointer backend_object, gpointer buffer, guint64 length, guint64 offset, guint64* bytes_read)
+{
+	gboolean ret;
+	guint64 nbytes_total;
+
+	ret = backend_read_multi(backend_data, backend_object, &buffer, &length, &offset, 1, &nbytes_total);
 
 	if (bytes_read != NULL)
 	{
 		*bytes_read = nbytes_total;
 	}
 
-	return (nbytes_total == length);
+	return ret;
 }
 
 static gboolean
@@ -348,24 +774,46 @@ backend_write(gpointer backend_data, gpointer backend_object, gconstpointer buff
 {
 	JBackendObject* bo = backend_object;
 
-	gsize nbytes_total = 0;
+	guint64 nbytes_total = 0;
+
+#ifdef HAVE_LIBURING
+	struct io_uring* ring;
+#endif
 
 	(void)backend_data;
 
 	j_trace_file_begin(bo->path, J_TRACE_FILE_WRITE);
 
+#ifdef HAVE_LIBURING
+	if ((ring = jd_backend_ring_get_thread()) != NULL)
+	{
+		// The ring does not modify the buffer when writing
+		gchar* ring_buffer = (gchar*)(gintptr)buffer;
+
+		jd_backend_ring_transfer(ring, bo->fd, TRUE, &ring_buffer, &length, &offset, 1, &nbytes_total);
+	}
+#endif
+
+	// Handle short writes and systems without io_uring
 	while (nbytes_total < length)
 	{
 		gssize nbytes;
 
 		nbytes = pwrite(bo->fd, (gchar const*)buffer + nbytes_total, length - nbytes_total, offset + nbytes_total);
 
-		if (nbytes <= 0)
+		if (nbytes == 0)
+		{
+			// errno is not set for short writes
+			break;
+		}
+		else if (nbytes < 0)
 		{
 			if (errno != EINTR)
 			{
 				break;
 			}
+
+			continue;
 		}
 
 		nbytes_total += nbytes;
@@ -381,19 +829,265 @@ backend_write(gpointer backend_data, gpointer backend_object, gconstpointer buff
 	return (nbytes_total == length);
 }
 
+static gboolean
+backend_get_holes(gpointer backend_data, gpointer backend_object, guint64 length, guint64 offset, GArray* holes)
+{
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+	JBackendObject* bo = backend_object;
+	guint64 end = offset + length;
+	guint64 position = offset;
+
+	(void)backend_data;
+
+	while (position < end)
+	{
+		off_t data;
+		off_t hole;
+
+		data = lseek(bo->fd, position, SEEK_DATA);
+
+		if (data == -1)
+		{
+			// There is no more data after position
+			if (errno == ENXIO)
+			{
+				data = end;
+			}
+			else
+			{
+				return FALSE;
+			}
+		}
+
+		if ((guint64)data > position)
+		{
+			guint64 hole_length = MIN((guint64)data, end) - position;
+
+			g_array_append_val(holes, position);
+			g_array_append_val(holes, hole_length);
+		}
+
+		if ((guint64)data >= end)
+		{
+			break;
+		}
+
+		if ((hole = lseek(bo->fd, data, SEEK_HOLE)) == -1)
+		{
+			return FALSE;
+		}
+
+		position = hole;
+	}
+
+	return TRUE;
+#else
+	(void)backend_data;
+	(void)backend_object;
+	(void)length;
+	(void)offset;
+	(void)holes;
+
+	return FALSE;
+#endif
+}
+
+static gboolean
+backend_copy(gpointer backend_data, gpointer backend_object, gpointer destination_object, guint64* bytes_copied)
+{
+	JBackendObject* bo = backend_object;
+	JBackendObject* destination = destination_object;
+	g_autofree gchar* buffer = NULL;
+	gboolean ret = TRUE;
+	guint64 nbytes_total = 0;
+	struct stat buf;
+
+	(void)backend_data;
+
+	if (fstat(bo->fd, &buf) != 0)
+	{
+		return FALSE;
+	}
+
+	// Truncating would destroy the source otherwise
+	if (bo == destination)
+	{
+		*bytes_copied = buf.st_size;
+		return TRUE;
+	}
+
+	if (ftruncate(destination->fd, 0) != 0)
+	{
+		return FALSE;
+	}
+
+	j_trace_file_begin(destination->path, J_TRACE_FILE_WRITE);
+
+#ifdef HAVE_FICLONE
+	// Share all extents if the file system supports reflinks
+	if (ioctl(destination->fd, FICLONE, bo->fd) == 0)
+	{
+		nbytes_total = buf.st_size;
+	}
+#endif
+
+#ifdef HAVE_COPY_FILE_RANGE
+	// Copy within the kernel, some file systems also share extents here
+	while (nbytes_total < (guint64)buf.st_size)
+	{
+		loff_t offset_in = nbytes_total;
+		loff_t offset_out = nbytes_total;
+		gssize nbytes;
+
+		nbytes = copy_file_range(bo->fd, &offset_in, destination->fd, &offset_out, buf.st_size - nbytes_total, 0);
+
+		if (nbytes == 0)
+		{
+			break;
+		}
+		else if (nbytes < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			// Use the buffered copy below, for example, if the files are on different file systems
+			break;
+		}
+
+		nbytes_total += nbytes;
+	}
+#endif
+
+	// Handle systems and file systems without copy_file_range
+	while (ret && nbytes_total < (guint64)buf.st_size)
+	{
+		guint64 length;
+		guint64 nbytes_read;
+		guint64 nbytes_written;
+
+		length = MIN((guint64)buf.st_size - nbytes_total, 1024 * 1024);
+
+		if (buffer == NULL)
+		{
+			buffer = g_malloc(length);
+		}
+
+		ret = backend_read(backend_data, bo, buffer, length, nbytes_total, &nbytes_read);
+
+		if (nbytes_read == 0)
+		{
+			break;
+		}
+
+		ret = backend_write(backend_data, destination, buffer, nbytes_read, nbytes_total, &nbytes_written) && ret;
+		nbytes_total += nbytes_written;
+	}
+
+	j_trace_file_end(destination->path, J_TRACE_FILE_WRITE, nbytes_total, 0);
+
+	*bytes_copied = nbytes_total;
+
+	return (nbytes_total == (guint64)buf.st_size);
+}
+
+static gboolean
+backend_allocate(gpointer backend_data, gpointer backend_object, guint64 length, guint64 offset)
+{
+#ifdef FALLOC_FL_KEEP_SIZE
+	JBackendObject* bo = backend_object;
+	gboolean ret;
+
+	(void)backend_data;
+
+	if (length == 0)
+	{
+		return TRUE;
+	}
+
+	// posix_fallocate would change the file's size, which is visible to clients
+	ret = (fallocate(bo->fd, FALLOC_FL_KEEP_SIZE, offset, length) == 0);
+
+	return ret;
+#else
+	(void)backend_data;
+	(void)backend_object;
+	(void)length;
+	(void)offset;
+
+	return FALSE;
+#endif
+}
+
+static void
+backend_statistics(gpointer backend_data, JStatistics* statistics)
+{
+	JBackendData* bd = backend_data;
+
+	j_statistics_add(statistics, J_STATISTICS_FILE_CACHE_HITS, bd->cache_hits);
+	j_statistics_add(statistics, J_STATISTICS_FILE_CACHE_MISSES, bd->cache_misses);
+	j_statistics_add(statistics, J_STATISTICS_FILE_CACHE_EVICTIONS, bd->cache_evictions);
+}
+
 static gboolean
 backend_init(gchar const* path, gpointer* backend_data)
 {
 	JBackendData* bd;
+	g_autoptr(GHashTable) options = NULL;
+	gchar const* layout_str;
+	gchar const* max_open_files_str;
+	guint64 max_open_files = 0;
+	struct rlimit rlim;
 
 	bd = g_slice_new(JBackendData);
-	bd->path = g_strdup(path);
+	bd->path = j_backend_path_parse(path, &options);
+	bd->layout = J_BACKEND_LAYOUT_FLAT;
+	bd->cache_hits = 0;
+	bd->cache_misses = 0;
+	bd->cache_evictions = 0;
+
+	if ((layout_str = g_hash_table_lookup(options, "layout")) != NULL)
+	{
+		if (g_strcmp0(layout_str, "hashed") == 0)
+		{
+			bd->layout = J_BACKEND_LAYOUT_HASHED;
+		}
+		else if (g_strcmp0(layout_str, "flat") != 0)
+		{
+			g_warning("Unknown layout %s, using flat layout.", layout_str);
+		}
+	}
+
+	if ((max_open_files_str = g_hash_table_lookup(options, "max-open-files")) != NULL)
+	{
+		max_open_files = g_ascii_strtoull(max_open_files_str, NULL, 10);
+	}
+
+	if (max_open_files == 0)
+	{
+		// Leave some file descriptors for connections and other backends
+		max_open_files = 1024;
 
-	jd_backend_file_cache = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, NULL);
+		if (getrlimit(RLIMIT_NOFILE, &rlim) == 0 && rlim.rlim_cur != RLIM_INFINITY)
+		{
+			max_open_files = rlim.rlim_cur / 2;
+		}
+	}
 
-	g_mkdir_with_parents(path, 0700);
+	bd->max_open_files = MAX(max_open_files / JD_BACKEND_FILE_CACHE_SHARDS, 1);
 
-	g_atomic_int_inc(&jd_num_backends);
+	for (guint i = 0; i < JD_BACKEND_FILE_CACHE_SHARDS; i++)
+	{
+		JBackendFileCacheShard* shard = &(bd->shards[i]);
+
+		g_mutex_init(&(shard->mutex));
+		shard->files = g_hash_table_new(g_str_hash, g_str_equal);
+		g_queue_init(&(shard->lru));
+		shard->open_files = 0;
+	}
+
+	g_mkdir_with_parents(bd->path, 0700);
 
 	*backend_data = bd;
 
@@ -405,10 +1099,21 @@ backend_fini(gpointer backend_data)
 {
 	JBackendData* bd = backend_data;
 
-	if (g_atomic_int_dec_and_test(&jd_num_backends))
+	for (guint i = 0; i < JD_BACKEND_FILE_CACHE_SHARDS; i++)
 	{
-		g_assert(g_hash_table_size(jd_backend_file_cache) == 0);
-		g_hash_table_destroy(jd_backend_file_cache);
+		JBackendFileCacheShard* shard = &(bd->shards[i]);
+		GList* link;
+
+		// All files should have been closed by now
+		g_assert(g_queue_get_length(&(shard->lru)) == g_hash_table_size(shard->files));
+
+		while ((link = g_queue_pop_head_link(&(shard->lru))) != NULL)
+		{
+			backend_file_free(link->data);
+		}
+
+		g_hash_table_destroy(shard->files);
+		g_mutex_clear(&(shard->mutex));
 	}
 
 	g_free(bd->path);
@@ -428,7 +1133,12 @@ static JBackend posix_backend = {
 		.backend_status = backend_status,
 		.backend_sync = backend_sync,
 		.backend_read = backend_read,
-		.backend_write = backend_write }
+		.backend_write = backend_write,
+		.backend_statistics = backend_statistics,
+		.backend_get_holes = backend_get_holes,
+		.backend_copy = backend_copy,
+		.backend_allocate = backend_allocate,
+		.backend_read_multi = backend_read_multi }
 };
 
 G_MODULE_EXPORT
@@ -205,6 +205,15 @@ backend_write(gpointer backend_data, gpointer backend_object, gconstpointer buff
 	return TRUE;
 }
 
+static gboolean
+backend_truncate(gpointer backend_data, gpointer backend_object, guint64 size)
+{
+	JBackendData* bd = backend_data;
+	JBackendObject* bo = backend_object;
+
+	return (rados_trunc(bd->backend_io, bo->path, size) == 0);
+}
+
 static gboolean
 backend_init(gchar const* path, gpointer* backend_data)
 {
@@ -284,7 +293,8 @@ static JBackend rados_backend = {
 		.backend_status = backend_status,
 		.backend_sync = backend_sync,
 		.backend_read = backend_read,
-		.backend_write = backend_write }
+		.backend_write = backend_write,
+		.backend_truncate = backend_truncate }
 };
 
 G_MODULE_EXPORT
@@ -33,6 +33,7 @@ static gchar* opt_machine_separator = NULL;
 static gboolean opt_machine_readable = FALSE;
 static gchar* opt_path = NULL;
 static gchar* opt_semantics = NULL;
+static gboolean opt_slow = FALSE;
 static gchar* opt_template = NULL;
 
 static JSemantics* j_benchmark_semantics = NULL;
@@ -119,6 +120,21 @@ j_benchmark_add(gchar const* name, BenchmarkFunc benchmark_func)
 	j_benchmarks = g_list_prepend(j_benchmarks, run);
 }
 
+void
+j_benchmark_add_slow(gchar const* name, BenchmarkFunc benchmark_func)
+{
+	g_return_if_fail(name != NULL);
+	g_return_if_fail(benchmark_func != NULL);
+
+	// Slow benchmarks take minutes per iteration and have to be enabled explicitly
+	if (!opt_slow)
+	{
+		return;
+	}
+
+	j_benchmark_add(name, benchmark_func);
+}
+
 static void
 j_benchmark_run_free(gpointer data)
 {
@@ -300,6 +316,7 @@ main(int argc, char** argv)
 		{ "machine-separator", 0, 0, G_OPTION_ARG_STRING, &opt_machine_separator, "Separator for machine-readable output", "\\t" },
 		{ "path", 'p', 0, G_OPTION_ARG_STRING, &opt_path, "Benchmark path to use", NULL },
 		{ "semantics", 's', 0, G_OPTION_ARG_STRING, &opt_semantics, "Semantics to use", NULL },
+		{ "slow", 0, 0, G_OPTION_ARG_NONE, &opt_slow, "Also run slow benchmarks", NULL },
 		{ "template", 't', 0, G_OPTION_ARG_STRING, &opt_template, "Semantics template to use", NULL },
 		{ NULL, 0, 0, 0, NULL, NULL, NULL }
 	};
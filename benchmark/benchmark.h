@@ -46,6 +46,7 @@ void j_benchmark_timer_stop(BenchmarkRun*);
 gboolean j_benchmark_iterate(BenchmarkRun*);
 
 void j_benchmark_add(gchar const*, BenchmarkFunc);
+void j_benchmark_add_slow(gchar const*, BenchmarkFunc);
 
 void benchmark_background_operation(void);
 void benchmark_cache(void);
@@ -302,6 +302,80 @@ benchmark_kv_unordered_put_delete_batch(BenchmarkRun* run)
 	_benchmark_kv_unordered_put_delete(run, TRUE);
 }
 
+static void
+_benchmark_kv_iterator(BenchmarkRun* run, gboolean use_prefix)
+{
+	guint const n = 1000;
+
+	g_autoptr(JBatch) delete_batch = NULL;
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JSemantics) semantics = NULL;
+	guint expected;
+	gboolean ret;
+
+	semantics = j_benchmark_get_semantics();
+	delete_batch = j_batch_new(semantics);
+	batch = j_batch_new(semantics);
+
+	for (guint i = 0; i < n; i++)
+	{
+		g_autoptr(JKV) object = NULL;
+		g_autofree gchar* name = NULL;
+
+		name = g_strdup_printf("benchmark-%d", i);
+		object = j_kv_new("benchmark", name);
+		j_kv_put(object, g_strdup(name), strlen(name), g_free, batch);
+
+		j_kv_delete(object, delete_batch);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	// benchmark-1, benchmark-10 to benchmark-19 and benchmark-100 to benchmark-199
+	expected = (use_prefix) ? 111 : n;
+
+	j_benchmark_timer_start(run);
+
+	while (j_benchmark_iterate(run))
+	{
+		g_autoptr(JKVIterator) iterator = NULL;
+		guint count = 0;
+
+		iterator = j_kv_iterator_new("benchmark", (use_prefix) ? "benchmark-1" : NULL);
+
+		while (j_kv_iterator_next(iterator))
+		{
+			gconstpointer value;
+			guint32 len;
+
+			j_kv_iterator_get(iterator, &value, &len);
+			count++;
+		}
+
+		g_assert_cmpuint(count, ==, expected);
+	}
+
+	j_benchmark_timer_stop(run);
+
+	ret = j_batch_execute(delete_batch);
+	g_assert_true(ret);
+
+	run->operations = expected;
+}
+
+static void
+benchmark_kv_iterator(BenchmarkRun* run)
+{
+	_benchmark_kv_iterator(run, FALSE);
+}
+
+static void
+benchmark_kv_iterator_prefix(BenchmarkRun* run)
+{
+	_benchmark_kv_iterator(run, TRUE);
+}
+
 void
 benchmark_kv(void)
 {
@@ -313,4 +387,6 @@ benchmark_kv(void)
 	j_benchmark_add("/kv/delete-batch", benchmark_kv_delete_batch);
 	j_benchmark_add("/kv/unordered-put-delete", benchmark_kv_unordered_put_delete);
 	j_benchmark_add("/kv/unordered-put-delete-batch", benchmark_kv_unordered_put_delete_batch);
+	j_benchmark_add("/kv/iterator", benchmark_kv_iterator);
+	j_benchmark_add("/kv/iterator-prefix", benchmark_kv_iterator_prefix);
 }
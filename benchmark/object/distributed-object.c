@@ -440,6 +440,92 @@ benchmark_distributed_object_unordered_create_delete_batch(BenchmarkRun* run)
 	_benchmark_distributed_object_unordered_create_delete(run, TRUE);
 }
 
+static void
+_benchmark_distributed_object_layout(BenchmarkRun* run, gboolean adaptive, guint64 size)
+{
+	guint const n = 10;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JSemantics) semantics = NULL;
+	g_autofree gchar* dummy = NULL;
+	guint64 nb = 0;
+	gboolean ret;
+
+	dummy = g_malloc0(size);
+
+	semantics = j_benchmark_get_semantics();
+	batch = j_batch_new(semantics);
+
+	while (j_benchmark_iterate(run))
+	{
+		j_benchmark_timer_start(run);
+
+		for (guint i = 0; i < n; i++)
+		{
+			g_autoptr(JDistribution) distribution = NULL;
+			g_autoptr(JDistributedObject) object = NULL;
+			g_autofree gchar* name = NULL;
+
+			// Each object needs its own distribution since adaptive layouts differ per object
+			distribution = j_distribution_new(J_DISTRIBUTION_ROUND_ROBIN);
+
+			if (!adaptive)
+			{
+				j_distribution_set_block_size(distribution, j_configuration_get_stripe_size(j_configuration()));
+			}
+
+			name = g_strdup_printf("benchmark-%d", i);
+			object = j_distributed_object_new("benchmark", name, distribution);
+			j_distributed_object_create_with_size_hint(object, size, batch);
+			j_distributed_object_write(object, dummy, size, 0, &nb, batch);
+
+			ret = j_batch_execute(batch);
+			g_assert_true(ret);
+			g_assert_cmpuint(nb, ==, size);
+
+			j_distributed_object_read(object, dummy, size, 0, &nb, batch);
+
+			ret = j_batch_execute(batch);
+			g_assert_true(ret);
+			g_assert_cmpuint(nb, ==, size);
+
+			j_distributed_object_delete(object, batch);
+		}
+
+		j_benchmark_timer_stop(run);
+
+		ret = j_batch_execute(batch);
+		g_assert_true(ret);
+	}
+
+	run->operations = n;
+	run->bytes = 2 * n * size;
+}
+
+static void
+benchmark_distributed_object_layout_fixed_small(BenchmarkRun* run)
+{
+	_benchmark_distributed_object_layout(run, FALSE, 1024 * 1024);
+}
+
+static void
+benchmark_distributed_object_layout_adaptive_small(BenchmarkRun* run)
+{
+	_benchmark_distributed_object_layout(run, TRUE, 1024 * 1024);
+}
+
+static void
+benchmark_distributed_object_layout_fixed_large(BenchmarkRun* run)
+{
+	_benchmark_distributed_object_layout(run, FALSE, 256 * 1024 * 1024);
+}
+
+static void
+benchmark_distributed_object_layout_adaptive_large(BenchmarkRun* run)
+{
+	_benchmark_distributed_object_layout(run, TRUE, 256 * 1024 * 1024);
+}
+
 void
 benchmark_distributed_object(void)
 {
@@ -456,4 +542,9 @@ benchmark_distributed_object(void)
 	j_benchmark_add("/object/distributed-object/write-batch", benchmark_distributed_object_write_batch);
 	j_benchmark_add("/object/distributed-object/unordered-create-delete", benchmark_distributed_object_unordered_create_delete);
 	j_benchmark_add("/object/distributed-object/unordered-create-delete-batch", benchmark_distributed_object_unordered_create_delete_batch);
+	// Fixed and adaptive layouts for small and large objects
+	j_benchmark_add("/object/distributed-object/layout-fixed-small", benchmark_distributed_object_layout_fixed_small);
+	j_benchmark_add("/object/distributed-object/layout-adaptive-small", benchmark_distributed_object_layout_adaptive_small);
+	j_benchmark_add("/object/distributed-object/layout-fixed-large", benchmark_distributed_object_layout_fixed_large);
+	j_benchmark_add("/object/distributed-object/layout-adaptive-large", benchmark_distributed_object_layout_adaptive_large);
 }
@@ -428,6 +428,65 @@ benchmark_object_unordered_create_delete_batch(BenchmarkRun* run)
 	_benchmark_object_unordered_create_delete(run, TRUE);
 }
 
+static void
+benchmark_object_create_delete_many(BenchmarkRun* run)
+{
+	// Many objects in a single namespace, useful for comparing the posix backend's layouts
+	guint const n = 1000000;
+	guint const batch_size = 10000;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JSemantics) semantics = NULL;
+	gboolean ret;
+
+	semantics = j_benchmark_get_semantics();
+	batch = j_batch_new(semantics);
+
+	while (j_benchmark_iterate(run))
+	{
+		j_benchmark_timer_start(run);
+
+		for (guint i = 0; i < n; i++)
+		{
+			g_autoptr(JObject) object = NULL;
+			g_autofree gchar* name = NULL;
+
+			name = g_strdup_printf("benchmark-many-%d", i);
+			object = j_object_new("benchmark-many", name);
+			j_object_create(object, batch);
+
+			if ((i + 1) % batch_size == 0)
+			{
+				ret = j_batch_execute(batch);
+				g_assert_true(ret);
+			}
+		}
+
+		for (guint i = 0; i < n; i++)
+		{
+			g_autoptr(JObject) object = NULL;
+			g_autofree gchar* name = NULL;
+
+			name = g_strdup_printf("benchmark-many-%d", i);
+			object = j_object_new("benchmark-many", name);
+			j_object_delete(object, batch);
+
+			if ((i + 1) % batch_size == 0)
+			{
+				ret = j_batch_execute(batch);
+				g_assert_true(ret);
+			}
+		}
+
+		ret = j_batch_execute(batch);
+		g_assert_true(ret);
+
+		j_benchmark_timer_stop(run);
+	}
+
+	run->operations = n * 2;
+}
+
 void
 benchmark_object(void)
 {
@@ -444,4 +503,5 @@ benchmark_object(void)
 	j_benchmark_add("/object/object/write-batch", benchmark_object_write_batch);
 	j_benchmark_add("/object/object/unordered-create-delete", benchmark_object_unordered_create_delete);
 	j_benchmark_add("/object/object/unordered-create-delete-batch", benchmark_object_unordered_create_delete_batch);
+	j_benchmark_add_slow("/object/object/create-delete-many", benchmark_object_create_delete_many);
 }
@@ -157,6 +157,22 @@ j_cmd_copy(gchar const** arguments)
 		}
 	}
 
+	// Let the server copy the data if both objects are stored on the same one
+	if (ouri[0] != NULL && ouri[1] != NULL && j_object_uri_get_index(ouri[0]) == j_object_uri_get_index(ouri[1]))
+	{
+		g_autoptr(JBatch) batch = NULL;
+
+		batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+		j_object_copy(j_object_uri_get_object(ouri[0]), j_object_uri_get_object(ouri[1]), batch);
+
+		if (!j_batch_execute(batch))
+		{
+			ret = FALSE;
+		}
+
+		goto end;
+	}
+
 	offset = 0;
 	buffer = g_new(gchar, 1024 * 1024);
 
@@ -31,7 +31,7 @@ jfs_write(char const* path, char const* buf, size_t size, off_t offset, struct f
 	g_autoptr(JKV) kv = NULL;
 	g_autoptr(JObject) object = NULL;
 	guint64 bytes_written;
-	gpointer value;
+	gpointer value = NULL;
 	guint32 len;
 
 	(void)fi;
@@ -45,32 +45,54 @@ jfs_write(char const* path, char const* buf, size_t size, off_t offset, struct f
 
 	if (j_batch_execute(batch))
 	{
-		bson_t file[1];
-		bson_iter_t iter;
-		gint64 old_size = 0;
-
 		ret = bytes_written;
 
-		bson_init_static(file, value, len);
-
-		if (bson_iter_init_find(&iter, file, "size") && bson_iter_type(&iter) == BSON_TYPE_INT64)
+		// Retry until the size has been updated without interference from other clients
+		while (value != NULL)
 		{
-			old_size = bson_iter_int64(&iter);
+			bson_t file[1];
+			bson_iter_t iter;
+			gpointer new_value;
+			gboolean swapped = FALSE;
+
+			new_value = g_memdup(value, len);
+			bson_init_static(file, new_value, len);
+
+			if (!bson_iter_init_find(&iter, file, "size") || bson_iter_type(&iter) != BSON_TYPE_INT64 || (guint64)bson_iter_int64(&iter) >= offset + size)
+			{
+				bson_destroy(file);
+				g_free(new_value);
+				break;
+			}
+
+			bson_iter_overwrite_int64(&iter, offset + size);
+			bson_destroy(file);
 
-			if ((guint64)old_size < offset + size)
+			j_kv_compare_and_swap(kv, value, len, new_value, len, g_free, &swapped, batch);
+
+			if (!j_batch_execute(batch))
 			{
-				bson_iter_overwrite_int64(&iter, offset + size);
+				ret = -EIO;
+				break;
+			}
 
-				j_kv_put(kv, g_memdup(bson_get_data(file), file->len), file->len, g_free, batch);
+			if (swapped)
+			{
+				break;
+			}
 
-				if (!j_batch_execute(batch))
-				{
-					ret = -EIO;
-				}
+			g_free(value);
+			value = NULL;
+
+			j_kv_get(kv, &value, &len, batch);
+
+			if (!j_batch_execute(batch))
+			{
+				ret = -EIO;
+				break;
 			}
 		}
 
-		bson_destroy(file);
 		g_free(value);
 	}
 
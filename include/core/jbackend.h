@@ -35,6 +35,7 @@
 #include <bson.h>
 
 #include <core/jsemantics.h>
+#include <core/jstatistics.h>
 
 G_BEGIN_DECLS
 
@@ -146,6 +147,79 @@ struct JBackend
 
 			gboolean (*backend_read)(gpointer, gpointer, gpointer, guint64, guint64, guint64*);
 			gboolean (*backend_write)(gpointer, gpointer, gconstpointer, guint64, guint64, guint64*);
+
+			/**
+			 * Adds backend-specific statistics (optional).
+			 *
+			 * \param[in]  backend_data The backend data.
+			 * \param[out] statistics   The statistics to add to.
+			 **/
+			void (*backend_statistics)(gpointer, JStatistics*);
+
+			/**
+			 * Returns the holes within a range of an object (optional).
+			 *
+			 * \param[in]  backend_data   The backend data.
+			 * \param[in]  backend_object The backend object.
+			 * \param[in]  length         The range's length.
+			 * \param[in]  offset         The range's offset.
+			 * \param[out] holes          The holes as sorted pairs of offset and length (guint64), clipped to the range.
+			 *
+			 * \return TRUE on success, FALSE otherwise.
+			 **/
+			gboolean (*backend_get_holes)(gpointer, gpointer, guint64, guint64, GArray*);
+
+			/**
+			 * Copies an object's data to another object (optional).
+			 * The destination object's previous data is replaced.
+			 *
+			 * \param[in]  backend_data       The backend data.
+			 * \param[in]  backend_object     The source backend object.
+			 * \param[in]  destination_object The destination backend object.
+			 * \param[out] bytes_copied       The number of bytes copied.
+			 *
+			 * \return TRUE on success, FALSE otherwise.
+			 **/
+			gboolean (*backend_copy)(gpointer, gpointer, gpointer, guint64*);
+
+			/**
+			 * Preallocates storage for a range of an object without changing its size (optional).
+			 *
+			 * \param[in] backend_data   The backend data.
+			 * \param[in] backend_object The backend object.
+			 * \param[in] length         The range's length.
+			 * \param[in] offset         The range's offset.
+			 *
+			 * \return TRUE on success, FALSE otherwise.
+			 **/
+			gboolean (*backend_allocate)(gpointer, gpointer, guint64, guint64);
+
+			/**
+			 * Truncates or extends an object to a size (optional).
+			 *
+			 * \param[in] backend_data   The backend data.
+			 * \param[in] backend_object The backend object.
+			 * \param[in] size           The new size.
+			 *
+			 * \return TRUE on success, FALSE otherwise.
+			 **/
+			gboolean (*backend_truncate)(gpointer, gpointer, guint64);
+
+			/**
+			 * Reads multiple ranges of an object at once (optional).
+			 * Backends can use this to submit all reads together.
+			 *
+			 * \param[in]  backend_data   The backend data.
+			 * \param[in]  backend_object The backend object.
+			 * \param[in]  buffers        The buffers.
+			 * \param[in]  lengths        The ranges' lengths. Ranges with a length of 0 are skipped.
+			 * \param[in]  offsets        The ranges' offsets.
+			 * \param[in]  count          The number of ranges.
+			 * \param[out] bytes_read     The number of bytes read per range.
+			 *
+			 * \return TRUE on success, FALSE if at least one range could not be read completely.
+			 **/
+			gboolean (*backend_read_multi)(gpointer, gpointer, gpointer const*, guint64 const*, guint64 const*, guint32, guint64*);
 		} object;
 
 		struct
@@ -160,9 +234,109 @@ struct JBackend
 			gboolean (*backend_delete)(gpointer, gpointer, gchar const*);
 			gboolean (*backend_get)(gpointer, gpointer, gchar const*, gpointer*, guint32*);
 
+			/**
+			 * Gets a value without copying it (optional).
+			 *
+			 * \param[in]  batch A batch.
+			 * \param[in]  key   A key.
+			 * \param[out] value The value. Owned by the backend and valid until the batch is executed.
+			 * \param[out] len   The value's length.
+			 *
+			 * \return TRUE on success, FALSE otherwise.
+			 **/
+			gboolean (*backend_get_borrowed)(gpointer, gpointer, gchar const*, gconstpointer*, guint32*);
+
+			/**
+			 * Gets multiple values at once (optional).
+			 * Backends can use this to sort the lookups or to perform them in parallel.
+			 *
+			 * \param[in]  batch  A batch.
+			 * \param[in]  keys   The keys.
+			 * \param[in]  count  The number of keys.
+			 * \param[out] values The values, NULL for keys that do not exist. Owned by the backend and valid until the batch is executed.
+			 * \param[out] lens   The values' lengths.
+			 *
+			 * \return TRUE on success, FALSE if at least one lookup failed.
+			 **/
+			gboolean (*backend_get_multi)(gpointer, gpointer, gchar const* const*, guint32, gconstpointer*, guint32*);
+
+			/**
+			 * Replaces a value if it matches an expected value (optional).
+			 * The comparison and the replacement are atomic with respect to the other atomic operations.
+			 * Plain modifications of other batches are not serialized with them and can overwrite the new value at any time.
+			 *
+			 * Atomic operations have to see the batch's previous modifications.
+			 * Backends are allowed to write these modifications before performing the operation.
+			 * Therefore, a batch containing atomic operations is not guaranteed to be applied as a whole.
+			 * If the operation fails, the batch's previous modifications might already have been written.
+			 * This also applies to backend_add and backend_append.
+			 *
+			 * \param[in]  batch        A batch.
+			 * \param[in]  key          A key.
+			 * \param[in]  expected     The expected value, NULL if the key must not exist.
+			 * \param[in]  expected_len The expected value's length.
+			 * \param[in]  value        The new value.
+			 * \param[in]  len          The new value's length.
+			 * \param[out] swapped      Whether the value has been replaced.
+			 *
+			 * \return TRUE on success, FALSE otherwise.
+			 **/
+			gboolean (*backend_compare_and_swap)(gpointer, gpointer, gchar const*, gconstpointer, guint32, gconstpointer, guint32, gboolean*);
+
+			/**
+			 * Atomically adds to a 64-bit integer value (optional).
+			 * Values are stored in host byte order, a missing key counts as 0.
+			 *
+			 * \param[in]  batch  A batch.
+			 * \param[in]  key    A key.
+			 * \param[in]  delta  The value to add.
+			 * \param[out] result The new value.
+			 *
+			 * \return TRUE on success, FALSE otherwise (for instance, if the existing value is not 64 bits long).
+			 **/
+			gboolean (*backend_add)(gpointer, gpointer, gchar const*, gint64, gint64*);
+
+			/**
+			 * Atomically appends to a value (optional).
+			 * A missing key counts as an empty value.
+			 *
+			 * \param[in] batch A batch.
+			 * \param[in] key   A key.
+			 * \param[in] value The data to append.
+			 * \param[in] len   The data's length.
+			 *
+			 * \return TRUE on success, FALSE otherwise.
+			 **/
+			gboolean (*backend_append)(gpointer, gpointer, gchar const*, gconstpointer, guint32);
+
 			gboolean (*backend_get_all)(gpointer, gchar const*, gpointer*);
 			gboolean (*backend_get_by_prefix)(gpointer, gchar const*, gchar const*, gpointer*);
+
+			/**
+			 * Creates an iterator over a range of keys (optional).
+			 * The pairs are returned by backend_iterate in key order.
+			 *
+			 * \param[in]  namespace A namespace.
+			 * \param[in]  start     The first key (inclusive), NULL to start at the beginning.
+			 * \param[in]  end       The last key (exclusive), NULL to continue until the end.
+			 * \param[in]  limit     The maximum number of pairs, 0 for no limit.
+			 * \param[in]  reverse   Whether to return the pairs in descending order.
+			 * \param[out] iterator  An iterator.
+			 *
+			 * \return TRUE on success, FALSE otherwise.
+			 **/
+			gboolean (*backend_get_range)(gpointer, gchar const*, gchar const*, gchar const*, guint32, gboolean, gpointer*);
+
 			gboolean (*backend_iterate)(gpointer, gpointer, gchar const**, gconstpointer*, guint32*);
+
+			/**
+			 * Frees an iterator that has not reached its end yet (optional).
+			 * backend_iterate frees the iterator once it returns FALSE, so this is only necessary to abort an iteration.
+			 * Iterators of backends without this function are iterated until the end.
+			 *
+			 * \param[in] iterator An iterator.
+			 **/
+			void (*backend_iterator_free)(gpointer, gpointer);
 		} kv;
 
 		struct
@@ -381,6 +555,8 @@ GQuark j_backend_sql_error_quark(void);
 
 JBackend* backend_info(void);
 
+gchar* j_backend_path_parse(gchar const*, GHashTable**);
+
 gboolean j_backend_load_client(gchar const*, gchar const*, JBackendType, GModule**, JBackend**);
 gboolean j_backend_load_server(gchar const*, gchar const*, JBackendType, GModule**, JBackend**);
 
@@ -399,6 +575,13 @@ gboolean j_backend_object_sync(JBackend*, gpointer);
 gboolean j_backend_object_read(JBackend*, gpointer, gpointer, guint64, guint64, guint64*);
 gboolean j_backend_object_write(JBackend*, gpointer, gconstpointer, guint64, guint64, guint64*);
 
+gboolean j_backend_object_statistics(JBackend*, JStatistics*);
+gboolean j_backend_object_get_holes(JBackend*, gpointer, guint64, guint64, GArray*);
+gboolean j_backend_object_copy(JBackend*, gpointer, gpointer, guint64*);
+gboolean j_backend_object_allocate(JBackend*, gpointer, guint64, guint64);
+gboolean j_backend_object_truncate(JBackend*, gpointer, guint64);
+gboolean j_backend_object_read_multi(JBackend*, gpointer, gpointer const*, guint64 const*, guint64 const*, guint32, guint64*);
+
 gboolean j_backend_kv_init(JBackend*, gchar const*);
 void j_backend_kv_fini(JBackend*);
 
@@ -408,10 +591,18 @@ gboolean j_backend_kv_batch_execute(JBackend*, gpointer);
 gboolean j_backend_kv_put(JBackend*, gpointer, gchar const*, gconstpointer, guint32);
 gboolean j_backend_kv_delete(JBackend*, gpointer, gchar const*);
 gboolean j_backend_kv_get(JBackend*, gpointer, gchar const*, gpointer*, guint32*);
+gboolean j_backend_kv_get_borrowed(JBackend*, gpointer, gchar const*, gconstpointer*, guint32*);
+gboolean j_backend_kv_get_multi(JBackend*, gpointer, gchar const* const*, guint32, gconstpointer*, guint32*);
+
+gboolean j_backend_kv_compare_and_swap(JBackend*, gpointer, gchar const*, gconstpointer, guint32, gconstpointer, guint32, gboolean*);
+gboolean j_backend_kv_add(JBackend*, gpointer, gchar const*, gint64, gint64*);
+gboolean j_backend_kv_append(JBackend*, gpointer, gchar const*, gconstpointer, guint32);
 
 gboolean j_backend_kv_get_all(JBackend*, gchar const*, gpointer*);
 gboolean j_backend_kv_get_by_prefix(JBackend*, gchar const*, gchar const*, gpointer*);
+gboolean j_backend_kv_get_range(JBackend*, gchar const*, gchar const*, gchar const*, guint32, gboolean, gpointer*);
 gboolean j_backend_kv_iterate(JBackend*, gpointer, gchar const**, gconstpointer*, guint32*);
+void j_backend_kv_iterator_free(JBackend*, gpointer);
 
 gboolean j_backend_db_init(JBackend*, gchar const*);
 void j_backend_db_fini(JBackend*);
@@ -37,6 +37,26 @@ struct JConfiguration;
 
 typedef struct JConfiguration JConfiguration;
 
+/**
+ * How keys are mapped to kv servers.
+ **/
+enum JKVPlacement
+{
+	/**
+	 * The key's djb2 hash modulo the number of servers.
+	 * Adding a server moves almost all keys.
+	 **/
+	J_KV_PLACEMENT_MODULO,
+
+	/**
+	 * Jump consistent hashing of the key's wyhash.
+	 * Adding a server only moves the keys that belong to it.
+	 **/
+	J_KV_PLACEMENT_JUMP
+};
+
+typedef enum JKVPlacement JKVPlacement;
+
 JConfiguration* j_configuration(void);
 
 JConfiguration* j_configuration_new(void);
@@ -49,6 +69,7 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(JConfiguration, j_configuration_unref)
 
 gchar const* j_configuration_get_server(JConfiguration*, JBackendType, guint32);
 guint32 j_configuration_get_server_count(JConfiguration*, JBackendType);
+gboolean j_configuration_get_local_server(JConfiguration*, JBackendType, guint32*);
 
 gchar const* j_configuration_get_backend(JConfiguration*, JBackendType);
 gchar const* j_configuration_get_backend_component(JConfiguration*, JBackendType);
@@ -57,6 +78,8 @@ gchar const* j_configuration_get_backend_path(JConfiguration*, JBackendType);
 guint64 j_configuration_get_max_operation_size(JConfiguration*);
 guint32 j_configuration_get_max_connections(JConfiguration*);
 guint64 j_configuration_get_stripe_size(JConfiguration*);
+guint64 j_configuration_get_inline_threshold(JConfiguration*);
+JKVPlacement j_configuration_get_kv_placement(JConfiguration*);
 
 G_END_DECLS
 
@@ -37,6 +37,9 @@ G_BEGIN_DECLS
 gpointer j_connection_pool_pop(JBackendType, guint);
 void j_connection_pool_push(JBackendType, guint, gpointer);
 
+void j_connection_pool_add_latency(JBackendType, guint, gint64);
+gint64 j_connection_pool_get_latency(JBackendType, guint);
+
 G_END_DECLS
 
 #endif
@@ -37,6 +37,9 @@ G_BEGIN_DECLS
 guint64 j_helper_atomic_add(guint64 volatile*, guint64);
 gboolean j_helper_execute_parallel(JBackgroundOperationFunc, gpointer*, guint);
 guint32 j_helper_hash(gchar const*);
+guint32 j_helper_hash_fnv1a(gchar const*);
+guint64 j_helper_hash_wyhash(gchar const*);
+guint32 j_helper_jump_hash(guint64, guint32);
 // FIXME get rid of GSocketConnection
 void j_helper_set_nodelay(GSocketConnection*, gboolean);
 gchar* j_helper_str_replace(gchar const*, gchar const*, gchar const*);
@@ -43,11 +43,17 @@ enum JMessageType
 	J_MESSAGE_OBJECT_STATUS,
 	J_MESSAGE_OBJECT_SYNC,
 	J_MESSAGE_OBJECT_WRITE,
+	J_MESSAGE_OBJECT_COPY,
 	J_MESSAGE_KV_PUT,
 	J_MESSAGE_KV_DELETE,
 	J_MESSAGE_KV_GET,
 	J_MESSAGE_KV_GET_ALL,
 	J_MESSAGE_KV_GET_BY_PREFIX,
+	J_MESSAGE_KV_GET_RANGE,
+	J_MESSAGE_KV_ITERATE,
+	J_MESSAGE_KV_COMPARE_AND_SWAP,
+	J_MESSAGE_KV_ADD,
+	J_MESSAGE_KV_APPEND,
 	J_MESSAGE_DB_SCHEMA_CREATE,
 	J_MESSAGE_DB_SCHEMA_GET,
 	J_MESSAGE_DB_SCHEMA_DELETE,
@@ -59,6 +65,12 @@ enum JMessageType
 
 typedef enum JMessageType JMessageType;
 
+/**
+ * Values of J_MESSAGE_KV_GET replies that are larger than this are not copied into the reply.
+ * They are sent directly after it instead and have to be read from the connection.
+ **/
+#define J_MESSAGE_KV_INLINE_MAX (64 * 1024)
+
 struct JMessage;
 
 typedef struct JMessage JMessage;
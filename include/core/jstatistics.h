@@ -40,7 +40,10 @@ enum JStatisticsType
 	J_STATISTICS_BYTES_READ,
 	J_STATISTICS_BYTES_WRITTEN,
 	J_STATISTICS_BYTES_RECEIVED,
-	J_STATISTICS_BYTES_SENT
+	J_STATISTICS_BYTES_SENT,
+	J_STATISTICS_FILE_CACHE_HITS,
+	J_STATISTICS_FILE_CACHE_MISSES,
+	J_STATISTICS_FILE_CACHE_EVICTIONS
 };
 
 typedef enum JStatisticsType JStatisticsType;
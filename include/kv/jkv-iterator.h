@@ -43,11 +43,14 @@ G_BEGIN_DECLS
 
 JKVIterator* j_kv_iterator_new(gchar const*, gchar const*);
 JKVIterator* j_kv_iterator_new_for_index(guint32, gchar const*, gchar const*);
+JKVIterator* j_kv_iterator_new_ordered(gchar const*, gchar const*);
+JKVIterator* j_kv_iterator_new_range(gchar const*, gchar const*, gchar const*, guint32, gboolean);
 void j_kv_iterator_free(JKVIterator*);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(JKVIterator, j_kv_iterator_free)
 
 gboolean j_kv_iterator_next(JKVIterator*);
+gboolean j_kv_iterator_failed(JKVIterator*);
 gchar const* j_kv_iterator_get(JKVIterator*, gconstpointer*, guint32*);
 
 G_END_DECLS
@@ -46,6 +46,7 @@ typedef void (*JKVGetFunc)(gpointer, guint32, gpointer);
 
 JKV* j_kv_new(gchar const*, gchar const*);
 JKV* j_kv_new_for_index(guint32, gchar const*, gchar const*);
+JKV* j_kv_new_local(gchar const*, gchar const*);
 JKV* j_kv_ref(JKV*);
 void j_kv_unref(JKV*);
 
@@ -57,6 +58,12 @@ void j_kv_delete(JKV*, JBatch*);
 void j_kv_get(JKV*, gpointer*, guint32*, JBatch*);
 void j_kv_get_callback(JKV*, JKVGetFunc, gpointer, JBatch*);
 
+void j_kv_compare_and_swap(JKV*, gconstpointer, guint32, gpointer, guint32, GDestroyNotify, gboolean*, JBatch*);
+void j_kv_add(JKV*, gint64, gint64*, JBatch*);
+void j_kv_append(JKV*, gpointer, guint32, GDestroyNotify, JBatch*);
+
+guint32 j_kv_placement_index(JKVPlacement, guint32, gchar const*);
+
 G_END_DECLS
 
 #endif
@@ -44,14 +44,18 @@ void j_distributed_object_unref(JDistributedObject*);
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(JDistributedObject, j_distributed_object_unref)
 
 void j_distributed_object_create(JDistributedObject*, JBatch*);
+void j_distributed_object_create_with_size_hint(JDistributedObject*, guint64, JBatch*);
 void j_distributed_object_delete(JDistributedObject*, JBatch*);
 
 void j_distributed_object_read(JDistributedObject*, gpointer, guint64, guint64, guint64*, JBatch*);
 void j_distributed_object_write(JDistributedObject*, gconstpointer, guint64, guint64, guint64*, JBatch*);
 
 void j_distributed_object_status(JDistributedObject*, gint64*, guint64*, JBatch*);
+void j_distributed_object_status_scan(JDistributedObject*, gint64*, guint64*, JBatch*);
 void j_distributed_object_sync(JDistributedObject*, JBatch*);
 
+void j_distributed_object_copy(JDistributedObject*, JDistributedObject*, JBatch*);
+
 G_END_DECLS
 
 #endif
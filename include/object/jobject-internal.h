@@ -35,6 +35,8 @@ G_BEGIN_DECLS
 
 G_GNUC_INTERNAL JBackend* j_object_get_backend(void);
 
+G_GNUC_INTERNAL guint64 j_object_receive_read_reply(JMessage*, gpointer, gpointer);
+
 G_END_DECLS
 
 #endif
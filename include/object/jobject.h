@@ -39,12 +39,14 @@ typedef struct JObject JObject;
 
 JObject* j_object_new(gchar const*, gchar const*);
 JObject* j_object_new_for_index(guint32, gchar const*, gchar const*);
+JObject* j_object_new_local(gchar const*, gchar const*);
 JObject* j_object_ref(JObject*);
 void j_object_unref(JObject*);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(JObject, j_object_unref)
 
 void j_object_create(JObject*, JBatch*);
+void j_object_create_with_size_hint(JObject*, guint64, JBatch*);
 void j_object_delete(JObject*, JBatch*);
 
 void j_object_read(JObject*, gpointer, guint64, guint64, guint64*, JBatch*);
@@ -53,6 +55,8 @@ void j_object_write(JObject*, gconstpointer, guint64, guint64, guint64*, JBatch*
 void j_object_status(JObject*, gint64*, guint64*, JBatch*);
 void j_object_sync(JObject*, JBatch*);
 
+void j_object_copy(JObject*, JObject*, JBatch*);
+
 G_END_DECLS
 
 #endif
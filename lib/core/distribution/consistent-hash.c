@@ -0,0 +1,327 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <bson.h>
+
+#include <jconfiguration.h>
+#include <jhelper.h>
+#include <jtrace.h>
+
+#include "distribution.h"
+
+/**
+ * \defgroup JDistribution Distribution
+ *
+ * Data structures and functions for managing distributions.
+ *
+ * @{
+ **/
+
+/**
+ * A distribution.
+ **/
+struct JDistributionConsistentHash
+{
+	/**
+	 * The server count.
+	 **/
+	guint server_count;
+
+	/**
+	 * The length.
+	 **/
+	guint64 length;
+
+	/**
+	 * The offset.
+	 **/
+	guint64 offset;
+
+	/**
+	 * The block size.
+	 */
+	guint64 block_size;
+
+	/**
+	 * The seed.
+	 * Different objects use different seeds so that their blocks are placed independently.
+	 */
+	guint64 seed;
+};
+
+typedef struct JDistributionConsistentHash JDistributionConsistentHash;
+
+/**
+ * Mixes a 64-bit value (SplitMix64 finalizer).
+ *
+ * \private
+ *
+ * \param value A value.
+ *
+ * \return The mixed value.
+ **/
+static guint64
+distribution_mix(guint64 value)
+{
+	value += G_GUINT64_CONSTANT(0x9e3779b97f4a7c15);
+	value = (value ^ (value >> 30)) * G_GUINT64_CONSTANT(0xbf58476d1ce4e5b9);
+	value = (value ^ (value >> 27)) * G_GUINT64_CONSTANT(0x94d049bb133111eb);
+
+	return value ^ (value >> 31);
+}
+
+/**
+ * Distributes data using consistent hashing.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ * \param index        A server index.
+ * \param new_length   A new length.
+ * \param new_offset   A new offset.
+ *
+ * \return TRUE on success, FALSE if the distribution is finished.
+ **/
+static gboolean
+distribution_distribute(gpointer data, guint* index, guint64* new_length, guint64* new_offset, guint64* block_id)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionConsistentHash* distribution = data;
+
+	guint64 block;
+	guint64 displacement;
+
+	if (distribution->length == 0)
+	{
+		return FALSE;
+	}
+
+	block = distribution->offset / distribution->block_size;
+	displacement = distribution->offset % distribution->block_size;
+
+	*index = j_helper_jump_hash(distribution_mix(distribution->seed ^ block), distribution->server_count);
+	*new_length = MIN(distribution->length, distribution->block_size - displacement);
+	/**
+	 * Blocks are not assigned to servers in a regular pattern, so their local position cannot be compacted.
+	 * Each server stores its blocks at their global offsets instead, leaving holes for the other servers' blocks.
+	 * This also keeps the local offsets valid when blocks are moved to another server.
+	 */
+	*new_offset = distribution->offset;
+	*block_id = block;
+
+	distribution->length -= *new_length;
+	distribution->offset += *new_length;
+
+	return TRUE;
+}
+
+static gpointer
+distribution_new(guint server_count, guint64 stripe_size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionConsistentHash* distribution;
+
+	distribution = g_slice_new(JDistributionConsistentHash);
+	distribution->server_count = server_count;
+	distribution->length = 0;
+	distribution->offset = 0;
+	distribution->block_size = stripe_size;
+
+	distribution->seed = ((guint64)g_random_int() << 32) | g_random_int();
+
+	return distribution;
+}
+
+/**
+ * Decreases a distribution's reference count.
+ * When the reference count reaches zero, frees the memory allocated for the distribution.
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ **/
+static void
+distribution_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionConsistentHash* distribution = data;
+
+	g_return_if_fail(distribution != NULL);
+
+	g_slice_free(JDistributionConsistentHash, distribution);
+}
+
+/**
+ * Sets the block size or the seed for the consistent hash distribution.
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ * \param key          A key.
+ * \param value        A value.
+ */
+static void
+distribution_set(gpointer data, gchar const* key, guint64 value)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionConsistentHash* distribution = data;
+
+	g_return_if_fail(distribution != NULL);
+
+	if (g_strcmp0(key, "block-size") == 0)
+	{
+		distribution->block_size = value;
+	}
+	else if (g_strcmp0(key, "seed") == 0)
+	{
+		distribution->seed = value;
+	}
+}
+
+/**
+ * Serializes distribution.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution Credentials.
+ *
+ * \return A new BSON object. Should be freed with g_slice_free().
+ **/
+static void
+distribution_serialize(gpointer data, bson_t* b)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionConsistentHash* distribution = data;
+
+	g_return_if_fail(distribution != NULL);
+
+	bson_append_int64(b, "block_size", -1, distribution->block_size);
+	bson_append_int64(b, "seed", -1, (gint64)distribution->seed);
+}
+
+/**
+ * Deserializes distribution.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution distribution.
+ * \param b           A BSON object.
+ **/
+static void
+distribution_deserialize(gpointer data, bson_t const* b)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionConsistentHash* distribution = data;
+
+	bson_iter_t iterator;
+
+	g_return_if_fail(distribution != NULL);
+	g_return_if_fail(b != NULL);
+
+	bson_iter_init(&iterator, b);
+
+	while (bson_iter_next(&iterator))
+	{
+		gchar const* key;
+
+		key = bson_iter_key(&iterator);
+
+		if (g_strcmp0(key, "block_size") == 0)
+		{
+			distribution->block_size = bson_iter_int64(&iterator);
+		}
+		else if (g_strcmp0(key, "seed") == 0)
+		{
+			distribution->seed = (guint64)bson_iter_int64(&iterator);
+		}
+	}
+}
+
+/**
+ * Initializes a distribution.
+ *
+ * \code
+ * JDistribution* d;
+ *
+ * j_distribution_init(d, 0, 0);
+ * \endcode
+ *
+ * \param length A length.
+ * \param offset An offset.
+ *
+ * \return A new distribution. Should be freed with j_distribution_unref().
+ **/
+static void
+distribution_reset(gpointer data, guint64 length, guint64 offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionConsistentHash* distribution = data;
+
+	g_return_if_fail(distribution != NULL);
+
+	distribution->length = length;
+	distribution->offset = offset;
+}
+
+void
+j_distribution_consistent_hash_get_vtable(JDistributionVTable* vtable)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	vtable->distribution_new = distribution_new;
+	vtable->distribution_free = distribution_free;
+	vtable->distribution_set = distribution_set;
+	vtable->distribution_set2 = NULL;
+	vtable->distribution_serialize = distribution_serialize;
+	vtable->distribution_deserialize = distribution_deserialize;
+	vtable->distribution_reset = distribution_reset;
+	vtable->distribution_distribute = distribution_distribute;
+	vtable->distribution_get_replica_count = NULL;
+	vtable->distribution_get_replica = NULL;
+	vtable->distribution_get_offset = NULL;
+}
+
+/**
+ * @}
+ **/
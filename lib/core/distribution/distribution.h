@@ -46,6 +46,11 @@ struct JDistributionVTable
 
 	void (*distribution_reset)(gpointer, guint64, guint64);
 	gboolean (*distribution_distribute)(gpointer, guint*, guint64*, guint64*, guint64*);
+
+	guint (*distribution_get_replica_count)(gpointer);
+	void (*distribution_get_replica)(gpointer, guint, guint*, guint64*);
+
+	guint64 (*distribution_get_offset)(gpointer, guint, guint64);
 };
 
 typedef struct JDistributionVTable JDistributionVTable;
@@ -53,5 +58,7 @@ typedef struct JDistributionVTable JDistributionVTable;
 void j_distribution_round_robin_get_vtable(JDistributionVTable*);
 void j_distribution_single_server_get_vtable(JDistributionVTable*);
 void j_distribution_weighted_get_vtable(JDistributionVTable*);
+void j_distribution_consistent_hash_get_vtable(JDistributionVTable*);
+void j_distribution_replicated_get_vtable(JDistributionVTable*);
 
 #endif
@@ -0,0 +1,386 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <bson.h>
+
+#include <jconfiguration.h>
+#include <jtrace.h>
+
+#include "distribution.h"
+
+/**
+ * \defgroup JDistribution Distribution
+ *
+ * Data structures and functions for managing distributions.
+ *
+ * @{
+ **/
+
+/**
+ * A distribution.
+ **/
+struct JDistributionReplicated
+{
+	/**
+	 * The server count.
+	 **/
+	guint server_count;
+
+	/**
+	 * The length.
+	 **/
+	guint64 length;
+
+	/**
+	 * The offset.
+	 **/
+	guint64 offset;
+
+	/**
+	 * The block size.
+	 */
+	guint64 block_size;
+
+	guint start_index;
+
+	/**
+	 * The number of copies of each block.
+	 */
+	guint replica_count;
+
+	/**
+	 * The block last returned by distribution_distribute().
+	 */
+	struct
+	{
+		guint64 block;
+		guint64 displacement;
+	} last;
+};
+
+typedef struct JDistributionReplicated JDistributionReplicated;
+
+/**
+ * Distributes data in a round robin fashion and stores each block on the following servers, too.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ * \param index        A server index.
+ * \param new_length   A new length.
+ * \param new_offset   A new offset.
+ *
+ * \return TRUE on success, FALSE if the distribution is finished.
+ **/
+static gboolean
+distribution_distribute(gpointer data, guint* index, guint64* new_length, guint64* new_offset, guint64* block_id)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	guint64 block;
+	guint64 displacement;
+	guint64 round;
+
+	if (distribution->length == 0)
+	{
+		return FALSE;
+	}
+
+	block = distribution->offset / distribution->block_size;
+	round = block / distribution->server_count;
+	displacement = distribution->offset % distribution->block_size;
+
+	/**
+	 * Every server stores replica_count blocks per round.
+	 * Replica r of a block is stored in slot r of the round on the r-th server after the block's primary server.
+	 */
+	*index = (distribution->start_index + block) % distribution->server_count;
+	*new_length = MIN(distribution->length, distribution->block_size - displacement);
+	*new_offset = (round * distribution->replica_count * distribution->block_size) + displacement;
+	*block_id = block;
+
+	distribution->last.block = block;
+	distribution->last.displacement = displacement;
+
+	distribution->length -= *new_length;
+	distribution->offset += *new_length;
+
+	return TRUE;
+}
+
+static guint
+distribution_get_replica_count(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	return distribution->replica_count;
+}
+
+static void
+distribution_get_replica(gpointer data, guint replica, guint* index, guint64* new_offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	guint64 round;
+
+	g_return_if_fail(replica < distribution->replica_count);
+
+	round = distribution->last.block / distribution->server_count;
+
+	*index = (distribution->start_index + distribution->last.block + replica) % distribution->server_count;
+	*new_offset = ((round * distribution->replica_count + replica) * distribution->block_size) + distribution->last.displacement;
+}
+
+static guint64
+distribution_get_offset(gpointer data, guint index, guint64 new_offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	guint64 block;
+	guint64 round;
+	guint replica;
+	guint primary;
+
+	round = new_offset / (distribution->replica_count * distribution->block_size);
+	replica = (new_offset / distribution->block_size) % distribution->replica_count;
+
+	// Replica r is stored on the r-th server after the block's primary server
+	primary = (index + distribution->server_count - replica) % distribution->server_count;
+	block = (round * distribution->server_count) + ((primary + distribution->server_count - distribution->start_index) % distribution->server_count);
+
+	return (block * distribution->block_size) + (new_offset % distribution->block_size);
+}
+
+static gpointer
+distribution_new(guint server_count, guint64 stripe_size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution;
+
+	distribution = g_slice_new(JDistributionReplicated);
+	distribution->server_count = server_count;
+	distribution->length = 0;
+	distribution->offset = 0;
+	distribution->block_size = stripe_size;
+	distribution->replica_count = MIN(2, server_count);
+	distribution->last.block = 0;
+	distribution->last.displacement = 0;
+
+	distribution->start_index = g_random_int_range(0, distribution->server_count);
+
+	return distribution;
+}
+
+/**
+ * Decreases a distribution's reference count.
+ * When the reference count reaches zero, frees the memory allocated for the distribution.
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ **/
+static void
+distribution_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	g_return_if_fail(distribution != NULL);
+
+	g_slice_free(JDistributionReplicated, distribution);
+}
+
+/**
+ * Sets the block size, the start index or the number of replicas for the replicated distribution.
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ * \param key          A key.
+ * \param value        A value.
+ */
+static void
+distribution_set(gpointer data, gchar const* key, guint64 value)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	g_return_if_fail(distribution != NULL);
+
+	if (g_strcmp0(key, "block-size") == 0)
+	{
+		distribution->block_size = value;
+	}
+	else if (g_strcmp0(key, "start-index") == 0)
+	{
+		g_return_if_fail(value < distribution->server_count);
+
+		distribution->start_index = value;
+	}
+	else if (g_strcmp0(key, "replicas") == 0)
+	{
+		g_return_if_fail(value > 0 && value <= distribution->server_count);
+
+		distribution->replica_count = value;
+	}
+}
+
+/**
+ * Serializes distribution.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution Credentials.
+ *
+ * \return A new BSON object. Should be freed with g_slice_free().
+ **/
+static void
+distribution_serialize(gpointer data, bson_t* b)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	g_return_if_fail(distribution != NULL);
+
+	bson_append_int64(b, "block_size", -1, distribution->block_size);
+	bson_append_int32(b, "start_index", -1, distribution->start_index);
+	bson_append_int32(b, "replicas", -1, distribution->replica_count);
+}
+
+/**
+ * Deserializes distribution.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution distribution.
+ * \param b           A BSON object.
+ **/
+static void
+distribution_deserialize(gpointer data, bson_t const* b)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	bson_iter_t iterator;
+
+	g_return_if_fail(distribution != NULL);
+	g_return_if_fail(b != NULL);
+
+	bson_iter_init(&iterator, b);
+
+	while (bson_iter_next(&iterator))
+	{
+		gchar const* key;
+
+		key = bson_iter_key(&iterator);
+
+		if (g_strcmp0(key, "block_size") == 0)
+		{
+			distribution->block_size = bson_iter_int64(&iterator);
+		}
+		else if (g_strcmp0(key, "start_index") == 0)
+		{
+			distribution->start_index = bson_iter_int32(&iterator);
+		}
+		else if (g_strcmp0(key, "replicas") == 0)
+		{
+			distribution->replica_count = bson_iter_int32(&iterator);
+		}
+	}
+}
+
+/**
+ * Initializes a distribution.
+ *
+ * \code
+ * JDistribution* d;
+ *
+ * j_distribution_init(d, 0, 0);
+ * \endcode
+ *
+ * \param length A length.
+ * \param offset An offset.
+ *
+ * \return A new distribution. Should be freed with j_distribution_unref().
+ **/
+static void
+distribution_reset(gpointer data, guint64 length, guint64 offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionReplicated* distribution = data;
+
+	g_return_if_fail(distribution != NULL);
+
+	distribution->length = length;
+	distribution->offset = offset;
+}
+
+void
+j_distribution_replicated_get_vtable(JDistributionVTable* vtable)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	vtable->distribution_new = distribution_new;
+	vtable->distribution_free = distribution_free;
+	vtable->distribution_set = distribution_set;
+	vtable->distribution_set2 = NULL;
+	vtable->distribution_serialize = distribution_serialize;
+	vtable->distribution_deserialize = distribution_deserialize;
+	vtable->distribution_reset = distribution_reset;
+	vtable->distribution_distribute = distribution_distribute;
+	vtable->distribution_get_replica_count = distribution_get_replica_count;
+	vtable->distribution_get_replica = distribution_get_replica;
+	vtable->distribution_get_offset = distribution_get_offset;
+}
+
+/**
+ * @}
+ **/
@@ -65,6 +65,11 @@ struct JDistributionRoundRobin
 	guint64 block_size;
 
 	guint start_index;
+
+	/**
+	 * The number of servers used, starting at start_index.
+	 */
+	guint stripe_width;
 };
 
 typedef struct JDistributionRoundRobin JDistributionRoundRobin;
@@ -101,10 +106,10 @@ distribution_distribute(gpointer data, guint* index, guint64* new_length, guint6
 	}
 
 	block = distribution->offset / distribution->block_size;
-	round = block / distribution->server_count;
+	round = block / distribution->stripe_width;
 	displacement = distribution->offset % distribution->block_size;
 
-	*index = (distribution->start_index + block) % distribution->server_count;
+	*index = (distribution->start_index + (block % distribution->stripe_width)) % distribution->server_count;
 	*new_length = MIN(distribution->length, distribution->block_size - displacement);
 	*new_offset = (round * distribution->block_size) + displacement;
 	*block_id = block;
@@ -115,6 +120,26 @@ distribution_distribute(gpointer data, guint* index, guint64* new_length, guint6
 	return TRUE;
 }
 
+static guint64
+distribution_get_offset(gpointer data, guint index, guint64 new_offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionRoundRobin* distribution = data;
+
+	guint64 block;
+	guint position;
+
+	// The server's position within the stripe
+	position = (index + distribution->server_count - distribution->start_index) % distribution->server_count;
+
+	g_return_val_if_fail(position < distribution->stripe_width, 0);
+
+	block = ((new_offset / distribution->block_size) * distribution->stripe_width) + position;
+
+	return (block * distribution->block_size) + (new_offset % distribution->block_size);
+}
+
 static gpointer
 distribution_new(guint server_count, guint64 stripe_size)
 {
@@ -127,6 +152,7 @@ distribution_new(guint server_count, guint64 stripe_size)
 	distribution->length = 0;
 	distribution->offset = 0;
 	distribution->block_size = stripe_size;
+	distribution->stripe_width = server_count;
 
 	distribution->start_index = g_random_int_range(0, distribution->server_count);
 
@@ -182,6 +208,12 @@ distribution_set(gpointer data, gchar const* key, guint64 value)
 
 		distribution->start_index = value;
 	}
+	else if (g_strcmp0(key, "stripe-width") == 0)
+	{
+		g_return_if_fail(value > 0 && value <= distribution->server_count);
+
+		distribution->stripe_width = value;
+	}
 }
 
 /**
@@ -207,6 +239,7 @@ distribution_serialize(gpointer data, bson_t* b)
 
 	bson_append_int64(b, "block_size", -1, distribution->block_size);
 	bson_append_int32(b, "start_index", -1, distribution->start_index);
+	bson_append_int32(b, "stripe_width", -1, distribution->stripe_width);
 }
 
 /**
@@ -248,6 +281,10 @@ distribution_deserialize(gpointer data, bson_t const* b)
 		{
 			distribution->start_index = bson_iter_int32(&iterator);
 		}
+		else if (g_strcmp0(key, "stripe_width") == 0)
+		{
+			distribution->stripe_width = bson_iter_int32(&iterator);
+		}
 	}
 }
 
@@ -291,6 +328,9 @@ j_distribution_round_robin_get_vtable(JDistributionVTable* vtable)
 	vtable->distribution_deserialize = distribution_deserialize;
 	vtable->distribution_reset = distribution_reset;
 	vtable->distribution_distribute = distribution_distribute;
+	vtable->distribution_get_replica_count = NULL;
+	vtable->distribution_get_replica = NULL;
+	vtable->distribution_get_offset = distribution_get_offset;
 }
 
 /**
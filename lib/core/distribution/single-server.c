@@ -289,6 +289,9 @@ j_distribution_single_server_get_vtable(JDistributionVTable* vtable)
 	vtable->distribution_deserialize = distribution_deserialize;
 	vtable->distribution_reset = distribution_reset;
 	vtable->distribution_distribute = distribution_distribute;
+	vtable->distribution_get_replica_count = NULL;
+	vtable->distribution_get_replica = NULL;
+	vtable->distribution_get_offset = NULL;
 }
 
 /**
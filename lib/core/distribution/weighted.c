@@ -132,6 +132,31 @@ distribution_distribute(gpointer data, guint* index, guint64* new_length, guint6
 	return TRUE;
 }
 
+static guint64
+distribution_get_offset(gpointer data, guint index, guint64 new_offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributionWeighted* distribution = data;
+
+	guint64 block;
+	guint64 server_block;
+	guint block_offset = 0;
+
+	g_return_val_if_fail(distribution->weights[index] > 0, 0);
+
+	// The blocks of the servers before this one come first in each round
+	for (guint i = 0; i < index; i++)
+	{
+		block_offset += distribution->weights[i];
+	}
+
+	server_block = new_offset / distribution->block_size;
+	block = ((server_block / distribution->weights[index]) * distribution->sum) + block_offset + (server_block % distribution->weights[index]);
+
+	return (block * distribution->block_size) + (new_offset % distribution->block_size);
+}
+
 static gpointer
 distribution_new(guint server_count, guint64 stripe_size)
 {
@@ -352,6 +377,9 @@ j_distribution_weighted_get_vtable(JDistributionVTable* vtable)
 	vtable->distribution_deserialize = distribution_deserialize;
 	vtable->distribution_reset = distribution_reset;
 	vtable->distribution_distribute = distribution_distribute;
+	vtable->distribution_get_replica_count = NULL;
+	vtable->distribution_get_replica = NULL;
+	vtable->distribution_get_offset = distribution_get_offset;
 }
 
 /**
@@ -25,6 +25,8 @@
 #include <glib.h>
 #include <gmodule.h>
 
+#include <string.h>
+
 #include <jbackend.h>
 
 #include <jtrace.h>
@@ -61,6 +63,64 @@ j_backend_sql_error_quark(void)
 	return g_quark_from_static_string("j-backend-sql-error-quark");
 }
 
+/**
+ * Splits a backend path into the actual path and its options.
+ *
+ * Options can be appended to the path after a question mark and are separated by ampersands.
+ *
+ * \code
+ * g_autoptr(GHashTable) options = NULL;
+ * g_autofree gchar* path = NULL;
+ *
+ * path = j_backend_path_parse("/var/storage/posix?max-open-files=1024", &options);
+ * \endcode
+ *
+ * \param path    A backend path.
+ * \param options Returns the options. Should be freed with g_hash_table_unref().
+ *
+ * \return The path without options. Should be freed with g_free().
+ **/
+gchar*
+j_backend_path_parse(gchar const* path, GHashTable** options)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_auto(GStrv) split = NULL;
+
+	g_return_val_if_fail(path != NULL, NULL);
+	g_return_val_if_fail(options != NULL, NULL);
+
+	*options = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	split = g_strsplit(path, "?", 2);
+
+	if (split[0] == NULL)
+	{
+		return g_strdup(path);
+	}
+
+	if (split[1] != NULL)
+	{
+		g_auto(GStrv) pairs = NULL;
+
+		pairs = g_strsplit(split[1], "&", 0);
+
+		for (guint i = 0; pairs[i] != NULL; i++)
+		{
+			g_auto(GStrv) pair = NULL;
+
+			if (pairs[i][0] == '\0')
+			{
+				continue;
+			}
+
+			pair = g_strsplit(pairs[i], "=", 2);
+			g_hash_table_insert(*options, g_strdup(pair[0]), g_strdup((pair[1] != NULL) ? pair[1] : ""));
+		}
+	}
+
+	return g_strdup(split[0]);
+}
+
 static GModule*
 j_backend_load(gchar const* name, JBackendComponent component, JBackendType type, JBackend** backend)
 {
@@ -461,6 +521,206 @@ j_backend_object_write(JBackend* backend, gpointer data, gconstpointer buffer, g
 	return ret;
 }
 
+gboolean
+j_backend_object_statistics(JBackend* backend, JStatistics* statistics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(statistics != NULL, FALSE);
+
+	if (backend->object.backend_statistics == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_statistics", "%p", (gpointer)statistics);
+		backend->object.backend_statistics(backend->data, statistics);
+	}
+
+	return TRUE;
+}
+
+gboolean
+j_backend_object_get_holes(JBackend* backend, gpointer data, guint64 length, guint64 offset, GArray* holes)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(holes != NULL, FALSE);
+
+	if (backend->object.backend_get_holes == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_get_holes", "%p, %" G_GUINT64_FORMAT ", %" G_GUINT64_FORMAT ", %p", data, length, offset, (gpointer)holes);
+		ret = backend->object.backend_get_holes(backend->data, data, length, offset, holes);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_object_copy(JBackend* backend, gpointer data, gpointer destination, guint64* bytes_copied)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(destination != NULL, FALSE);
+	g_return_val_if_fail(bytes_copied != NULL, FALSE);
+
+	*bytes_copied = 0;
+
+	if (backend->object.backend_copy != NULL)
+	{
+		J_TRACE("backend_copy", "%p, %p, %p", data, destination, (gpointer)bytes_copied);
+		ret = backend->object.backend_copy(backend->data, data, destination, bytes_copied);
+	}
+	else
+	{
+		g_autofree gchar* buffer = NULL;
+		gint64 modification_time;
+		guint64 size;
+		guint64 buffer_size = 1024 * 1024;
+
+		// Fall back to a buffered copy
+		ret = j_backend_object_status(backend, data, &modification_time, &size);
+
+		if (ret && size > 0)
+		{
+			buffer = g_malloc(MIN(size, buffer_size));
+		}
+
+		while (ret && *bytes_copied < size)
+		{
+			guint64 length;
+			guint64 nbytes_read = 0;
+			guint64 nbytes_written = 0;
+
+			length = MIN(size - *bytes_copied, buffer_size);
+
+			ret = j_backend_object_read(backend, data, buffer, length, *bytes_copied, &nbytes_read);
+
+			if (nbytes_read > 0)
+			{
+				ret = j_backend_object_write(backend, destination, buffer, nbytes_read, *bytes_copied, &nbytes_written) && ret;
+				*bytes_copied += nbytes_written;
+			}
+
+			if (nbytes_read < length)
+			{
+				break;
+			}
+		}
+
+		// The destination's previous data is replaced
+		if (ret && !j_backend_object_truncate(backend, destination, *bytes_copied))
+		{
+			guint64 destination_size;
+
+			// Backends that cannot truncate objects can only copy to destinations that are not larger than the source
+			ret = (j_backend_object_status(backend, destination, &modification_time, &destination_size) && destination_size <= *bytes_copied);
+		}
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_object_allocate(JBackend* backend, gpointer data, guint64 length, guint64 offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	if (backend->object.backend_allocate == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_allocate", "%p, %" G_GUINT64_FORMAT ", %" G_GUINT64_FORMAT, data, length, offset);
+		ret = backend->object.backend_allocate(backend->data, data, length, offset);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_object_truncate(JBackend* backend, gpointer data, guint64 size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	if (backend->object.backend_truncate == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_truncate", "%p, %" G_GUINT64_FORMAT, data, size);
+		ret = backend->object.backend_truncate(backend->data, data, size);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_object_read_multi(JBackend* backend, gpointer data, gpointer const* buffers, guint64 const* lengths, guint64 const* offsets, guint32 count, guint64* bytes_read)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(buffers != NULL, FALSE);
+	g_return_val_if_fail(lengths != NULL, FALSE);
+	g_return_val_if_fail(offsets != NULL, FALSE);
+	g_return_val_if_fail(bytes_read != NULL, FALSE);
+
+	if (backend->object.backend_read_multi != NULL)
+	{
+		J_TRACE("backend_read_multi", "%p, %u", data, count);
+		return backend->object.backend_read_multi(backend->data, data, buffers, lengths, offsets, count, bytes_read);
+	}
+
+	// Fall back to reading the ranges one by one
+	for (guint32 i = 0; i < count; i++)
+	{
+		bytes_read[i] = 0;
+
+		if (lengths[i] > 0)
+		{
+			ret = j_backend_object_read(backend, data, buffers[i], lengths[i], offsets[i], &(bytes_read[i])) && ret;
+		}
+	}
+
+	return ret;
+}
+
 gboolean
 j_backend_kv_init(JBackend* backend, gchar const* path)
 {
@@ -597,6 +857,165 @@ j_backend_kv_get(JBackend* backend, gpointer batch, gchar const* key, gpointer*
 	return ret;
 }
 
+gboolean
+j_backend_kv_get_borrowed(JBackend* backend, gpointer batch, gchar const* key, gconstpointer* value, guint32* value_len)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_KV, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(value_len != NULL, FALSE);
+
+	if (backend->kv.backend_get_borrowed == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_get_borrowed", "%p, %s, %p, %p", batch, key, (gpointer)value, (gpointer)value_len);
+		ret = backend->kv.backend_get_borrowed(backend->data, batch, key, value, value_len);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_kv_get_multi(JBackend* backend, gpointer batch, gchar const* const* keys, guint32 count, gconstpointer* values, guint32* value_lens)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_KV, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(keys != NULL, FALSE);
+	g_return_val_if_fail(values != NULL, FALSE);
+	g_return_val_if_fail(value_lens != NULL, FALSE);
+
+	if (backend->kv.backend_get_multi == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_get_multi", "%p, %p, %u, %p, %p", batch, (gconstpointer)keys, count, (gpointer)values, (gpointer)value_lens);
+		ret = backend->kv.backend_get_multi(backend->data, batch, keys, count, values, value_lens);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_kv_compare_and_swap(JBackend* backend, gpointer batch, gchar const* key, gconstpointer expected, guint32 expected_len, gconstpointer value, guint32 value_len, gboolean* swapped)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_KV, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(swapped != NULL, FALSE);
+
+	*swapped = FALSE;
+
+	if (backend->kv.backend_compare_and_swap == NULL)
+	{
+		g_autofree gpointer current = NULL;
+		guint32 current_len = 0;
+
+		// Not atomic, concurrent modifications of the pair might be lost
+		if (!j_backend_kv_get(backend, batch, key, &current, &current_len))
+		{
+			g_free(current);
+			current = NULL;
+		}
+
+		if (expected == NULL)
+		{
+			*swapped = (current == NULL);
+		}
+		else
+		{
+			*swapped = (current != NULL && current_len == expected_len && memcmp(current, expected, expected_len) == 0);
+		}
+
+		if (*swapped)
+		{
+			return j_backend_kv_put(backend, batch, key, value, value_len);
+		}
+
+		return TRUE;
+	}
+
+	{
+		J_TRACE("backend_compare_and_swap", "%p, %s, %p, %u, %p, %u, %p", batch, key, expected, expected_len, value, value_len, (gpointer)swapped);
+		ret = backend->kv.backend_compare_and_swap(backend->data, batch, key, expected, expected_len, value, value_len, swapped);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_kv_add(JBackend* backend, gpointer batch, gchar const* key, gint64 delta, gint64* result)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_KV, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+
+	if (backend->kv.backend_add == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_add", "%p, %s, %" G_GINT64_FORMAT ", %p", batch, key, delta, (gpointer)result);
+		ret = backend->kv.backend_add(backend->data, batch, key, delta, result);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_kv_append(JBackend* backend, gpointer batch, gchar const* key, gconstpointer value, guint32 value_len)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_KV, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+
+	if (backend->kv.backend_append == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_append", "%p, %s, %p, %u", batch, key, value, value_len);
+		ret = backend->kv.backend_append(backend->data, batch, key, value, value_len);
+	}
+
+	return ret;
+}
+
 gboolean
 j_backend_kv_get_all(JBackend* backend, gchar const* namespace, gpointer* iterator)
 {
@@ -637,6 +1056,31 @@ j_backend_kv_get_by_prefix(JBackend* backend, gchar const* namespace, gchar cons
 
 	return ret;
 }
+
+gboolean
+j_backend_kv_get_range(JBackend* backend, gchar const* namespace, gchar const* start, gchar const* end, guint32 limit, gboolean reverse, gpointer* iterator)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_KV, FALSE);
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(iterator != NULL, FALSE);
+
+	if (backend->kv.backend_get_range == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_get_range", "%s, %s, %s, %u, %d, %p", namespace, start, end, limit, reverse, (gpointer)iterator);
+		ret = backend->kv.backend_get_range(backend->data, namespace, start, end, limit, reverse, iterator);
+	}
+
+	return ret;
+}
 gboolean
 j_backend_kv_iterate(JBackend* backend, gpointer iterator, gchar const** key, gconstpointer* value, guint32* value_len)
 {
@@ -659,6 +1103,35 @@ j_backend_kv_iterate(JBackend* backend, gpointer iterator, gchar const** key, gc
 	return ret;
 }
 
+void
+j_backend_kv_iterator_free(JBackend* backend, gpointer iterator)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(backend != NULL);
+	g_return_if_fail(backend->type == J_BACKEND_TYPE_KV);
+	g_return_if_fail(iterator != NULL);
+
+	if (backend->kv.backend_iterator_free == NULL)
+	{
+		gchar const* key;
+		gconstpointer value;
+		guint32 len;
+
+		// The backend frees the iterator once the end has been reached
+		while (j_backend_kv_iterate(backend, iterator, &key, &value, &len))
+		{
+		}
+
+		return;
+	}
+
+	{
+		J_TRACE("backend_iterator_free", "%p", iterator);
+		backend->kv.backend_iterator_free(backend->data, iterator);
+	}
+}
+
 gboolean
 j_backend_db_init(JBackend* backend, gchar const* path)
 {
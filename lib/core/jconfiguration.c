@@ -23,6 +23,7 @@
 #include <julea-config.h>
 
 #include <glib.h>
+#include <gio/gio.h>
 
 #include <string.h>
 
@@ -75,6 +76,17 @@ struct JConfiguration
 		guint32 db_len;
 	} servers;
 
+	/**
+	 * The indices of the first servers running on the local host, -1 if there are none.
+	 * They are determined once, since they are needed whenever a distribution is created.
+	 */
+	struct
+	{
+		gint64 object;
+		gint64 kv;
+		gint64 db;
+	} local_servers;
+
 	/**
 	 * The object configuration.
 	 */
@@ -115,6 +127,11 @@ struct JConfiguration
 		 * The path.
 		 */
 		gchar* path;
+
+		/**
+		 * How keys are mapped to servers.
+		 */
+		JKVPlacement placement;
 	} kv;
 
 	/**
@@ -142,6 +159,11 @@ struct JConfiguration
 	guint32 max_connections;
 	guint64 stripe_size;
 
+	/**
+	 * The maximum size of objects stored inline on the servers.
+	 */
+	guint64 inline_threshold;
+
 	/**
 	 * The reference count.
 	 */
@@ -254,6 +276,81 @@ out:
 	return configuration;
 }
 
+/**
+ * Checks whether a server name refers to the local host.
+ *
+ * \private
+ *
+ * \param server A server name, optionally including a port.
+ *
+ * \return TRUE if the server is local, FALSE otherwise.
+ **/
+static gboolean
+j_configuration_is_local_server(gchar const* server)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(GSocketConnectable) address = NULL;
+	gchar const* host_name;
+	gsize short_len;
+
+	// Strip the port, if any
+	address = g_network_address_parse(server, 4711, NULL);
+
+	if (address != NULL)
+	{
+		server = g_network_address_get_hostname(G_NETWORK_ADDRESS(address));
+	}
+
+	if (g_strcmp0(server, "localhost") == 0 || g_strcmp0(server, "127.0.0.1") == 0 || g_strcmp0(server, "::1") == 0)
+	{
+		return TRUE;
+	}
+
+	host_name = g_get_host_name();
+
+	if (g_ascii_strcasecmp(server, host_name) == 0)
+	{
+		return TRUE;
+	}
+
+	// Allow the short host name to match the fully qualified one and vice versa
+	short_len = strcspn(host_name, ".");
+
+	if (strcspn(server, ".") == short_len && g_ascii_strncasecmp(server, host_name, short_len) == 0
+	    && (server[short_len] == '\0' || host_name[short_len] == '\0'))
+	{
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * Finds the first server running on the local host.
+ *
+ * \private
+ *
+ * \param servers The server names.
+ *
+ * \return The server's index, -1 if no server is local.
+ **/
+static gint64
+j_configuration_find_local_server(gchar** servers)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	for (guint32 i = 0; servers[i] != NULL; i++)
+	{
+		if (j_configuration_is_local_server(servers[i]))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
 /**
  * Creates a new configuration for the given configuration data.
  *
@@ -279,18 +376,21 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	gchar* kv_backend;
 	gchar* kv_component;
 	gchar* kv_path;
+	g_autofree gchar* kv_placement = NULL;
 	gchar* db_backend;
 	gchar* db_component;
 	gchar* db_path;
 	guint64 max_operation_size;
 	guint32 max_connections;
 	guint64 stripe_size;
+	guint64 inline_threshold;
 
 	g_return_val_if_fail(key_file != NULL, FALSE);
 
 	max_operation_size = g_key_file_get_uint64(key_file, "core", "max-operation-size", NULL);
 	max_connections = g_key_file_get_integer(key_file, "clients", "max-connections", NULL);
 	stripe_size = g_key_file_get_uint64(key_file, "clients", "stripe-size", NULL);
+	inline_threshold = g_key_file_get_uint64(key_file, "object", "inline-threshold", NULL);
 	servers_object = g_key_file_get_string_list(key_file, "servers", "object", NULL, NULL);
 	servers_kv = g_key_file_get_string_list(key_file, "servers", "kv", NULL, NULL);
 	servers_db = g_key_file_get_string_list(key_file, "servers", "db", NULL, NULL);
@@ -300,6 +400,7 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	kv_backend = g_key_file_get_string(key_file, "kv", "backend", NULL);
 	kv_component = g_key_file_get_string(key_file, "kv", "component", NULL);
 	kv_path = g_key_file_get_string(key_file, "kv", "path", NULL);
+	kv_placement = g_key_file_get_string(key_file, "kv", "placement", NULL);
 	db_backend = g_key_file_get_string(key_file, "db", "backend", NULL);
 	db_component = g_key_file_get_string(key_file, "db", "component", NULL);
 	db_path = g_key_file_get_string(key_file, "db", "path", NULL);
@@ -340,18 +441,23 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	configuration->servers.object_len = g_strv_length(servers_object);
 	configuration->servers.kv_len = g_strv_length(servers_kv);
 	configuration->servers.db_len = g_strv_length(servers_db);
+	configuration->local_servers.object = j_configuration_find_local_server(servers_object);
+	configuration->local_servers.kv = j_configuration_find_local_server(servers_kv);
+	configuration->local_servers.db = j_configuration_find_local_server(servers_db);
 	configuration->object.backend = object_backend;
 	configuration->object.component = object_component;
 	configuration->object.path = object_path;
 	configuration->kv.backend = kv_backend;
 	configuration->kv.component = kv_component;
 	configuration->kv.path = kv_path;
+	configuration->kv.placement = J_KV_PLACEMENT_MODULO;
 	configuration->db.backend = db_backend;
 	configuration->db.component = db_component;
 	configuration->db.path = db_path;
 	configuration->max_operation_size = max_operation_size;
 	configuration->max_connections = max_connections;
 	configuration->stripe_size = stripe_size;
+	configuration->inline_threshold = inline_threshold;
 	configuration->ref_count = 1;
 
 	if (configuration->max_operation_size == 0)
@@ -369,6 +475,15 @@ j_configuration_new_for_data(GKeyFile* key_file)
 		configuration->stripe_size = 4 * 1024 * 1024;
 	}
 
+	if (g_strcmp0(kv_placement, "jump") == 0)
+	{
+		configuration->kv.placement = J_KV_PLACEMENT_JUMP;
+	}
+	else if (kv_placement != NULL && g_strcmp0(kv_placement, "modulo") != 0)
+	{
+		g_warning("Unknown kv placement %s, using modulo.", kv_placement);
+	}
+
 	return configuration;
 }
 
@@ -460,6 +575,51 @@ j_configuration_get_server(JConfiguration* configuration, JBackendType backend,
 	return NULL;
 }
 
+/**
+ * Returns the index of a server running on the local host.
+ * If several servers are local, the first one is returned.
+ *
+ * \param configuration A configuration.
+ * \param backend       A backend type.
+ * \param index         Returns the server index.
+ *
+ * \return TRUE if a local server exists, FALSE otherwise.
+ **/
+gboolean
+j_configuration_get_local_server(JConfiguration* configuration, JBackendType backend, guint32* index)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gint64 local_server = -1;
+
+	g_return_val_if_fail(configuration != NULL, FALSE);
+	g_return_val_if_fail(index != NULL, FALSE);
+
+	switch (backend)
+	{
+		case J_BACKEND_TYPE_OBJECT:
+			local_server = configuration->local_servers.object;
+			break;
+		case J_BACKEND_TYPE_KV:
+			local_server = configuration->local_servers.kv;
+			break;
+		case J_BACKEND_TYPE_DB:
+			local_server = configuration->local_servers.db;
+			break;
+		default:
+			g_assert_not_reached();
+	}
+
+	if (local_server < 0)
+	{
+		return FALSE;
+	}
+
+	*index = local_server;
+
+	return TRUE;
+}
+
 guint32
 j_configuration_get_server_count(JConfiguration* configuration, JBackendType backend)
 {
@@ -578,6 +738,33 @@ j_configuration_get_stripe_size(JConfiguration* configuration)
 	return configuration->stripe_size;
 }
 
+guint64
+j_configuration_get_inline_threshold(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, 0);
+
+	return configuration->inline_threshold;
+}
+
+/**
+ * Returns how keys are mapped to kv servers.
+ *
+ * \param configuration A configuration.
+ *
+ * \return The placement.
+ **/
+JKVPlacement
+j_configuration_get_kv_placement(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, J_KV_PLACEMENT_MODULO);
+
+	return configuration->kv.placement;
+}
+
 /**
  * @}
  **/
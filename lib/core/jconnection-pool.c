@@ -47,6 +47,12 @@ struct JConnectionPoolQueue
 {
 	GAsyncQueue* queue;
 	guint count;
+
+	/**
+	 * The observed latency in microseconds as an exponentially weighted moving average.
+	 * 0 if no latency has been observed yet.
+	 */
+	gint latency;
 };
 
 typedef struct JConnectionPoolQueue JConnectionPoolQueue;
@@ -93,18 +99,21 @@ j_connection_pool_init(JConfiguration* configuration)
 	{
 		pool->object_queues[i].queue = g_async_queue_new();
 		pool->object_queues[i].count = 0;
+		pool->object_queues[i].latency = 0;
 	}
 
 	for (guint i = 0; i < pool->kv_len; i++)
 	{
 		pool->kv_queues[i].queue = g_async_queue_new();
 		pool->kv_queues[i].count = 0;
+		pool->kv_queues[i].latency = 0;
 	}
 
 	for (guint i = 0; i < pool->db_len; i++)
 	{
 		pool->db_queues[i].queue = g_async_queue_new();
 		pool->db_queues[i].count = 0;
+		pool->db_queues[i].latency = 0;
 	}
 
 	g_atomic_pointer_set(&j_connection_pool, pool);
@@ -322,6 +331,89 @@ j_connection_pool_push(JBackendType backend, guint index, gpointer connection)
 	}
 }
 
+static JConnectionPoolQueue*
+j_connection_pool_get_queue(JBackendType backend, guint index)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	switch (backend)
+	{
+		case J_BACKEND_TYPE_OBJECT:
+			g_return_val_if_fail(index < j_connection_pool->object_len, NULL);
+			return &(j_connection_pool->object_queues[index]);
+		case J_BACKEND_TYPE_KV:
+			g_return_val_if_fail(index < j_connection_pool->kv_len, NULL);
+			return &(j_connection_pool->kv_queues[index]);
+		case J_BACKEND_TYPE_DB:
+			g_return_val_if_fail(index < j_connection_pool->db_len, NULL);
+			return &(j_connection_pool->db_queues[index]);
+		default:
+			g_assert_not_reached();
+	}
+
+	return NULL;
+}
+
+/**
+ * Records the latency observed for a request to a server.
+ *
+ * \param backend A backend type.
+ * \param index   A server index.
+ * \param latency The latency in microseconds.
+ **/
+void
+j_connection_pool_add_latency(JBackendType backend, guint index, gint64 latency)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnectionPoolQueue* queue;
+	gint old_latency;
+	gint new_latency;
+
+	g_return_if_fail(j_connection_pool != NULL);
+
+	if ((queue = j_connection_pool_get_queue(backend, index)) == NULL)
+	{
+		return;
+	}
+
+	latency = CLAMP(latency, 1, G_MAXINT);
+
+	// Lost updates are acceptable since this is only an estimate
+	old_latency = g_atomic_int_get(&(queue->latency));
+	new_latency = (old_latency == 0) ? latency : (7 * (gint64)old_latency + latency) / 8;
+	g_atomic_int_set(&(queue->latency), new_latency);
+}
+
+/**
+ * Estimates the latency of the next request to a server.
+ * The observed latency is weighted by the number of connections currently in use.
+ *
+ * \param backend A backend type.
+ * \param index   A server index.
+ *
+ * \return The estimated latency in microseconds, 0 if no latency has been observed yet.
+ **/
+gint64
+j_connection_pool_get_latency(JBackendType backend, guint index)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnectionPoolQueue* queue;
+	gint busy;
+
+	g_return_val_if_fail(j_connection_pool != NULL, 0);
+
+	if ((queue = j_connection_pool_get_queue(backend, index)) == NULL)
+	{
+		return 0;
+	}
+
+	busy = g_atomic_int_get(&(queue->count)) - g_async_queue_length(queue->queue);
+
+	return (gint64)g_atomic_int_get(&(queue->latency)) * (MAX(busy, 0) + 1);
+}
+
 /**
  * @}
  **/
@@ -58,13 +58,24 @@ struct JDistribution
 	 */
 	gpointer distribution;
 
+	/**
+	 * The server count.
+	 **/
+	guint server_count;
+
+	/**
+	 * Whether the block size has been set explicitly.
+	 * Such distributions are not adapted.
+	 **/
+	gboolean block_size_set;
+
 	/**
 	 * The reference count.
 	 **/
 	guint ref_count;
 };
 
-static JDistributionVTable j_distribution_vtables[3];
+static JDistributionVTable j_distribution_vtables[6];
 
 static JDistribution*
 j_distribution_new_common(JDistributionType type, JConfiguration* configuration)
@@ -73,6 +84,7 @@ j_distribution_new_common(JDistributionType type, JConfiguration* configuration)
 
 	JDistribution* distribution;
 	guint server_count;
+	guint32 local_index;
 	guint64 stripe_size;
 
 	server_count = j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT);
@@ -81,8 +93,29 @@ j_distribution_new_common(JDistributionType type, JConfiguration* configuration)
 	distribution = g_slice_new(JDistribution);
 	distribution->type = type;
 	distribution->distribution = j_distribution_vtables[type].distribution_new(server_count, stripe_size);
+	distribution->server_count = server_count;
+	distribution->block_size_set = FALSE;
 	distribution->ref_count = 1;
 
+	/**
+	 * Place whole objects on the local server to avoid network transfers.
+	 * Replicated objects start at the local server, that is, only the first block's primary replica is local.
+	 * The following blocks are still spread across all servers to balance the load.
+	 * Otherwise, the distributions pick a random server.
+	 * The local server is only determined once per configuration.
+	 */
+	if (j_configuration_get_local_server(configuration, J_BACKEND_TYPE_OBJECT, &local_index))
+	{
+		if (type == J_DISTRIBUTION_LOCAL)
+		{
+			j_distribution_vtables[type].distribution_set(distribution->distribution, "index", local_index);
+		}
+		else if (type == J_DISTRIBUTION_REPLICATED)
+		{
+			j_distribution_vtables[type].distribution_set(distribution->distribution, "start-index", local_index);
+		}
+	}
+
 	return distribution;
 }
 
@@ -172,12 +205,60 @@ j_distribution_set_block_size(JDistribution* distribution, guint64 block_size)
 	g_return_if_fail(distribution != NULL);
 	g_return_if_fail(block_size > 0);
 
+	distribution->block_size_set = TRUE;
+
 	if (j_distribution_vtables[distribution->type].distribution_set != NULL)
 	{
 		j_distribution_vtables[distribution->type].distribution_set(distribution->distribution, "block-size", block_size);
 	}
 }
 
+/**
+ * Adapts the block size and stripe width of a distribution to the expected size of the data.
+ * Small data uses smaller blocks so that it is still spread across several servers.
+ * Large data uses larger blocks so that each server has to handle fewer extents.
+ * Data smaller than one block per server only uses as many servers as it has blocks.
+ *
+ * Distributions whose block size has been set explicitly using j_distribution_set_block_size() are not changed.
+ * Since the choice is stored in the distribution, it should not be shared with objects of a different size.
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ * \param size_hint    The expected size of the data, 0 if unknown.
+ */
+void
+j_distribution_adapt(JDistribution* distribution, guint64 size_hint)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 const min_block_size = 64 * 1024;
+	guint64 const max_block_size = 64 * 1024 * 1024;
+	guint64 const blocks_per_server = 64;
+
+	guint64 block_size;
+	guint64 stripe_width;
+
+	g_return_if_fail(distribution != NULL);
+
+	if (distribution->block_size_set || size_hint == 0 || j_distribution_vtables[distribution->type].distribution_set == NULL)
+	{
+		return;
+	}
+
+	block_size = size_hint / (distribution->server_count * blocks_per_server);
+	block_size = CLAMP(block_size, min_block_size, max_block_size);
+	// Round up to the next power of two to keep blocks aligned
+	block_size = G_GUINT64_CONSTANT(1) << g_bit_storage(block_size - 1);
+
+	stripe_width = (size_hint + block_size - 1) / block_size;
+	stripe_width = CLAMP(stripe_width, 1, distribution->server_count);
+
+	j_distribution_vtables[distribution->type].distribution_set(distribution->distribution, "block-size", block_size);
+	j_distribution_vtables[distribution->type].distribution_set(distribution->distribution, "stripe-width", stripe_width);
+}
+
 /**
  * Sets the start index for the round robin distribution.
  *
@@ -243,6 +324,10 @@ j_distribution_init(void)
 	j_distribution_round_robin_get_vtable(&(j_distribution_vtables[J_DISTRIBUTION_ROUND_ROBIN]));
 	j_distribution_single_server_get_vtable(&(j_distribution_vtables[J_DISTRIBUTION_SINGLE_SERVER]));
 	j_distribution_weighted_get_vtable(&(j_distribution_vtables[J_DISTRIBUTION_WEIGHTED]));
+	j_distribution_consistent_hash_get_vtable(&(j_distribution_vtables[J_DISTRIBUTION_CONSISTENT_HASH]));
+	j_distribution_replicated_get_vtable(&(j_distribution_vtables[J_DISTRIBUTION_REPLICATED]));
+	// The local distribution stores whole objects on a single server, it only differs in the choice of the server
+	j_distribution_single_server_get_vtable(&(j_distribution_vtables[J_DISTRIBUTION_LOCAL]));
 
 	j_distribution_check_vtables();
 }
@@ -417,6 +502,89 @@ j_distribution_distribute(JDistribution* distribution, guint* index, guint64* ne
 	return j_distribution_vtables[distribution->type].distribution_distribute(distribution->distribution, index, new_length, new_offset, block_id);
 }
 
+/**
+ * Returns the number of copies stored for each block.
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ *
+ * \return The number of replicas, 1 for distributions without replication.
+ **/
+guint
+j_distribution_get_replica_count(JDistribution* distribution)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(distribution != NULL, 1);
+
+	if (j_distribution_vtables[distribution->type].distribution_get_replica_count == NULL)
+	{
+		return 1;
+	}
+
+	return j_distribution_vtables[distribution->type].distribution_get_replica_count(distribution->distribution);
+}
+
+/**
+ * Returns where a replica of the block last returned by j_distribution_distribute() is stored.
+ * Replica 0 is the one returned by j_distribution_distribute() itself.
+ *
+ * \code
+ * \endcode
+ *
+ * \param distribution A distribution.
+ * \param replica      A replica, smaller than j_distribution_get_replica_count().
+ * \param index        A server index.
+ * \param new_offset   A new offset.
+ **/
+void
+j_distribution_get_replica(JDistribution* distribution, guint replica, guint* index, guint64* new_offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(distribution != NULL);
+	g_return_if_fail(index != NULL);
+	g_return_if_fail(new_offset != NULL);
+
+	if (j_distribution_vtables[distribution->type].distribution_get_replica == NULL)
+	{
+		g_return_if_fail(replica == 0);
+
+		// The caller already has the only replica
+		return;
+	}
+
+	j_distribution_vtables[distribution->type].distribution_get_replica(distribution->distribution, replica, index, new_offset);
+}
+
+/**
+ * Returns the object offset stored at an offset of a server.
+ * This is the inverse of j_distribution_distribute() and j_distribution_get_replica().
+ *
+ * \param distribution A distribution.
+ * \param index        A server index.
+ * \param new_offset   An offset on the server.
+ *
+ * \return The object offset.
+ **/
+guint64
+j_distribution_get_offset(JDistribution* distribution, guint index, guint64 new_offset)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(distribution != NULL, 0);
+
+	if (j_distribution_vtables[distribution->type].distribution_get_offset == NULL)
+	{
+		// Servers store the blocks at their object offsets
+		return new_offset;
+	}
+
+	return j_distribution_vtables[distribution->type].distribution_get_offset(distribution->distribution, index, new_offset);
+}
+
 /**
  * @}
  **/
@@ -28,6 +28,7 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -205,6 +206,205 @@ j_helper_hash(gchar const* str)
 	return hash;
 }
 
+/**
+ * Hashes a string using FNV-1a.
+ *
+ * In contrast to j_helper_hash(), all bits of the result are well-distributed.
+ * It can therefore be used for purposes where j_helper_hash() is already used for server selection.
+ *
+ * \param str A string.
+ *
+ * \return The hash.
+ **/
+guint32
+j_helper_hash_fnv1a(gchar const* str)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guchar c;
+	guint32 hash;
+
+	hash = 2166136261U;
+
+	while ((c = *str++) != '\0')
+	{
+		hash ^= c;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/**
+ * Reads up to eight bytes in little-endian order.
+ *
+ * \private
+ **/
+static inline guint64
+j_helper_read_le(guchar const* p, gsize len)
+{
+	guint64 value = 0;
+
+	memcpy(&value, p, len);
+
+	return GUINT64_FROM_LE(value);
+}
+
+/**
+ * Multiplies two 64-bit values and folds the 128-bit result.
+ *
+ * \private
+ **/
+static inline void
+j_helper_mum(guint64* a, guint64* b)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 r = (unsigned __int128)*a * *b;
+
+	*a = (guint64)r;
+	*b = (guint64)(r >> 64);
+#else
+	guint64 ha = *a >> 32;
+	guint64 hb = *b >> 32;
+	guint64 la = (guint32)*a;
+	guint64 lb = (guint32)*b;
+	guint64 rh = ha * hb;
+	guint64 rm0 = ha * lb;
+	guint64 rm1 = hb * la;
+	guint64 rl = la * lb;
+	guint64 t = rl + (rm0 << 32);
+	guint64 c = (t < rl);
+	guint64 lo = t + (rm1 << 32);
+
+	c += (lo < t);
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline guint64
+j_helper_mix(guint64 a, guint64 b)
+{
+	j_helper_mum(&a, &b);
+
+	return a ^ b;
+}
+
+/**
+ * Hashes a string using wyhash.
+ *
+ * In contrast to j_helper_hash() and j_helper_hash_fnv1a(), the string is processed eight bytes at a time.
+ * This makes it considerably faster for long strings.
+ *
+ * \param str A string.
+ *
+ * \return The hash.
+ **/
+guint64
+j_helper_hash_wyhash(gchar const* str)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 const secret[] = {
+		G_GUINT64_CONSTANT(0xa0761d6478bd642f),
+		G_GUINT64_CONSTANT(0xe7037ed1a0b428db),
+		G_GUINT64_CONSTANT(0x8ebc6af09c88c6e3),
+		G_GUINT64_CONSTANT(0x589965cc75374cc3)
+	};
+
+	guchar const* p = (guchar const*)str;
+	gsize len;
+	guint64 seed;
+	guint64 a;
+	guint64 b;
+
+	len = strlen(str);
+	seed = j_helper_mix(secret[0], secret[1]);
+
+	if (len <= 16)
+	{
+		if (len >= 4)
+		{
+			a = (j_helper_read_le(p, 4) << 32) | j_helper_read_le(p + ((len >> 3) << 2), 4);
+			b = (j_helper_read_le(p + len - 4, 4) << 32) | j_helper_read_le(p + len - 4 - ((len >> 3) << 2), 4);
+		}
+		else if (len > 0)
+		{
+			a = ((guint64)p[0] << 16) | ((guint64)p[len >> 1] << 8) | p[len - 1];
+			b = 0;
+		}
+		else
+		{
+			a = 0;
+			b = 0;
+		}
+	}
+	else
+	{
+		gsize i = len;
+
+		if (i > 48)
+		{
+			guint64 see1 = seed;
+			guint64 see2 = seed;
+
+			do
+			{
+				seed = j_helper_mix(j_helper_read_le(p, 8) ^ secret[1], j_helper_read_le(p + 8, 8) ^ seed);
+				see1 = j_helper_mix(j_helper_read_le(p + 16, 8) ^ secret[2], j_helper_read_le(p + 24, 8) ^ see1);
+				see2 = j_helper_mix(j_helper_read_le(p + 32, 8) ^ secret[3], j_helper_read_le(p + 40, 8) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+
+			seed ^= see1 ^ see2;
+		}
+
+		while (i > 16)
+		{
+			seed = j_helper_mix(j_helper_read_le(p, 8) ^ secret[1], j_helper_read_le(p + 8, 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+
+		a = j_helper_read_le(p + i - 16, 8);
+		b = j_helper_read_le(p + i - 8, 8);
+	}
+
+	a ^= secret[1];
+	b ^= seed;
+	j_helper_mum(&a, &b);
+
+	return j_helper_mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+/**
+ * Maps a key to one of the buckets using jump consistent hashing.
+ * When the number of buckets grows from n to n + 1, only about 1/(n + 1) of the keys move and all of them move to the new bucket.
+ *
+ * \param key     A key, which should be well-distributed (for instance, a hash).
+ * \param buckets The number of buckets.
+ *
+ * \return The bucket.
+ **/
+guint32
+j_helper_jump_hash(guint64 key, guint32 buckets)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gint64 b = -1;
+	gint64 j = 0;
+
+	while (j < buckets)
+	{
+		b = j;
+		key = key * G_GUINT64_CONSTANT(2862933555777941757) + 1;
+		j = (b + 1) * ((gdouble)(G_GINT64_CONSTANT(1) << 31) / (gdouble)((key >> 33) + 1));
+	}
+
+	return b;
+}
+
 gpointer
 j_helper_alloc_aligned(gsize align, gsize len)
 {
@@ -82,6 +82,21 @@ struct JStatistics
 	 * The number of sent bytes.
 	 **/
 	guint64 bytes_sent;
+
+	/**
+	 * The number of file cache hits.
+	 **/
+	guint64 file_cache_hits;
+
+	/**
+	 * The number of file cache misses.
+	 **/
+	guint64 file_cache_misses;
+
+	/**
+	 * The number of file cache evictions.
+	 **/
+	guint64 file_cache_evictions;
 };
 
 static gchar const*
@@ -107,6 +122,12 @@ j_statistics_get_type_name(JStatisticsType type)
 			return "bytes_received";
 		case J_STATISTICS_BYTES_SENT:
 			return "bytes_sent";
+		case J_STATISTICS_FILE_CACHE_HITS:
+			return "file_cache_hits";
+		case J_STATISTICS_FILE_CACHE_MISSES:
+			return "file_cache_misses";
+		case J_STATISTICS_FILE_CACHE_EVICTIONS:
+			return "file_cache_evictions";
 		default:
 			g_warn_if_reached();
 			return NULL;
@@ -143,6 +164,9 @@ j_statistics_new(gboolean trace)
 	statistics->bytes_written = 0;
 	statistics->bytes_received = 0;
 	statistics->bytes_sent = 0;
+	statistics->file_cache_hits = 0;
+	statistics->file_cache_misses = 0;
+	statistics->file_cache_evictions = 0;
 
 	return statistics;
 }
@@ -202,6 +226,15 @@ j_statistics_get(JStatistics* statistics, JStatisticsType type)
 		case J_STATISTICS_BYTES_SENT:
 			value = statistics->bytes_sent;
 			break;
+		case J_STATISTICS_FILE_CACHE_HITS:
+			value = statistics->file_cache_hits;
+			break;
+		case J_STATISTICS_FILE_CACHE_MISSES:
+			value = statistics->file_cache_misses;
+			break;
+		case J_STATISTICS_FILE_CACHE_EVICTIONS:
+			value = statistics->file_cache_evictions;
+			break;
 		default:
 			g_warn_if_reached();
 			break;
@@ -243,6 +276,15 @@ j_statistics_add(JStatistics* statistics, JStatisticsType type, guint64 value)
 		case J_STATISTICS_BYTES_SENT:
 			statistics->bytes_sent += value;
 			break;
+		case J_STATISTICS_FILE_CACHE_HITS:
+			statistics->file_cache_hits += value;
+			break;
+		case J_STATISTICS_FILE_CACHE_MISSES:
+			statistics->file_cache_misses += value;
+			break;
+		case J_STATISTICS_FILE_CACHE_EVICTIONS:
+			statistics->file_cache_evictions += value;
+			break;
 		default:
 			g_warn_if_reached();
 			break;
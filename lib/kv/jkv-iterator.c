@@ -24,6 +24,8 @@
 
 #include <glib.h>
 
+#include <string.h>
+
 #include <kv/jkv-iterator.h>
 
 #include <kv/jkv.h>
@@ -39,6 +41,94 @@
  * @{
  **/
 
+/**
+ * The number of key-value pairs requested per page.
+ **/
+#define J_KV_ITERATOR_PAGE_SIZE 1000
+
+struct JKVIteratorEntry
+{
+	gchar const* key;
+	gconstpointer value;
+	guint32 len;
+};
+
+typedef struct JKVIteratorEntry JKVIteratorEntry;
+
+/**
+ * A page of key-value pairs received from a server.
+ **/
+struct JKVIteratorPage
+{
+	/**
+	 * The server index.
+	 **/
+	guint32 index;
+
+	/**
+	 * The reply, which owns the keys and values.
+	 **/
+	JMessage* reply;
+
+	/**
+	 * The pairs contained in the reply.
+	 **/
+	GArray* entries;
+
+	/**
+	 * The cursor to request the next page with, 0 if the server has no more pairs.
+	 **/
+	guint64 cursor;
+
+	/**
+	 * Whether the page could not be fetched or the server aborted the iteration.
+	 **/
+	gboolean failed;
+};
+
+typedef struct JKVIteratorPage JKVIteratorPage;
+
+/**
+ * A request for a page.
+ * If cursor is 0, the first page is requested.
+ **/
+struct JKVIteratorFetch
+{
+	JKVIterator const* iterator;
+	guint32 index;
+	guint64 cursor;
+};
+
+typedef struct JKVIteratorFetch JKVIteratorFetch;
+
+/**
+ * The pairs of a single server.
+ **/
+struct JKVIteratorStream
+{
+	/**
+	 * The server index.
+	 **/
+	guint32 index;
+
+	/**
+	 * The page currently being consumed, NULL before the first page has been received.
+	 **/
+	JKVIteratorPage* page;
+
+	/**
+	 * The position of the next pair within the page.
+	 **/
+	guint position;
+
+	/**
+	 * The request for the following page, if any.
+	 **/
+	JBackgroundOperation* prefetch;
+};
+
+typedef struct JKVIteratorStream JKVIteratorStream;
+
 struct JKVIterator
 {
 	JBackend* kv_backend;
@@ -59,119 +149,358 @@ struct JKVIterator
 	gconstpointer value;
 	guint32 len;
 
-	JMessage** replies;
-	guint32 replies_n;
-	guint32 replies_cur;
+	gchar* namespace;
+	gchar* prefix;
+
+	/**
+	 * Whether a range of keys is requested.
+	 * The range is only valid in this case.
+	 **/
+	gboolean range;
+
+	struct
+	{
+		gchar* start;
+		gchar* end;
+		guint32 limit;
+		gboolean reverse;
+	} range_spec;
+
+	/**
+	 * The number of pairs returned so far.
+	 **/
+	guint32 returned;
+
+	/**
+	 * One stream per server.
+	 **/
+	JKVIteratorStream* streams;
+	guint32 streams_n;
+
+	/**
+	 * Whether pairs are returned in key order.
+	 **/
+	gboolean ordered;
+
+	/**
+	 * The stream currently being consumed if pairs are not ordered.
+	 **/
+	guint32 streams_cur;
+
+	/**
+	 * A min-heap of the streams that still have pairs, ordered by their next key.
+	 * The heap is built on the first call to j_kv_iterator_next().
+	 **/
+	JKVIteratorStream** heap;
+	guint32 heap_n;
+	gboolean heap_built;
+
+	/**
+	 * Whether the iteration has been aborted because of an error.
+	 **/
+	gboolean failed;
 };
 
-static JMessage*
-fetch_reply(guint32 index, gchar const* namespace, gchar const* prefix)
+static void
+j_kv_iterator_page_free(JKVIteratorPage* page)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	j_message_unref(page->reply);
+	g_array_unref(page->entries);
+
+	g_slice_free(JKVIteratorPage, page);
+}
+
+/**
+ * Fetches a page from a server.
+ * The page is parsed right away to find the cursor at its end.
+ **/
+static gpointer
+j_kv_iterator_fetch(gpointer data)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	JKVIteratorFetch* fetch = data;
+	JKVIterator const* iterator = fetch->iterator;
+
 	g_autoptr(JMessage) message = NULL;
-	JMessage* reply;
-	JMessageType message_type;
+	JKVIteratorPage* page;
 	gpointer kv_connection;
-	gsize namespace_len;
-	gsize prefix_len;
+	guint32 page_size = J_KV_ITERATOR_PAGE_SIZE;
 
-	namespace_len = strlen(namespace) + 1;
+	if (iterator->range && iterator->range_spec.limit > 0)
+	{
+		// No server has to return more than the limit
+		page_size = MIN(page_size, iterator->range_spec.limit);
+	}
 
-	if (prefix == NULL)
+	if (fetch->cursor != 0)
 	{
-		message_type = J_MESSAGE_KV_GET_ALL;
-		prefix_len = 0;
+		message = j_message_new(J_MESSAGE_KV_ITERATE, 8 + 4);
+		j_message_append_8(message, &(fetch->cursor));
 	}
-	else
+	else if (iterator->range)
 	{
-		message_type = J_MESSAGE_KV_GET_BY_PREFIX;
-		prefix_len = strlen(prefix) + 1;
+		gchar const* start;
+		gchar const* end;
+		gsize namespace_len;
+		gsize start_len;
+		gsize end_len;
+		gchar reverse;
+
+		// Unbounded ranges are denoted by empty strings
+		start = (iterator->range_spec.start != NULL) ? iterator->range_spec.start : "";
+		end = (iterator->range_spec.end != NULL) ? iterator->range_spec.end : "";
+		reverse = (iterator->range_spec.reverse) ? 1 : 0;
+
+		namespace_len = strlen(iterator->namespace) + 1;
+		start_len = strlen(start) + 1;
+		end_len = strlen(end) + 1;
+
+		message = j_message_new(J_MESSAGE_KV_GET_RANGE, namespace_len + start_len + end_len + 4 + 1 + 4);
+		j_message_append_n(message, iterator->namespace, namespace_len);
+		j_message_append_n(message, start, start_len);
+		j_message_append_n(message, end, end_len);
+		j_message_append_4(message, &(iterator->range_spec.limit));
+		j_message_append_1(message, &reverse);
 	}
+	else
+	{
+		gsize namespace_len;
+		gsize prefix_len;
 
-	message = j_message_new(message_type, namespace_len + prefix_len);
-	j_message_append_n(message, namespace, namespace_len);
+		namespace_len = strlen(iterator->namespace) + 1;
+		prefix_len = (iterator->prefix != NULL) ? strlen(iterator->prefix) + 1 : 0;
 
-	if (prefix != NULL)
-	{
-		j_message_append_n(message, prefix, prefix_len);
+		message = j_message_new((iterator->prefix == NULL) ? J_MESSAGE_KV_GET_ALL : J_MESSAGE_KV_GET_BY_PREFIX, namespace_len + prefix_len + 4);
+		j_message_append_n(message, iterator->namespace, namespace_len);
+
+		if (iterator->prefix != NULL)
+		{
+			j_message_append_n(message, iterator->prefix, prefix_len);
+		}
 	}
 
-	kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, index);
+	j_message_append_4(message, &page_size);
+
+	page = g_slice_new(JKVIteratorPage);
+	page->index = fetch->index;
+	page->entries = g_array_sized_new(FALSE, FALSE, sizeof(JKVIteratorEntry), J_KV_ITERATOR_PAGE_SIZE);
+	page->cursor = 0;
+	page->failed = TRUE;
+
+	// The connection is only held while fetching, abandoned iterators must not exhaust the pool
+	kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, fetch->index);
 	j_message_send(message, kv_connection);
 
-	reply = j_message_new_reply(message);
-	j_message_receive(reply, kv_connection);
+	page->reply = j_message_new_reply(message);
+
+	if (j_message_receive(page->reply, kv_connection))
+	{
+		while (TRUE)
+		{
+			JKVIteratorEntry entry;
+
+			entry.len = j_message_get_4(page->reply);
 
-	j_connection_pool_push(J_BACKEND_TYPE_KV, index, kv_connection);
+			if (entry.len == 0)
+			{
+				break;
+			}
+
+			entry.value = j_message_get_n(page->reply, entry.len);
+			entry.key = j_message_get_string(page->reply);
+
+			g_array_append_val(page->entries, entry);
+		}
+
+		page->cursor = j_message_get_8(page->reply);
+		page->failed = (j_message_get_1(page->reply) != 0);
+	}
 
-	return reply;
+	j_connection_pool_push(J_BACKEND_TYPE_KV, fetch->index, kv_connection);
+
+	g_slice_free(JKVIteratorFetch, fetch);
+
+	return page;
 }
 
 /**
- * Creates a new JKVIterator.
- *
- * \param store A JStore.
- *
- * \return A new JKVIterator.
+ * Requests a stream's next page in the background.
+ * This is the first page if nothing has been received yet.
  **/
-JKVIterator*
-j_kv_iterator_new(gchar const* namespace, gchar const* prefix)
+static void
+j_kv_iterator_prefetch(JKVIterator* iterator, JKVIteratorStream* stream)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JKVIterator* iterator;
+	JKVIteratorFetch* fetch;
 
-	JConfiguration* configuration = j_configuration();
+	g_return_if_fail(stream->prefetch == NULL);
 
-	g_return_val_if_fail(namespace != NULL, NULL);
+	if (stream->page != NULL && stream->page->cursor == 0)
+	{
+		return;
+	}
 
-	/* FIXME still necessary? */
-	//j_operation_cache_flush();
+	fetch = g_slice_new(JKVIteratorFetch);
+	fetch->index = stream->index;
+	fetch->iterator = iterator;
+	fetch->cursor = (stream->page != NULL) ? stream->page->cursor : 0;
 
-	iterator = g_slice_new(JKVIterator);
-	iterator->kv_backend = j_kv_get_backend();
-	iterator->cursor = NULL;
-	iterator->key = NULL;
-	iterator->value = NULL;
-	iterator->len = 0;
-	iterator->replies_n = j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV);
-	iterator->replies = g_new0(JMessage*, iterator->replies_n);
-	iterator->replies_cur = 0;
+	stream->prefetch = j_background_operation_new(j_kv_iterator_fetch, fetch);
+}
 
-	if (iterator->kv_backend != NULL)
+/**
+ * Returns a stream's next pair without consuming it.
+ * Waits for the next page if the current one has been consumed.
+ *
+ * \return The pair, NULL if the stream has no more pairs.
+ **/
+static JKVIteratorEntry*
+j_kv_iterator_peek(JKVIterator* iterator, JKVIteratorStream* stream)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	while (stream->page == NULL || stream->position >= stream->page->entries->len)
 	{
-		if (prefix == NULL)
+		if (stream->prefetch == NULL)
 		{
-			j_backend_kv_get_all(iterator->kv_backend, namespace, &(iterator->cursor));
+			return NULL;
 		}
-		else
+
+		if (stream->page != NULL)
 		{
-			j_backend_kv_get_by_prefix(iterator->kv_backend, namespace, prefix, &(iterator->cursor));
+			j_kv_iterator_page_free(stream->page);
 		}
+
+		stream->page = j_background_operation_wait(stream->prefetch);
+		stream->position = 0;
+
+		j_background_operation_unref(stream->prefetch);
+		stream->prefetch = NULL;
+
+		if (stream->page->failed)
+		{
+			// The pairs returned so far are incomplete, do not continue with the other streams
+			iterator->failed = TRUE;
+			return NULL;
+		}
+
+		// Fetch the following page while the application consumes this one
+		j_kv_iterator_prefetch(iterator, stream);
 	}
-	else
+
+	return &g_array_index(stream->page->entries, JKVIteratorEntry, stream->position);
+}
+
+static gint
+j_kv_iterator_heap_compare(JKVIterator* iterator, guint32 a, guint32 b)
+{
+	JKVIteratorEntry* entry_a;
+	JKVIteratorEntry* entry_b;
+
+	// The streams in the heap always have a pair available
+	entry_a = j_kv_iterator_peek(iterator, iterator->heap[a]);
+	entry_b = j_kv_iterator_peek(iterator, iterator->heap[b]);
+
+	if (iterator->range && iterator->range_spec.reverse)
 	{
-		for (guint32 i = 0; i < iterator->replies_n; i++)
+		return strcmp(entry_b->key, entry_a->key);
+	}
+
+	return strcmp(entry_a->key, entry_b->key);
+}
+
+static void
+j_kv_iterator_heap_swap(JKVIterator* iterator, guint32 a, guint32 b)
+{
+	JKVIteratorStream* tmp;
+
+	tmp = iterator->heap[a];
+	iterator->heap[a] = iterator->heap[b];
+	iterator->heap[b] = tmp;
+}
+
+static void
+j_kv_iterator_heap_push(JKVIterator* iterator, JKVIteratorStream* stream)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 i;
+
+	i = iterator->heap_n;
+	iterator->heap[iterator->heap_n++] = stream;
+
+	while (i > 0 && j_kv_iterator_heap_compare(iterator, i, (i - 1) / 2) < 0)
+	{
+		j_kv_iterator_heap_swap(iterator, i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+}
+
+static void
+j_kv_iterator_heap_sift_down(JKVIterator* iterator)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 i = 0;
+
+	while (TRUE)
+	{
+		guint32 smallest = i;
+		guint32 left = 2 * i + 1;
+		guint32 right = 2 * i + 2;
+
+		if (left < iterator->heap_n && j_kv_iterator_heap_compare(iterator, left, smallest) < 0)
 		{
-			iterator->replies[i] = fetch_reply(i, namespace, prefix);
+			smallest = left;
 		}
-	}
 
-	return iterator;
+		if (right < iterator->heap_n && j_kv_iterator_heap_compare(iterator, right, smallest) < 0)
+		{
+			smallest = right;
+		}
+
+		if (smallest == i)
+		{
+			break;
+		}
+
+		j_kv_iterator_heap_swap(iterator, i, smallest);
+		i = smallest;
+	}
 }
 
-JKVIterator*
-j_kv_iterator_new_for_index(guint32 index, gchar const* namespace, gchar const* prefix)
+/**
+ * Closes a page's cursor on the server.
+ * The server does not reply.
+ **/
+static void
+j_kv_iterator_close(JKVIteratorPage* page)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JKVIterator* iterator;
+	g_autoptr(JMessage) message = NULL;
+	gpointer kv_connection;
+	guint32 const zero = 0;
 
-	JConfiguration* configuration = j_configuration();
+	message = j_message_new(J_MESSAGE_KV_ITERATE, 8 + 4);
+	j_message_append_8(message, &(page->cursor));
+	j_message_append_4(message, &zero);
 
-	g_return_val_if_fail(namespace != NULL, NULL);
-	g_return_val_if_fail(index < j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV), NULL);
+	kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, page->index);
+	j_message_send(message, kv_connection);
+	j_connection_pool_push(J_BACKEND_TYPE_KV, page->index, kv_connection);
+}
+
+static JKVIterator*
+j_kv_iterator_new_common(guint32 index_first, guint32 index_last, gchar const* namespace, gchar const* prefix, gboolean ordered)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVIterator* iterator;
 
 	/* FIXME still necessary? */
 	//j_operation_cache_flush();
@@ -182,31 +511,183 @@ j_kv_iterator_new_for_index(guint32 index, gchar const* namespace, gchar const*
 	iterator->key = NULL;
 	iterator->value = NULL;
 	iterator->len = 0;
-	iterator->replies_n = 1;
-	iterator->replies = g_new0(JMessage*, 1);
-	iterator->replies_cur = 0;
+	iterator->namespace = g_strdup(namespace);
+	iterator->prefix = g_strdup(prefix);
+	iterator->range = FALSE;
+	iterator->range_spec.start = NULL;
+	iterator->range_spec.end = NULL;
+	iterator->range_spec.limit = 0;
+	iterator->range_spec.reverse = FALSE;
+	iterator->returned = 0;
+	iterator->streams = NULL;
+	iterator->streams_n = 0;
+	iterator->ordered = ordered;
+	iterator->streams_cur = 0;
+	iterator->heap = NULL;
+	iterator->heap_n = 0;
+	iterator->heap_built = FALSE;
+	iterator->failed = FALSE;
+
+	if (iterator->kv_backend == NULL)
+	{
+		iterator->streams_n = index_last - index_first + 1;
+		iterator->streams = g_new(JKVIteratorStream, iterator->streams_n);
+		iterator->heap = g_new(JKVIteratorStream*, iterator->streams_n);
+
+		for (guint32 i = 0; i < iterator->streams_n; i++)
+		{
+			JKVIteratorStream* stream = &(iterator->streams[i]);
+
+			stream->index = index_first + i;
+			stream->page = NULL;
+			stream->position = 0;
+			stream->prefetch = NULL;
+		}
+	}
+
+	return iterator;
+}
+
+/**
+ * Starts an iterator created by j_kv_iterator_new_common().
+ **/
+static JKVIterator*
+j_kv_iterator_start(JKVIterator* iterator)
+{
+	J_TRACE_FUNCTION(NULL);
 
 	if (iterator->kv_backend != NULL)
 	{
-		if (prefix == NULL)
+		gboolean ret;
+
+		if (iterator->range)
+		{
+			ret = j_backend_kv_get_range(iterator->kv_backend, iterator->namespace, iterator->range_spec.start, iterator->range_spec.end, iterator->range_spec.limit, iterator->range_spec.reverse, &(iterator->cursor));
+		}
+		else if (iterator->prefix == NULL)
 		{
-			j_backend_kv_get_all(iterator->kv_backend, namespace, &(iterator->cursor));
+			ret = j_backend_kv_get_all(iterator->kv_backend, iterator->namespace, &(iterator->cursor));
 		}
 		else
 		{
-			j_backend_kv_get_by_prefix(iterator->kv_backend, namespace, prefix, &(iterator->cursor));
+			ret = j_backend_kv_get_by_prefix(iterator->kv_backend, iterator->namespace, iterator->prefix, &(iterator->cursor));
+		}
+
+		if (!ret)
+		{
+			iterator->cursor = NULL;
+			iterator->failed = TRUE;
 		}
 	}
 	else
 	{
-		iterator->replies[0] = fetch_reply(index, namespace, prefix);
+		// Request the first page from all servers at once, so that listing takes a single round trip
+		for (guint32 i = 0; i < iterator->streams_n; i++)
+		{
+			j_kv_iterator_prefetch(iterator, &(iterator->streams[i]));
+		}
 	}
 
 	return iterator;
 }
 
+/**
+ * Creates a new JKVIterator.
+ * The servers' key-value pairs are fetched page by page while iterating.
+ *
+ * \param namespace A namespace.
+ * \param prefix    A key prefix, NULL to iterate over the whole namespace.
+ *
+ * \return A new JKVIterator.
+ **/
+JKVIterator*
+j_kv_iterator_new(gchar const* namespace, gchar const* prefix)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConfiguration* configuration = j_configuration();
+
+	g_return_val_if_fail(namespace != NULL, NULL);
+
+	return j_kv_iterator_start(j_kv_iterator_new_common(0, j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV) - 1, namespace, prefix, FALSE));
+}
+
+/**
+ * Creates a new JKVIterator that returns the pairs of all servers in key order.
+ * The servers' sorted pairs are merged while iterating.
+ * This is slightly more expensive than j_kv_iterator_new() and should only be used if the order is relevant.
+ *
+ * \param namespace A namespace.
+ * \param prefix    A key prefix, NULL to iterate over the whole namespace.
+ *
+ * \return A new JKVIterator.
+ **/
+JKVIterator*
+j_kv_iterator_new_ordered(gchar const* namespace, gchar const* prefix)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConfiguration* configuration = j_configuration();
+
+	g_return_val_if_fail(namespace != NULL, NULL);
+
+	return j_kv_iterator_start(j_kv_iterator_new_common(0, j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV) - 1, namespace, prefix, TRUE));
+}
+
+/**
+ * Creates a new JKVIterator over a range of keys.
+ * The pairs of all servers are returned in key order.
+ * Each server only reads the requested range instead of the whole namespace.
+ *
+ * \code
+ * // The ten most recent entries of a log with keys sorted by time
+ * iterator = j_kv_iterator_new_range("log", NULL, NULL, 10, TRUE);
+ * \endcode
+ *
+ * \param namespace A namespace.
+ * \param start     The first key (inclusive), NULL to start at the beginning of the namespace.
+ * \param end       The last key (exclusive), NULL to continue until the end of the namespace.
+ * \param limit     The maximum number of pairs, 0 for no limit.
+ * \param reverse   Whether to return the pairs in descending key order.
+ *
+ * \return A new JKVIterator.
+ **/
+JKVIterator*
+j_kv_iterator_new_range(gchar const* namespace, gchar const* start, gchar const* end, guint32 limit, gboolean reverse)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConfiguration* configuration = j_configuration();
+	JKVIterator* iterator;
+
+	g_return_val_if_fail(namespace != NULL, NULL);
+
+	iterator = j_kv_iterator_new_common(0, j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV) - 1, namespace, NULL, TRUE);
+	iterator->range = TRUE;
+	iterator->range_spec.start = g_strdup(start);
+	iterator->range_spec.end = g_strdup(end);
+	iterator->range_spec.limit = limit;
+	iterator->range_spec.reverse = reverse;
+
+	return j_kv_iterator_start(iterator);
+}
+
+JKVIterator*
+j_kv_iterator_new_for_index(guint32 index, gchar const* namespace, gchar const* prefix)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConfiguration* configuration = j_configuration();
+
+	g_return_val_if_fail(namespace != NULL, NULL);
+	g_return_val_if_fail(index < j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV), NULL);
+
+	return j_kv_iterator_start(j_kv_iterator_new_common(index, index, namespace, prefix, FALSE));
+}
+
 /**
  * Frees the memory allocated by the JKVIterator.
+ * Cursors of iterations that have not been finished are closed.
  *
  * \param iterator A JKVIterator.
  **/
@@ -217,62 +698,184 @@ j_kv_iterator_free(JKVIterator* iterator)
 
 	g_return_if_fail(iterator != NULL);
 
-	for (guint32 i = 0; i < iterator->replies_n; i++)
+	if (iterator->cursor != NULL)
 	{
-		if (iterator->replies[i] != NULL)
+		j_backend_kv_iterator_free(iterator->kv_backend, iterator->cursor);
+	}
+
+	for (guint32 i = 0; i < iterator->streams_n; i++)
+	{
+		JKVIteratorStream* stream = &(iterator->streams[i]);
+
+		/**
+		 * Only the prefetched page can have an open cursor.
+		 * If the current page had one, its next page would have been prefetched.
+		 */
+		if (stream->prefetch != NULL)
+		{
+			JKVIteratorPage* page;
+
+			page = j_background_operation_wait(stream->prefetch);
+			j_background_operation_unref(stream->prefetch);
+
+			if (page->cursor != 0)
+			{
+				j_kv_iterator_close(page);
+			}
+
+			j_kv_iterator_page_free(page);
+		}
+
+		if (stream->page != NULL)
 		{
-			j_message_unref(iterator->replies[i]);
+			j_kv_iterator_page_free(stream->page);
 		}
 	}
 
-	g_free(iterator->replies);
+	g_free(iterator->streams);
+	g_free(iterator->heap);
+	g_free(iterator->namespace);
+	g_free(iterator->prefix);
+	g_free(iterator->range_spec.start);
+	g_free(iterator->range_spec.end);
 
 	g_slice_free(JKVIterator, iterator);
 }
 
 /**
  * Checks whether another collection is available.
+ * The key and value of the previous pair become invalid.
  *
  * \code
  * \endcode
  *
  * \param iterator A store iterator.
  *
- * \return TRUE on success, FALSE if the end of the store is reached.
+ * \return TRUE on success, FALSE if the end of the store is reached or an error occurred (see j_kv_iterator_failed()).
  **/
 gboolean
 j_kv_iterator_next(JKVIterator* iterator)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	gboolean ret = FALSE;
+	JKVIteratorEntry* entry = NULL;
 
 	g_return_val_if_fail(iterator != NULL, FALSE);
 
+	if (iterator->failed)
+	{
+		return FALSE;
+	}
+
 	if (iterator->kv_backend != NULL)
 	{
-		ret = j_backend_kv_iterate(iterator->kv_backend, iterator->cursor, &(iterator->key), &(iterator->value), &(iterator->len));
+		if (iterator->cursor == NULL)
+		{
+			return FALSE;
+		}
+
+		if (!j_backend_kv_iterate(iterator->kv_backend, iterator->cursor, &(iterator->key), &(iterator->value), &(iterator->len)))
+		{
+			// The backend has freed the iterator
+			iterator->cursor = NULL;
+			return FALSE;
+		}
+
+		return TRUE;
 	}
-	else
+
+	// Every server returns up to the limit, stop once the merged pairs reach it
+	if (iterator->range && iterator->range_spec.limit > 0 && iterator->returned >= iterator->range_spec.limit)
 	{
-	retry:
-		iterator->len = j_message_get_4(iterator->replies[iterator->replies_cur]);
+		return FALSE;
+	}
+
+	if (iterator->ordered)
+	{
+		if (!iterator->heap_built)
+		{
+			for (guint32 i = 0; i < iterator->streams_n; i++)
+			{
+				if (j_kv_iterator_peek(iterator, &(iterator->streams[i])) != NULL)
+				{
+					j_kv_iterator_heap_push(iterator, &(iterator->streams[i]));
+				}
+			}
+
+			iterator->heap_built = TRUE;
+		}
+		else if (iterator->heap_n > 0)
+		{
+			// The previous pair has been returned from the top stream but not consumed, to keep it valid until now
+			iterator->heap[0]->position++;
+
+			if (j_kv_iterator_peek(iterator, iterator->heap[0]) == NULL)
+			{
+				iterator->heap[0] = iterator->heap[--iterator->heap_n];
+			}
+
+			j_kv_iterator_heap_sift_down(iterator);
+		}
+
+		if (iterator->heap_n == 0 || iterator->failed)
+		{
+			return FALSE;
+		}
 
-		if (iterator->len > 0)
+		entry = j_kv_iterator_peek(iterator, iterator->heap[0]);
+	}
+	else
+	{
+		while (iterator->streams_cur < iterator->streams_n)
 		{
-			iterator->value = j_message_get_n(iterator->replies[iterator->replies_cur], iterator->len);
-			iterator->key = j_message_get_string(iterator->replies[iterator->replies_cur]);
+			JKVIteratorStream* stream = &(iterator->streams[iterator->streams_cur]);
+
+			entry = j_kv_iterator_peek(iterator, stream);
+
+			if (iterator->failed)
+			{
+				return FALSE;
+			}
+
+			if (entry != NULL)
+			{
+				stream->position++;
+				break;
+			}
 
-			ret = TRUE;
+			iterator->streams_cur++;
 		}
-		else if (iterator->replies_cur < iterator->replies_n - 1)
+
+		if (entry == NULL)
 		{
-			iterator->replies_cur++;
-			goto retry;
+			return FALSE;
 		}
 	}
 
-	return ret;
+	iterator->key = entry->key;
+	iterator->value = entry->value;
+	iterator->len = entry->len;
+	iterator->returned++;
+
+	return TRUE;
+}
+
+/**
+ * Checks whether an iteration has been aborted because of an error.
+ * For instance, this happens if the server has closed the iteration's cursor because it has not been used for too long.
+ *
+ * \param iterator A store iterator.
+ *
+ * \return TRUE if j_kv_iterator_next() has failed, FALSE otherwise.
+ **/
+gboolean
+j_kv_iterator_failed(JKVIterator* iterator)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(iterator != NULL, FALSE);
+
+	return iterator->failed;
 }
 
 /**
@@ -59,6 +59,19 @@ struct JKVOperation
 			guint32 value_len;
 			GDestroyNotify value_destroy;
 		} put;
+
+		struct
+		{
+			JKV* kv;
+			gpointer expected;
+			guint32 expected_len;
+			gpointer value;
+			guint32 value_len;
+			GDestroyNotify value_destroy;
+			gint64 delta;
+			gboolean* swapped;
+			gint64* result;
+		} update;
 	};
 };
 
@@ -188,6 +201,24 @@ j_kv_get_free(gpointer data)
 	g_slice_free(JKVOperation, operation);
 }
 
+static void
+j_kv_update_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVOperation* operation = data;
+
+	j_kv_unref(operation->update.kv);
+	g_free(operation->update.expected);
+
+	if (operation->update.value_destroy != NULL)
+	{
+		operation->update.value_destroy(operation->update.value);
+	}
+
+	g_slice_free(JKVOperation, operation);
+}
+
 static gboolean
 j_kv_put_exec(JList* operations, JSemantics* semantics)
 {
@@ -380,8 +411,18 @@ j_kv_delete_exec(JList* operations, JSemantics* semantics)
 	return ret;
 }
 
+/**
+ * Executes gets of pairs on the same server and in the same namespace.
+ *
+ * \private
+ *
+ * \param operations The operations.
+ * \param semantics  The semantics.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
 static gboolean
-j_kv_get_exec(JList* operations, JSemantics* semantics)
+j_kv_get_exec_same(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -494,21 +535,36 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 
 			if (len > 0)
 			{
-				gconstpointer data;
+				gpointer value;
 
-				data = j_message_get_n(reply, len);
+				if (len > J_MESSAGE_KV_INLINE_MAX)
+				{
+					GInputStream* input;
+
+					// Large values are sent after the reply, read them directly into their final buffer
+					input = g_io_stream_get_input_stream(G_IO_STREAM(kv_connection));
+					value = g_malloc(len);
+
+					if (!g_input_stream_read_all(input, value, len, NULL, NULL, NULL))
+					{
+						g_free(value);
+						ret = FALSE;
+						continue;
+					}
+				}
+				else
+				{
+					// The data belongs to the message, create a copy
+					value = g_memdup(j_message_get_n(reply, len), len);
+				}
 
 				if (kop->get.func != NULL)
 				{
-					gpointer value;
-
-					// data belongs to the message, create a copy for the callback
-					value = g_memdup(data, len);
 					kop->get.func(value, len, kop->get.data);
 				}
 				else
 				{
-					*(kop->get.value) = g_memdup(data, len);
+					*(kop->get.value) = value;
 					*(kop->get.value_len) = len;
 				}
 			}
@@ -520,6 +576,275 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 	return ret;
 }
 
+static gboolean
+j_kv_get_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JListIterator) it = NULL;
+	g_autoptr(GPtrArray) groups = NULL;
+	JList* group = NULL;
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(operations != NULL, FALSE);
+	g_return_val_if_fail(semantics != NULL, FALSE);
+
+	groups = g_ptr_array_new_with_free_func((GDestroyNotify)j_list_unref);
+	it = j_list_iterator_new(operations);
+
+	// Split the gets into one message per server and namespace, keeping their order within each message
+	while (j_list_iterator_next(it))
+	{
+		JKVOperation* kop = j_list_iterator_get(it);
+		JKVOperation* first;
+
+		// Consecutive gets usually belong to the same group
+		if (group != NULL)
+		{
+			first = j_list_get_first(group);
+
+			if (first->get.kv->index != kop->get.kv->index || g_strcmp0(first->get.kv->namespace, kop->get.kv->namespace) != 0)
+			{
+				group = NULL;
+			}
+		}
+
+		for (guint i = 0; group == NULL && i < groups->len; i++)
+		{
+			first = j_list_get_first(g_ptr_array_index(groups, i));
+
+			if (first->get.kv->index == kop->get.kv->index && g_strcmp0(first->get.kv->namespace, kop->get.kv->namespace) == 0)
+			{
+				group = g_ptr_array_index(groups, i);
+			}
+		}
+
+		if (group == NULL)
+		{
+			group = j_list_new(NULL);
+			g_ptr_array_add(groups, group);
+		}
+
+		j_list_append(group, kop);
+	}
+
+	for (guint i = 0; i < groups->len; i++)
+	{
+		ret = j_kv_get_exec_same(g_ptr_array_index(groups, i), semantics) && ret;
+	}
+
+	return ret;
+}
+
+
+/**
+ * Executes atomic operations.
+ * All operations have the same type, which determines the message type.
+ *
+ * \private
+ *
+ * \param operations A list of operations.
+ * \param semantics  A semantics object.
+ * \param type       J_MESSAGE_KV_COMPARE_AND_SWAP, J_MESSAGE_KV_ADD or J_MESSAGE_KV_APPEND.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+j_kv_update_exec(JList* operations, JSemantics* semantics, JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	JBackend* kv_backend;
+	g_autoptr(JListIterator) it = NULL;
+	g_autoptr(JMessage) message = NULL;
+	gchar const* namespace;
+	gpointer kv_batch = NULL;
+	gsize namespace_len;
+	guint32 index;
+
+	g_return_val_if_fail(operations != NULL, FALSE);
+	g_return_val_if_fail(semantics != NULL, FALSE);
+
+	{
+		JKVOperation* kop;
+
+		kop = j_list_get_first(operations);
+		g_assert(kop != NULL);
+
+		namespace = kop->update.kv->namespace;
+		namespace_len = strlen(namespace) + 1;
+		index = kop->update.kv->index;
+	}
+
+	it = j_list_iterator_new(operations);
+	kv_backend = j_kv_get_backend();
+
+	if (kv_backend != NULL)
+	{
+		ret = j_backend_kv_batch_start(kv_backend, namespace, semantics, &kv_batch);
+	}
+	else
+	{
+		message = j_message_new(type, namespace_len);
+		j_message_set_semantics(message, semantics);
+		j_message_append_n(message, namespace, namespace_len);
+	}
+
+	while (j_list_iterator_next(it))
+	{
+		JKVOperation* kop = j_list_iterator_get(it);
+
+		if (kv_backend != NULL)
+		{
+			if (type == J_MESSAGE_KV_COMPARE_AND_SWAP)
+			{
+				gboolean swapped;
+
+				ret = j_backend_kv_compare_and_swap(kv_backend, kv_batch, kop->update.kv->key, kop->update.expected, kop->update.expected_len, kop->update.value, kop->update.value_len, &swapped) && ret;
+
+				if (kop->update.swapped != NULL)
+				{
+					*(kop->update.swapped) = swapped;
+				}
+			}
+			else if (type == J_MESSAGE_KV_ADD)
+			{
+				gint64 result = 0;
+
+				ret = j_backend_kv_add(kv_backend, kv_batch, kop->update.kv->key, kop->update.delta, &result) && ret;
+
+				if (kop->update.result != NULL)
+				{
+					*(kop->update.result) = result;
+				}
+			}
+			else
+			{
+				ret = j_backend_kv_append(kv_backend, kv_batch, kop->update.kv->key, kop->update.value, kop->update.value_len) && ret;
+			}
+		}
+		else
+		{
+			gsize key_len;
+
+			key_len = strlen(kop->update.kv->key) + 1;
+
+			if (type == J_MESSAGE_KV_COMPARE_AND_SWAP)
+			{
+				gchar exists;
+
+				exists = (kop->update.expected != NULL) ? 1 : 0;
+
+				j_message_add_operation(message, key_len + 1 + 4 + kop->update.expected_len + 4 + kop->update.value_len);
+				j_message_append_n(message, kop->update.kv->key, key_len);
+				j_message_append_1(message, &exists);
+				j_message_append_4(message, &(kop->update.expected_len));
+
+				if (kop->update.expected != NULL)
+				{
+					j_message_append_n(message, kop->update.expected, kop->update.expected_len);
+				}
+
+				j_message_append_4(message, &(kop->update.value_len));
+				j_message_append_n(message, kop->update.value, kop->update.value_len);
+			}
+			else if (type == J_MESSAGE_KV_ADD)
+			{
+				j_message_add_operation(message, key_len + 8);
+				j_message_append_n(message, kop->update.kv->key, key_len);
+				j_message_append_8(message, &(kop->update.delta));
+			}
+			else
+			{
+				j_message_add_operation(message, key_len + 4 + kop->update.value_len);
+				j_message_append_n(message, kop->update.kv->key, key_len);
+				j_message_append_4(message, &(kop->update.value_len));
+				j_message_append_n(message, kop->update.value, kop->update.value_len);
+			}
+		}
+	}
+
+	if (kv_backend != NULL)
+	{
+		ret = j_backend_kv_batch_execute(kv_backend, kv_batch) && ret;
+	}
+	else
+	{
+		g_autoptr(JListIterator) iter = NULL;
+		g_autoptr(JMessage) reply = NULL;
+		gpointer kv_connection;
+
+		kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, index);
+		j_message_send(message, kv_connection);
+
+		// The results are needed, so the server always replies
+		reply = j_message_new_reply(message);
+		j_message_receive(reply, kv_connection);
+
+		iter = j_list_iterator_new(operations);
+
+		while (j_list_iterator_next(iter))
+		{
+			JKVOperation* kop = j_list_iterator_get(iter);
+
+			ret = (j_message_get_1(reply) != 0) && ret;
+
+			if (type == J_MESSAGE_KV_COMPARE_AND_SWAP)
+			{
+				gboolean swapped;
+
+				swapped = (j_message_get_1(reply) != 0);
+
+				if (kop->update.swapped != NULL)
+				{
+					*(kop->update.swapped) = swapped;
+				}
+			}
+			else if (type == J_MESSAGE_KV_ADD)
+			{
+				gint64 result;
+
+				result = j_message_get_8(reply);
+
+				if (kop->update.result != NULL)
+				{
+					*(kop->update.result) = result;
+				}
+			}
+		}
+
+		j_connection_pool_push(J_BACKEND_TYPE_KV, index, kv_connection);
+	}
+
+	return ret;
+}
+
+static gboolean
+j_kv_compare_and_swap_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return j_kv_update_exec(operations, semantics, J_MESSAGE_KV_COMPARE_AND_SWAP);
+}
+
+static gboolean
+j_kv_add_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return j_kv_update_exec(operations, semantics, J_MESSAGE_KV_ADD);
+}
+
+static gboolean
+j_kv_append_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return j_kv_update_exec(operations, semantics, J_MESSAGE_KV_APPEND);
+}
+
 /**
  * Creates a new key-value pair.
  *
@@ -546,7 +871,7 @@ j_kv_new(gchar const* namespace, gchar const* key)
 	g_return_val_if_fail(key != NULL, NULL);
 
 	kv = g_slice_new(JKV);
-	kv->index = j_helper_hash(key) % j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV);
+	kv->index = j_kv_placement_index(j_configuration_get_kv_placement(configuration), j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV), key);
 	kv->namespace = g_strdup(namespace);
 	kv->key = g_strdup(key);
 	kv->ref_count = 1;
@@ -589,6 +914,42 @@ j_kv_new_for_index(guint32 index, gchar const* namespace, gchar const* key)
 	return kv;
 }
 
+/**
+ * Creates a new key-value pair on the local KV server.
+ * If no KV server runs on the local host, the pair is placed as with j_kv_new().
+ *
+ * Other clients compute a different index for the same key.
+ * This is therefore only suitable for node-local data that is only accessed from the node that created it.
+ *
+ * \code
+ * JKV* i;
+ *
+ * i = j_kv_new_local("JULEA", "JULEA");
+ * \endcode
+ *
+ * \param namespace A namespace.
+ * \param key       A key.
+ *
+ * \return A new key-value pair. Should be freed with j_kv_unref().
+ **/
+JKV*
+j_kv_new_local(gchar const* namespace, gchar const* key)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 index;
+
+	g_return_val_if_fail(namespace != NULL, NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+
+	if (!j_configuration_get_local_server(j_configuration(), J_BACKEND_TYPE_KV, &index))
+	{
+		return j_kv_new(namespace, key);
+	}
+
+	return j_kv_new_for_index(index, namespace, key);
+}
+
 /**
  * Increases a key-value pair's reference count.
  *
@@ -729,7 +1090,8 @@ j_kv_get(JKV* kv, gpointer* value, guint32* value_len, JBatch* batch)
 	kop->get.data = NULL;
 
 	operation = j_operation_new();
-	operation->key = kv;
+	// Gets of different pairs are combined, j_kv_get_exec() groups them by server and namespace
+	operation->key = NULL;
 	operation->data = kop;
 	operation->exec_func = j_kv_get_exec;
 	operation->free_func = j_kv_get_free;
@@ -765,7 +1127,8 @@ j_kv_get_callback(JKV* kv, JKVGetFunc func, gpointer data, JBatch* batch)
 	kop->get.data = data;
 
 	operation = j_operation_new();
-	operation->key = kv;
+	// Gets of different pairs are combined, j_kv_get_exec() groups them by server and namespace
+	operation->key = NULL;
 	operation->data = kop;
 	operation->exec_func = j_kv_get_exec;
 	operation->free_func = j_kv_get_free;
@@ -773,6 +1136,183 @@ j_kv_get_callback(JKV* kv, JKVGetFunc func, gpointer data, JBatch* batch)
 	j_batch_add(batch, operation);
 }
 
+/**
+ * Replaces a key-value pair's value if it matches an expected value.
+ * The comparison and the replacement are executed atomically by the server.
+ * Backends without native support fall back to a non-atomic get and put.
+ *
+ * \code
+ * gboolean swapped;
+ *
+ * j_kv_compare_and_swap(kv, old_value, old_len, new_value, new_len, g_free, &swapped, batch);
+ * j_batch_execute(batch);
+ * \endcode
+ *
+ * \param kv            A key-value pair.
+ * \param expected      The expected value, NULL if the pair must not exist yet. It is copied.
+ * \param expected_len  The expected value's length.
+ * \param value         The new value.
+ * \param value_len     The new value's length.
+ * \param value_destroy A function to free the new value, or NULL.
+ * \param swapped       Returns whether the value has been replaced, or NULL.
+ * \param batch         A batch.
+ **/
+void
+j_kv_compare_and_swap(JKV* kv, gconstpointer expected, guint32 expected_len, gpointer value, guint32 value_len, GDestroyNotify value_destroy, gboolean* swapped, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVOperation* kop;
+	JOperation* operation;
+
+	g_return_if_fail(kv != NULL);
+	g_return_if_fail(value != NULL);
+
+	kop = g_slice_new(JKVOperation);
+	kop->update.kv = j_kv_ref(kv);
+	kop->update.expected = (expected != NULL) ? g_memdup(expected, expected_len) : NULL;
+	kop->update.expected_len = (expected != NULL) ? expected_len : 0;
+	kop->update.value = value;
+	kop->update.value_len = value_len;
+	kop->update.value_destroy = value_destroy;
+	kop->update.delta = 0;
+	kop->update.swapped = swapped;
+	kop->update.result = NULL;
+
+	operation = j_operation_new();
+	operation->key = kv;
+	operation->data = kop;
+	operation->exec_func = j_kv_compare_and_swap_exec;
+	operation->free_func = j_kv_update_free;
+
+	j_batch_add(batch, operation);
+}
+
+/**
+ * Atomically adds to a key-value pair's 64-bit integer value.
+ * A pair that does not exist yet counts as 0.
+ * The value is stored in host byte order.
+ *
+ * \code
+ * gint64 count;
+ *
+ * j_kv_add(kv, 1, &count, batch);
+ * j_batch_execute(batch);
+ * \endcode
+ *
+ * \param kv     A key-value pair.
+ * \param delta  The value to add.
+ * \param result Returns the new value, or NULL.
+ * \param batch  A batch.
+ **/
+void
+j_kv_add(JKV* kv, gint64 delta, gint64* result, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVOperation* kop;
+	JOperation* operation;
+
+	g_return_if_fail(kv != NULL);
+
+	kop = g_slice_new(JKVOperation);
+	kop->update.kv = j_kv_ref(kv);
+	kop->update.expected = NULL;
+	kop->update.expected_len = 0;
+	kop->update.value = NULL;
+	kop->update.value_len = 0;
+	kop->update.value_destroy = NULL;
+	kop->update.delta = delta;
+	kop->update.swapped = NULL;
+	kop->update.result = result;
+
+	operation = j_operation_new();
+	operation->key = kv;
+	operation->data = kop;
+	operation->exec_func = j_kv_add_exec;
+	operation->free_func = j_kv_update_free;
+
+	j_batch_add(batch, operation);
+}
+
+/**
+ * Atomically appends to a key-value pair's value.
+ * A pair that does not exist yet counts as empty.
+ *
+ * \code
+ * \endcode
+ *
+ * \param kv            A key-value pair.
+ * \param value         The data to append.
+ * \param value_len     The data's length.
+ * \param value_destroy A function to free the data, or NULL.
+ * \param batch         A batch.
+ **/
+void
+j_kv_append(JKV* kv, gpointer value, guint32 value_len, GDestroyNotify value_destroy, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVOperation* kop;
+	JOperation* operation;
+
+	g_return_if_fail(kv != NULL);
+	g_return_if_fail(value != NULL);
+
+	kop = g_slice_new(JKVOperation);
+	kop->update.kv = j_kv_ref(kv);
+	kop->update.expected = NULL;
+	kop->update.expected_len = 0;
+	kop->update.value = value;
+	kop->update.value_len = value_len;
+	kop->update.value_destroy = value_destroy;
+	kop->update.delta = 0;
+	kop->update.swapped = NULL;
+	kop->update.result = NULL;
+
+	operation = j_operation_new();
+	operation->key = kv;
+	operation->data = kop;
+	operation->exec_func = j_kv_append_exec;
+	operation->free_func = j_kv_update_free;
+
+	j_batch_add(batch, operation);
+}
+
+/**
+ * Returns the server a key is placed on.
+ *
+ * \code
+ * index = j_kv_placement_index(J_KV_PLACEMENT_JUMP, 4, "key");
+ * \endcode
+ *
+ * \param placement    A placement.
+ * \param server_count The number of kv servers.
+ * \param key          A key.
+ *
+ * \return The server index.
+ **/
+guint32
+j_kv_placement_index(JKVPlacement placement, guint32 server_count, gchar const* key)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(server_count > 0, 0);
+	g_return_val_if_fail(key != NULL, 0);
+
+	switch (placement)
+	{
+		case J_KV_PLACEMENT_MODULO:
+			return j_helper_hash(key) % server_count;
+		case J_KV_PLACEMENT_JUMP:
+			return j_helper_jump_hash(j_helper_hash_wyhash(key), server_count);
+		default:
+			g_assert_not_reached();
+	}
+
+	return 0;
+}
+
 /**
  * Returns the kv backend.
  *
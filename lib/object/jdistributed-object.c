@@ -31,6 +31,7 @@
 #include <object/jobject-internal.h>
 
 #include <julea.h>
+#include <julea-kv.h>
 
 /**
  * \defgroup JDistributedObject Distributed Object
@@ -51,7 +52,7 @@ struct JDistributedObjectBackgroundData
 	JSemantics* semantics;
 
 	/**
-	 * The union for read and write parts.
+	 * The union for read, write and copy parts.
 	 */
 	union
 	{
@@ -73,7 +74,23 @@ struct JDistributedObjectBackgroundData
 		struct
 		{
 			JList* bytes_written;
+
+			/**
+			 * Set to FALSE if a server could not write a stripe.
+			 */
+			gboolean* ret;
 		} write;
+
+		/**
+		 * The copy part.
+		 */
+		struct
+		{
+			/**
+			 * Set to FALSE if a server could not copy an object.
+			 */
+			gboolean* ret;
+		} copy;
 	};
 };
 
@@ -87,15 +104,51 @@ struct JDistributedObjectReadBuffer
 
 typedef struct JDistributedObjectReadBuffer JDistributedObjectReadBuffer;
 
+/**
+ * The metadata record caching an object's status.
+ * Stored in the KV namespace distributed-object:<namespace> under the object's name.
+ */
+struct JDistributedObjectStatus
+{
+	gint64 modification_time;
+	guint64 size;
+
+	/**
+	 * The end of the range stripes might have been created for, including preallocated ones.
+	 */
+	guint64 extent;
+};
+
+typedef struct JDistributedObjectStatus JDistributedObjectStatus;
+
 struct JDistributedObjectOperation
 {
 	union
 	{
+		struct
+		{
+			JDistributedObject* object;
+			guint64 size_hint;
+
+			/**
+			 * The record written if the object does not have one yet.
+			 */
+			JDistributedObjectStatus status;
+			gboolean status_created;
+		} create;
+
 		struct
 		{
 			JDistributedObject* object;
 			gint64* modification_time;
 			guint64* size;
+
+			/**
+			 * The status collected from all servers during a scan.
+			 * The size is the end of the last stripe.
+			 */
+			gint64 scan_modification_time;
+			guint64 scan_size;
 		} status;
 
 		struct
@@ -120,6 +173,13 @@ struct JDistributedObjectOperation
 			guint64 offset;
 			guint64* bytes_written;
 		} write;
+
+		struct
+		{
+			JDistributedObject* object;
+			JDistributedObject* destination;
+			gboolean same_distribution;
+		} copy;
 	};
 };
 
@@ -142,20 +202,317 @@ struct JDistributedObject
 
 	JDistribution* distribution;
 
+	/**
+	 * The metadata record.
+	 **/
+	JKV* status;
+
+	/**
+	 * The last known state of the metadata record.
+	 * Protected by the j_distributed_object_status_cache lock.
+	 **/
+	JDistributedObjectStatus status_cache;
+	gboolean status_cached;
+
 	/**
 	 * The reference count.
 	 **/
 	gint ref_count;
 };
 
+G_LOCK_DEFINE_STATIC(j_distributed_object_status_cache);
+
+/**
+ * Returns the last known state of an object's metadata record.
+ *
+ * \private
+ *
+ * \param object An object.
+ * \param status A status to fill.
+ *
+ * \return TRUE if the state is known, FALSE otherwise.
+ **/
+static gboolean
+j_distributed_object_status_cache_get(JDistributedObject* object, JDistributedObjectStatus* status)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	G_LOCK(j_distributed_object_status_cache);
+
+	ret = object->status_cached;
+
+	if (ret)
+	{
+		*status = object->status_cache;
+	}
+
+	G_UNLOCK(j_distributed_object_status_cache);
+
+	return ret;
+}
+
+/**
+ * Remembers the state of an object's metadata record.
+ *
+ * \private
+ *
+ * \param object An object.
+ * \param status A status, NULL if the state is unknown.
+ **/
+static void
+j_distributed_object_status_cache_set(JDistributedObject* object, JDistributedObjectStatus const* status)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	G_LOCK(j_distributed_object_status_cache);
+
+	object->status_cached = (status != NULL);
+
+	if (status != NULL)
+	{
+		object->status_cache = *status;
+	}
+
+	G_UNLOCK(j_distributed_object_status_cache);
+}
+
+/**
+ * Reads an object's metadata record.
+ *
+ * \private
+ *
+ * \param object    An object.
+ * \param status    A status to fill.
+ * \param semantics A semantics object.
+ *
+ * \return TRUE if the record exists, FALSE otherwise.
+ **/
+static gboolean
+j_distributed_object_status_get(JDistributedObject* object, JDistributedObjectStatus* status, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JBatch) batch = NULL;
+	gpointer value = NULL;
+	guint32 len = 0;
+	gboolean ret;
+
+	batch = j_batch_new(semantics);
+
+	j_kv_get(object->status, &value, &len, batch);
+	ret = j_batch_execute(batch);
+
+	ret = (ret && value != NULL && len == sizeof(JDistributedObjectStatus));
+
+	if (ret)
+	{
+		memcpy(status, value, sizeof(JDistributedObjectStatus));
+	}
+
+	j_distributed_object_status_cache_set(object, (ret) ? status : NULL);
+
+	g_free(value);
+
+	return ret;
+}
+
+/**
+ * Writes an object's metadata record.
+ *
+ * \private
+ *
+ * \param object    An object.
+ * \param status    A status.
+ * \param semantics A semantics object.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+j_distributed_object_status_set(JDistributedObject* object, JDistributedObjectStatus const* status, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JBatch) batch = NULL;
+
+	batch = j_batch_new(semantics);
+
+	j_kv_put(object->status, g_memdup(status, sizeof(JDistributedObjectStatus)), sizeof(JDistributedObjectStatus), g_free, batch);
+
+	if (!j_batch_execute(batch))
+	{
+		j_distributed_object_status_cache_set(object, NULL);
+		return FALSE;
+	}
+
+	j_distributed_object_status_cache_set(object, status);
+
+	return TRUE;
+}
+
+/**
+ * Updates an object's metadata record after it has been modified.
+ * If the modification time does not have to be updated, the record is only updated if the object has grown beyond the last known size or extent.
+ * Unsafe semantics do not wait for the update, concurrent updates by other clients might be lost in this case.
+ *
+ * \private
+ *
+ * \param object    An object.
+ * \param size      The end of the modified range.
+ * \param extent    The end of the range stripes have been created for.
+ * \param touch     Whether to update the modification time.
+ * \param semantics A semantics object.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+j_distributed_object_status_update(JDistributedObject* object, guint64 size, guint64 extent, gboolean touch, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributedObjectStatus expected;
+	gboolean known;
+
+	known = j_distributed_object_status_cache_get(object, &expected);
+
+	// Retry until no other client has modified the record in the meantime
+	while (TRUE)
+	{
+		g_autoptr(JBatch) batch = NULL;
+		g_autofree gpointer value = NULL;
+		JDistributedObjectStatus status;
+		guint32 len = 0;
+		gboolean swapped = FALSE;
+
+		if (!touch && known && size <= expected.size && extent <= expected.extent)
+		{
+			return TRUE;
+		}
+
+		batch = j_batch_new(semantics);
+
+		status.modification_time = (touch || !known) ? g_get_real_time() : expected.modification_time;
+		status.size = (known) ? MAX(expected.size, size) : size;
+		status.extent = MAX(MAX(status.size, extent), (known) ? expected.extent : 0);
+
+		if (known && j_semantics_get(semantics, J_SEMANTICS_SAFETY) == J_SEMANTICS_SAFETY_NONE)
+		{
+			j_kv_put(object->status, g_memdup(&status, sizeof(JDistributedObjectStatus)), sizeof(JDistributedObjectStatus), g_free, batch);
+			swapped = TRUE;
+		}
+		else
+		{
+			// Objects without a known record only get one if they do not have one yet
+			j_kv_compare_and_swap(object->status, (known) ? &expected : NULL, sizeof(JDistributedObjectStatus), g_memdup(&status, sizeof(JDistributedObjectStatus)), sizeof(JDistributedObjectStatus), g_free, &swapped, batch);
+		}
+
+		if (!j_batch_execute(batch))
+		{
+			j_distributed_object_status_cache_set(object, NULL);
+			return FALSE;
+		}
+
+		if (swapped)
+		{
+			j_distributed_object_status_cache_set(object, &status);
+			return TRUE;
+		}
+
+		// The record might have been removed in the meantime, in which case value stays NULL
+		j_kv_get(object->status, &value, &len, batch);
+		known = (j_batch_execute(batch) && value != NULL && len == sizeof(JDistributedObjectStatus));
+
+		if (known)
+		{
+			memcpy(&expected, value, sizeof(JDistributedObjectStatus));
+			j_distributed_object_status_cache_set(object, &expected);
+		}
+	}
+}
+
+/**
+ * Determines the servers storing stripes of an object.
+ * Stripes are created lazily, so only the server storing the first block and the servers storing data within the record's extent have to be contacted.
+ *
+ * \private
+ *
+ * \param object       An object.
+ * \param semantics    A semantics object.
+ * \param servers      An array of #server_count elements, set to TRUE for servers that might store stripes.
+ * \param server_count The number of servers.
+ *
+ * \return TRUE if the servers have been determined using the record, FALSE if all servers have to be contacted.
+ **/
+static gboolean
+j_distributed_object_get_servers(JDistributedObject* object, JSemantics* semantics, gboolean* servers, guint32 server_count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributedObjectStatus status;
+	guint64 block_id;
+	guint64 new_length;
+	guint64 new_offset;
+	guint32 index;
+	guint32 used = 0;
+
+	if (!j_distributed_object_status_cache_get(object, &status) && !j_distributed_object_status_get(object, &status, semantics))
+	{
+		for (guint i = 0; i < server_count; i++)
+		{
+			servers[i] = TRUE;
+		}
+
+		return FALSE;
+	}
+
+	for (guint i = 0; i < server_count; i++)
+	{
+		servers[i] = FALSE;
+	}
+
+	// See j_distributed_object_create_exec()
+	j_distribution_reset(object->distribution, 1, 0);
+
+	if (j_distribution_distribute(object->distribution, &index, &new_length, &new_offset, &block_id))
+	{
+		servers[index] = TRUE;
+		used++;
+	}
+
+	j_distribution_reset(object->distribution, status.extent, 0);
+
+	while (used < server_count && j_distribution_distribute(object->distribution, &index, &new_length, &new_offset, &block_id))
+	{
+		guint replica_count;
+
+		replica_count = j_distribution_get_replica_count(object->distribution);
+
+		for (guint r = 0; r < replica_count; r++)
+		{
+			j_distribution_get_replica(object->distribution, r, &index, &new_offset);
+
+			if (!servers[index])
+			{
+				servers[index] = TRUE;
+				used++;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
 static void
 j_distributed_object_create_free(gpointer data)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JDistributedObject* object = data;
+	JDistributedObjectOperation* operation = data;
 
-	j_distributed_object_unref(object);
+	j_distributed_object_unref(operation->create.object);
+
+	g_slice_free(JDistributedObjectOperation, operation);
 }
 
 static void
@@ -216,6 +573,19 @@ j_distributed_object_write_free(gpointer data)
 	g_slice_free(JDistributedObjectOperation, operation);
 }
 
+static void
+j_distributed_object_copy_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributedObjectOperation* operation = data;
+
+	j_distributed_object_unref(operation->copy.object);
+	j_distributed_object_unref(operation->copy.destination);
+
+	g_slice_free(JDistributedObjectOperation, operation);
+}
+
 /**
  * Executes create operations in a background operation.
  *
@@ -323,8 +693,11 @@ j_distributed_object_read_background_operation(gpointer data)
 	gpointer object_connection;
 	guint32 operations_done;
 	guint32 operation_count;
+	gint64 start_time;
 
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
+
+	start_time = g_get_monotonic_time();
 	j_message_send(background_data->message, object_connection);
 
 	reply = j_message_new_reply(background_data->message);
@@ -345,6 +718,12 @@ j_distributed_object_read_background_operation(gpointer data)
 
 		j_message_receive(reply, object_connection);
 
+		// Replicas are selected based on the time until the first reply
+		if (operations_done == 0)
+		{
+			j_connection_pool_add_latency(J_BACKEND_TYPE_OBJECT, background_data->index, g_get_monotonic_time() - start_time);
+		}
+
 		reply_operation_count = j_message_get_count(reply);
 
 		for (guint i = 0; i < reply_operation_count && j_list_iterator_next(it); i++)
@@ -355,17 +734,9 @@ j_distributed_object_read_background_operation(gpointer data)
 
 			guint64 nbytes;
 
-			nbytes = j_message_get_8(reply);
+			nbytes = j_object_receive_read_reply(reply, object_connection, read_data);
 			j_helper_atomic_add(bytes_read, nbytes);
 
-			if (nbytes > 0)
-			{
-				GInputStream* input;
-
-				input = g_io_stream_get_input_stream(G_IO_STREAM(object_connection));
-				g_input_stream_read_all(input, read_data, nbytes, NULL, NULL, NULL);
-			}
-
 			g_slice_free(JDistributedObjectReadBuffer, buffer);
 		}
 
@@ -402,9 +773,12 @@ j_distributed_object_write_background_operation(gpointer data)
 	JSemanticsSafety safety;
 
 	gpointer object_connection;
+	gint64 start_time;
 
 	safety = j_semantics_get(background_data->semantics, J_SEMANTICS_SAFETY);
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
+
+	start_time = g_get_monotonic_time();
 	j_message_send(background_data->message, object_connection);
 
 	if (safety == J_SEMANTICS_SAFETY_NETWORK || safety == J_SEMANTICS_SAFETY_STORAGE)
@@ -416,6 +790,8 @@ j_distributed_object_write_background_operation(gpointer data)
 		reply = j_message_new_reply(background_data->message);
 		j_message_receive(reply, object_connection);
 
+		j_connection_pool_add_latency(J_BACKEND_TYPE_OBJECT, background_data->index, g_get_monotonic_time() - start_time);
+
 		it = j_list_iterator_new(background_data->write.bytes_written);
 
 		while (j_list_iterator_next(it))
@@ -424,6 +800,12 @@ j_distributed_object_write_background_operation(gpointer data)
 
 			nbytes = j_message_get_8(reply);
 			j_helper_atomic_add(bytes_written, nbytes);
+
+			// Other servers might report their results at the same time
+			if (j_message_get_1(reply) == 0)
+			{
+				g_atomic_int_set(background_data->write.ret, FALSE);
+			}
 		}
 	}
 
@@ -438,6 +820,8 @@ j_distributed_object_write_background_operation(gpointer data)
 	return NULL;
 }
 
+G_LOCK_DEFINE_STATIC(j_distributed_object_status_scan);
+
 /**
  * Executes status operations in a background operation.
  *
@@ -469,24 +853,22 @@ j_distributed_object_status_background_operation(gpointer data)
 	while (j_list_iterator_next(it))
 	{
 		JDistributedObjectOperation* operation = j_list_iterator_get(it);
-		gint64* modification_time = operation->status.modification_time;
-		guint64* size = operation->status.size;
-		gint64 modification_time_;
-		guint64 size_;
+		gint64 modification_time;
+		guint64 size;
 
-		modification_time_ = j_message_get_8(reply);
-		size_ = j_message_get_8(reply);
+		modification_time = j_message_get_8(reply);
+		size = j_message_get_8(reply);
 
-		if (modification_time != NULL)
+		// Stripes store the blocks at server offsets, the stripe's last byte determines where it ends within the object
+		if (size > 0)
 		{
-			// FIXME max?
-			*modification_time = modification_time_;
+			size = j_distribution_get_offset(operation->status.object->distribution, background_data->index, size - 1) + 1;
 		}
 
-		if (size != NULL)
-		{
-			j_helper_atomic_add(size, size_);
-		}
+		G_LOCK(j_distributed_object_status_scan);
+		operation->status.scan_modification_time = MAX(operation->status.scan_modification_time, modification_time);
+		operation->status.scan_size = MAX(operation->status.scan_size, size);
+		G_UNLOCK(j_distributed_object_status_scan);
 	}
 
 	j_message_unref(background_data->message);
@@ -539,28 +921,91 @@ j_distributed_object_sync_background_operation(gpointer data)
 	return NULL;
 }
 
-static gboolean
-j_distributed_object_create_exec(JList* operations, JSemantics* semantics)
+/**
+ * Executes copy operations in a background operation.
+ *
+ * \private
+ *
+ * \param data Background data.
+ *
+ * \return #data.
+ **/
+static gpointer
+j_distributed_object_copy_background_operation(gpointer data)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	// FIXME check return value for messages
-	gboolean ret = TRUE;
+	JDistributedObjectBackgroundData* background_data = data;
 
-	JBackend* object_backend;
-	g_autoptr(JListIterator) it = NULL;
-	g_autofree JMessage** messages = NULL;
-	gchar const* namespace = NULL;
-	gsize namespace_len = 0;
-	guint32 server_count = 0;
+	JSemanticsSafety safety;
+	gpointer object_connection;
+
+	safety = j_semantics_get(background_data->semantics, J_SEMANTICS_SAFETY);
+	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
+	j_message_send(background_data->message, object_connection);
+
+	if (safety == J_SEMANTICS_SAFETY_NETWORK || safety == J_SEMANTICS_SAFETY_STORAGE)
+	{
+		g_autoptr(JMessage) reply = NULL;
+		gboolean ret = TRUE;
+
+		reply = j_message_new_reply(background_data->message);
+
+		if (j_message_receive(reply, object_connection))
+		{
+			guint32 reply_count;
+
+			reply_count = j_message_get_count(reply);
+
+			for (guint32 i = 0; i < reply_count; i++)
+			{
+				ret = (j_message_get_1(reply) != 0) && ret;
+			}
+		}
+		else
+		{
+			ret = FALSE;
+		}
+
+		// Other servers might report their results at the same time
+		if (!ret)
+		{
+			g_atomic_int_set(background_data->copy.ret, FALSE);
+		}
+	}
+
+	j_message_unref(background_data->message);
+	j_connection_pool_push(J_BACKEND_TYPE_OBJECT, background_data->index, object_connection);
+
+	g_slice_free(JDistributedObjectBackgroundData, background_data);
+
+	return NULL;
+}
+
+static gboolean
+j_distributed_object_create_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	// FIXME check return value for messages
+	gboolean ret = TRUE;
+
+	JBackend* object_backend;
+	g_autoptr(JBatch) status_batch = NULL;
+	g_autoptr(JListIterator) it = NULL;
+	g_autofree JMessage** messages = NULL;
+	gchar const* namespace = NULL;
+	gsize namespace_len = 0;
+	guint32 server_count = 0;
 
 	g_return_val_if_fail(operations != NULL, FALSE);
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JDistributedObject* object;
+		JDistributedObjectOperation* operation = j_list_get_first(operations);
+		JDistributedObject* object = operation->create.object;
 
-		object = j_list_get_first(operations);
+		g_assert(operation != NULL);
 		g_assert(object != NULL);
 
 		namespace = object->namespace;
@@ -569,66 +1014,154 @@ j_distributed_object_create_exec(JList* operations, JSemantics* semantics)
 
 	it = j_list_iterator_new(operations);
 	object_backend = j_object_get_backend();
+	status_batch = j_batch_new(semantics);
 
 	if (object_backend == NULL)
 	{
 		server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
-		messages = g_new(JMessage*, server_count);
-
-		// FIXME use actual distribution
-		for (guint i = 0; i < server_count; i++)
-		{
-			/**
-			 * Force safe semantics to make the server send a reply.
-			 * Otherwise, nasty races can occur when using unsafe semantics:
-			 * - The client creates the object and sends its first write.
-			 * - The client sends another operation using another connection from the pool.
-			 * - The second operation is executed first and fails because the object does not exist.
-			 * This does not completely eliminate all races but fixes the common case of create, write, write, ...
-			 **/
-			messages[i] = j_message_new(J_MESSAGE_OBJECT_CREATE, namespace_len);
-			j_message_set_semantics(messages[i], semantics);
-			j_message_append_n(messages[i], namespace, namespace_len);
-		}
+		messages = g_new0(JMessage*, server_count);
 	}
 
 	while (j_list_iterator_next(it))
 	{
-		JDistributedObject* object = j_list_iterator_get(it);
+		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+		JDistributedObject* object = operation->create.object;
+		guint64 size_hint = operation->create.size_hint;
+		JDistributedObjectStatus status;
+
+		operation->create.status.modification_time = g_get_real_time();
+		operation->create.status.size = 0;
+		operation->create.status.extent = size_hint;
+		operation->create.status_created = FALSE;
+
+		// Creating an existing object does not change its record, all records are created in one batch
+		if (!j_distributed_object_status_cache_get(object, &status))
+		{
+			j_kv_compare_and_swap(object->status, NULL, 0, g_memdup(&(operation->create.status), sizeof(JDistributedObjectStatus)), sizeof(JDistributedObjectStatus), g_free, &(operation->create.status_created), status_batch);
+		}
 
 		if (object_backend != NULL)
 		{
 			gpointer object_handle;
 
-			ret = j_backend_object_create(object_backend, object->namespace, object->name, &object_handle) && ret;
-			ret = j_backend_object_close(object_backend, object_handle) && ret;
+			if (j_backend_object_create(object_backend, object->namespace, object->name, &object_handle))
+			{
+				if (size_hint > 0)
+				{
+					// The hint is only an optimization
+					j_backend_object_allocate(object_backend, object_handle, size_hint, 0);
+				}
+
+				ret = j_backend_object_close(object_backend, object_handle) && ret;
+			}
+			else
+			{
+				ret = FALSE;
+			}
 		}
 		else
 		{
+			g_autofree guint64* local_size_hints = NULL;
+			guint64 block_id;
+			guint64 new_length;
+			guint64 new_offset;
+			guint32 index;
+			guint32 first_index;
 			gsize name_len;
 
 			name_len = strlen(object->name) + 1;
+			local_size_hints = g_new0(guint64, server_count);
+
+			// The server storing the first block always gets a stripe, so that empty objects exist
+			j_distribution_reset(object->distribution, 1, 0);
+			j_distribution_distribute(object->distribution, &first_index, &new_length, &new_offset, &block_id);
+
+			// Every server only preallocates the part of the object it stores
+			if (size_hint > 0)
+			{
+				j_distribution_reset(object->distribution, size_hint, 0);
+
+				while (j_distribution_distribute(object->distribution, &index, &new_length, &new_offset, &block_id))
+				{
+					guint replica_count;
+
+					replica_count = j_distribution_get_replica_count(object->distribution);
+
+					for (guint r = 0; r < replica_count; r++)
+					{
+						j_distribution_get_replica(object->distribution, r, &index, &new_offset);
+						local_size_hints[index] = MAX(local_size_hints[index], new_offset + new_length);
+					}
+				}
+			}
 
-			// FIXME use actual distribution
+			// All other stripes are created lazily by the first write reaching their server
 			for (guint i = 0; i < server_count; i++)
 			{
-				j_message_add_operation(messages[i], name_len);
+				if (i != first_index && local_size_hints[i] == 0)
+				{
+					continue;
+				}
+
+				if (messages[i] == NULL)
+				{
+					/**
+					 * Force safe semantics to make the server send a reply.
+					 * Otherwise, nasty races can occur when using unsafe semantics:
+					 * - The client creates the object and sends its first write.
+					 * - The client sends another operation using another connection from the pool.
+					 * - The second operation is executed first and fails because the object does not exist.
+					 * This does not completely eliminate all races but fixes the common case of create, write, write, ...
+					 **/
+					messages[i] = j_message_new(J_MESSAGE_OBJECT_CREATE, namespace_len);
+					j_message_set_semantics(messages[i], semantics);
+					j_message_append_n(messages[i], namespace, namespace_len);
+				}
+
+				j_message_add_operation(messages[i], name_len + sizeof(guint64));
 				j_message_append_n(messages[i], object->name, name_len);
+				j_message_append_8(messages[i], &(local_size_hints[i]));
 			}
 		}
 	}
 
+	// The records have to cover all stripes before they are created
+	ret = j_batch_execute(status_batch) && ret;
+
+	j_list_iterator_free(it);
+	it = j_list_iterator_new(operations);
+
+	while (j_list_iterator_next(it))
+	{
+		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+
+		if (operation->create.status_created)
+		{
+			j_distributed_object_status_cache_set(operation->create.object, &(operation->create.status));
+		}
+		else if (operation->create.size_hint > 0)
+		{
+			// Existing records might not cover the preallocated stripes yet
+			ret = j_distributed_object_status_update(operation->create.object, 0, operation->create.size_hint, FALSE, semantics) && ret;
+		}
+	}
+
 	if (object_backend == NULL)
 	{
 		g_autofree gpointer* background_data = NULL;
 
-		background_data = g_new(gpointer, server_count);
+		// Servers without messages are skipped
+		background_data = g_new0(gpointer, server_count);
 
-		// FIXME use actual distribution
 		for (guint i = 0; i < server_count; i++)
 		{
 			JDistributedObjectBackgroundData* data;
 
+			if (messages[i] == NULL)
+			{
+				continue;
+			}
+
 			data = g_slice_new(JDistributedObjectBackgroundData);
 			data->index = i;
 			data->message = messages[i];
@@ -653,8 +1186,10 @@ j_distributed_object_delete_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
+	g_autoptr(JBatch) status_batch = NULL;
 	g_autoptr(JListIterator) it = NULL;
 	g_autofree JMessage** messages = NULL;
+	g_autofree gboolean* servers = NULL;
 	gchar const* namespace = NULL;
 	gsize namespace_len = 0;
 	guint32 server_count = 0;
@@ -674,19 +1209,13 @@ j_distributed_object_delete_exec(JList* operations, JSemantics* semantics)
 
 	it = j_list_iterator_new(operations);
 	object_backend = j_object_get_backend();
+	status_batch = j_batch_new(semantics);
 
 	if (object_backend == NULL)
 	{
 		server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
-		messages = g_new(JMessage*, server_count);
-
-		// FIXME use actual distribution
-		for (guint i = 0; i < server_count; i++)
-		{
-			messages[i] = j_message_new(J_MESSAGE_OBJECT_DELETE, namespace_len);
-			j_message_set_semantics(messages[i], semantics);
-			j_message_append_n(messages[i], namespace, namespace_len);
-		}
+		messages = g_new0(JMessage*, server_count);
+		servers = g_new(gboolean, server_count);
 	}
 
 	while (j_list_iterator_next(it))
@@ -706,26 +1235,48 @@ j_distributed_object_delete_exec(JList* operations, JSemantics* semantics)
 
 			name_len = strlen(object->name) + 1;
 
-			// FIXME use actual distribution
+			// The record is still needed to find the stripes
+			j_distributed_object_get_servers(object, semantics, servers, server_count);
+
 			for (guint i = 0; i < server_count; i++)
 			{
+				if (!servers[i])
+				{
+					continue;
+				}
+
+				if (messages[i] == NULL)
+				{
+					messages[i] = j_message_new(J_MESSAGE_OBJECT_DELETE, namespace_len);
+					j_message_set_semantics(messages[i], semantics);
+					j_message_append_n(messages[i], namespace, namespace_len);
+				}
+
 				j_message_add_operation(messages[i], name_len);
 				j_message_append_n(messages[i], object->name, name_len);
 			}
 		}
+
+		j_kv_delete(object->status, status_batch);
+		j_distributed_object_status_cache_set(object, NULL);
 	}
 
 	if (object_backend == NULL)
 	{
 		g_autofree gpointer* background_data = NULL;
 
-		background_data = g_new(gpointer, server_count);
+		// Servers without messages are skipped
+		background_data = g_new0(gpointer, server_count);
 
-		// FIXME use actual distribution
 		for (guint i = 0; i < server_count; i++)
 		{
 			JDistributedObjectBackgroundData* data;
 
+			if (messages[i] == NULL)
+			{
+				continue;
+			}
+
 			data = g_slice_new(JDistributedObjectBackgroundData);
 			data->index = i;
 			data->message = messages[i];
@@ -738,6 +1289,12 @@ j_distributed_object_delete_exec(JList* operations, JSemantics* semantics)
 		j_helper_execute_parallel(j_distributed_object_delete_background_operation, background_data, server_count);
 	}
 
+	// Objects might not have a record if it has been lost, so failures are ignored
+	if (!j_batch_execute(status_batch))
+	{
+		g_debug("Could not delete status records.");
+	}
+
 	return ret;
 }
 
@@ -834,6 +1391,34 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 			while (j_distribution_distribute(object->distribution, &index, &new_length, &new_offset, &block_id))
 			{
 				JDistributedObjectReadBuffer* buffer;
+				guint replica_count;
+
+				replica_count = j_distribution_get_replica_count(object->distribution);
+
+				// Read from the replica that is expected to answer first
+				if (replica_count > 1)
+				{
+					gint64 best_latency;
+
+					best_latency = j_connection_pool_get_latency(J_BACKEND_TYPE_OBJECT, index);
+
+					for (guint r = 1; r < replica_count; r++)
+					{
+						guint64 replica_offset;
+						guint replica_index;
+						gint64 latency;
+
+						j_distribution_get_replica(object->distribution, r, &replica_index, &replica_offset);
+						latency = j_connection_pool_get_latency(J_BACKEND_TYPE_OBJECT, replica_index);
+
+						if (latency < best_latency)
+						{
+							best_latency = latency;
+							index = replica_index;
+							new_offset = replica_offset;
+						}
+					}
+				}
 
 				if (messages[index] == NULL && br_lists[index] == NULL)
 				{
@@ -920,7 +1505,6 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	// FIXME check return value for messages
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
@@ -932,6 +1516,8 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 	gsize name_len = 0;
 	gsize namespace_len = 0;
 	guint32 server_count = 0;
+	guint64 size = 0;
+	guint64 replica_bytes_written = 0;
 
 	// FIXME
 	//JLock* lock = NULL;
@@ -985,6 +1571,8 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 		guint64 offset = operation->write.offset;
 		guint64* bytes_written = operation->write.bytes_written;
 
+		size = MAX(size, offset + length);
+
 		j_trace_file_begin(object->name, J_TRACE_FILE_WRITE);
 
 		if (object_backend != NULL)
@@ -1007,22 +1595,37 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 
 			while (j_distribution_distribute(object->distribution, &index, &new_length, &new_offset, &block_id))
 			{
-				if (messages[index] == NULL && bw_lists[index] == NULL)
+				guint replica_count;
+
+				replica_count = j_distribution_get_replica_count(object->distribution);
+
+				// All replicas are written in parallel
+				for (guint r = 0; r < replica_count; r++)
 				{
-					messages[index] = j_message_new(J_MESSAGE_OBJECT_WRITE, namespace_len + name_len);
-					j_message_set_semantics(messages[index], semantics);
-					j_message_append_n(messages[index], object->namespace, namespace_len);
-					j_message_append_n(messages[index], object->name, name_len);
+					j_distribution_get_replica(object->distribution, r, &index, &new_offset);
 
-					bw_lists[index] = j_list_new(NULL);
-				}
+					if (messages[index] == NULL && bw_lists[index] == NULL)
+					{
+						// Stripes are created lazily by their first write
+						gchar create = 1;
 
-				j_message_add_operation(messages[index], sizeof(guint64) + sizeof(guint64));
-				j_message_append_8(messages[index], &new_length);
-				j_message_append_8(messages[index], &new_offset);
-				j_message_add_send(messages[index], new_data, new_length);
+						messages[index] = j_message_new(J_MESSAGE_OBJECT_WRITE, namespace_len + name_len + 1);
+						j_message_set_semantics(messages[index], semantics);
+						j_message_append_n(messages[index], object->namespace, namespace_len);
+						j_message_append_n(messages[index], object->name, name_len);
+						j_message_append_1(messages[index], &create);
 
-				j_list_append(bw_lists[index], bytes_written);
+						bw_lists[index] = j_list_new(NULL);
+					}
+
+					j_message_add_operation(messages[index], sizeof(guint64) + sizeof(guint64));
+					j_message_append_8(messages[index], &new_length);
+					j_message_append_8(messages[index], &new_offset);
+					j_message_add_send(messages[index], new_data, new_length);
+
+					// Only the first replica of each block is counted
+					j_list_append(bw_lists[index], (r == 0) ? bytes_written : &replica_bytes_written);
+				}
 
 				/*
 				if (lock != NULL)
@@ -1052,46 +1655,241 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 	{
 		g_autofree gpointer* background_data = NULL;
 
-		background_data = g_new(gpointer, server_count);
+		background_data = g_new(gpointer, server_count);
+
+		for (guint i = 0; i < server_count; i++)
+		{
+			JDistributedObjectBackgroundData* data;
+
+			if (messages[i] == NULL)
+			{
+				background_data[i] = NULL;
+				continue;
+			}
+
+			data = g_slice_new(JDistributedObjectBackgroundData);
+			data->index = i;
+			data->message = messages[i];
+			data->operations = NULL;
+			data->semantics = semantics;
+			data->write.bytes_written = bw_lists[i];
+			data->write.ret = &ret;
+
+			background_data[i] = data;
+		}
+
+		j_helper_execute_parallel(j_distributed_object_write_background_operation, background_data, server_count);
+	}
+
+	// Failed writes must not be recorded, the data might not have been written
+	if (ret)
+	{
+		ret = j_distributed_object_status_update(object, size, size, TRUE, semantics);
+	}
+
+	/*
+	if (lock != NULL)
+	{
+		// FIXME busy wait
+		while (!j_lock_acquire(lock));
+
+		j_lock_free(lock);
+	}
+	*/
+
+	return ret;
+}
+
+static gboolean
+j_distributed_object_status_scan_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	// FIXME check return value for messages
+	gboolean ret = TRUE;
+
+	JBackend* object_backend;
+	g_autoptr(JListIterator) it = NULL;
+	g_autofree JMessage** messages = NULL;
+	g_autofree gboolean* servers = NULL;
+	JDistributedObject* first_object = NULL;
+	gchar const* namespace = NULL;
+	gsize namespace_len = 0;
+	guint32 server_count = 0;
+
+	g_return_val_if_fail(operations != NULL, FALSE);
+	g_return_val_if_fail(semantics != NULL, FALSE);
+
+	{
+		JDistributedObjectOperation* operation = j_list_get_first(operations);
+		JDistributedObject* object = operation->status.object;
+
+		g_assert(operation != NULL);
+		g_assert(object != NULL);
+
+		first_object = object;
+		namespace = object->namespace;
+		namespace_len = strlen(namespace) + 1;
+	}
+
+	it = j_list_iterator_new(operations);
+	object_backend = j_object_get_backend();
+
+	if (object_backend == NULL)
+	{
+		server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
+		messages = g_new0(JMessage*, server_count);
+		servers = g_new(gboolean, server_count);
+
+		// All operations belong to the same object, so every server gets a reply entry for each of them
+		j_distributed_object_get_servers(first_object, semantics, servers, server_count);
+	}
+
+	while (j_list_iterator_next(it))
+	{
+		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+		JDistributedObject* object = operation->status.object;
+
+		operation->status.scan_modification_time = 0;
+		operation->status.scan_size = 0;
+
+		if (object_backend != NULL)
+		{
+			gpointer object_handle;
+
+			ret = j_backend_object_open(object_backend, object->namespace, object->name, &object_handle) && ret;
+			ret = j_backend_object_status(object_backend, object_handle, &(operation->status.scan_modification_time), &(operation->status.scan_size)) && ret;
+			ret = j_backend_object_close(object_backend, object_handle) && ret;
+		}
+		else
+		{
+			gsize name_len;
+
+			name_len = strlen(object->name) + 1;
+
+			for (guint i = 0; i < server_count; i++)
+			{
+				if (!servers[i])
+				{
+					continue;
+				}
+
+				if (messages[i] == NULL)
+				{
+					messages[i] = j_message_new(J_MESSAGE_OBJECT_STATUS, namespace_len);
+					j_message_set_semantics(messages[i], semantics);
+					j_message_append_n(messages[i], namespace, namespace_len);
+				}
+
+				j_message_add_operation(messages[i], name_len);
+				j_message_append_n(messages[i], object->name, name_len);
+			}
+		}
+	}
+
+	if (object_backend == NULL)
+	{
+		g_autofree gpointer* background_data = NULL;
+
+		// Servers without messages are skipped
+		background_data = g_new0(gpointer, server_count);
+
+		for (guint i = 0; i < server_count; i++)
+		{
+			JDistributedObjectBackgroundData* data;
+
+			if (messages[i] == NULL)
+			{
+				continue;
+			}
+
+			data = g_slice_new(JDistributedObjectBackgroundData);
+			data->index = i;
+			data->message = messages[i];
+			data->operations = operations;
+			data->semantics = semantics;
+
+			background_data[i] = data;
+		}
+
+		j_helper_execute_parallel(j_distributed_object_status_background_operation, background_data, server_count);
+	}
+
+	j_list_iterator_free(it);
+	it = j_list_iterator_new(operations);
+
+	while (j_list_iterator_next(it))
+	{
+		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+		gint64* modification_time = operation->status.modification_time;
+		guint64* size = operation->status.size;
+
+		if (modification_time != NULL)
+		{
+			*modification_time = operation->status.scan_modification_time;
+		}
+
+		if (size != NULL)
+		{
+			*size = operation->status.scan_size;
+		}
+	}
+
+	return ret;
+}
+
+static gboolean
+j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	g_autoptr(JList) scan_operations = NULL;
+	g_autoptr(JListIterator) it = NULL;
+
+	g_return_val_if_fail(operations != NULL, FALSE);
+	g_return_val_if_fail(semantics != NULL, FALSE);
 
-		for (guint i = 0; i < server_count; i++)
-		{
-			JDistributedObjectBackgroundData* data;
+	it = j_list_iterator_new(operations);
+	scan_operations = j_list_new(NULL);
 
-			if (messages[i] == NULL)
-			{
-				background_data[i] = NULL;
-				continue;
-			}
+	while (j_list_iterator_next(it))
+	{
+		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+		JDistributedObject* object = operation->status.object;
+		gint64* modification_time = operation->status.modification_time;
+		guint64* size = operation->status.size;
+		JDistributedObjectStatus status;
 
-			data = g_slice_new(JDistributedObjectBackgroundData);
-			data->index = i;
-			data->message = messages[i];
-			data->operations = NULL;
-			data->semantics = semantics;
-			data->write.bytes_written = bw_lists[i];
+		// Objects without a record have to be scanned
+		if (!j_distributed_object_status_get(object, &status, semantics))
+		{
+			j_list_append(scan_operations, operation);
+			continue;
+		}
 
-			background_data[i] = data;
+		if (modification_time != NULL)
+		{
+			*modification_time = status.modification_time;
 		}
 
-		j_helper_execute_parallel(j_distributed_object_write_background_operation, background_data, server_count);
+		if (size != NULL)
+		{
+			*size = status.size;
+		}
 	}
 
-	/*
-	if (lock != NULL)
+	if (j_list_length(scan_operations) > 0)
 	{
-		// FIXME busy wait
-		while (!j_lock_acquire(lock));
-
-		j_lock_free(lock);
+		ret = j_distributed_object_status_scan_exec(scan_operations, semantics);
 	}
-	*/
 
 	return ret;
 }
 
 static gboolean
-j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
+j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -1101,6 +1899,8 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 	JBackend* object_backend;
 	g_autoptr(JListIterator) it = NULL;
 	g_autofree JMessage** messages = NULL;
+	g_autofree gboolean* servers = NULL;
+	JDistributedObject* first_object = NULL;
 	gchar const* namespace = NULL;
 	gsize namespace_len = 0;
 	guint32 server_count = 0;
@@ -1110,11 +1910,12 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 
 	{
 		JDistributedObjectOperation* operation = j_list_get_first(operations);
-		JDistributedObject* object = operation->status.object;
+		JDistributedObject* object = operation->sync.object;
 
 		g_assert(operation != NULL);
 		g_assert(object != NULL);
 
+		first_object = object;
 		namespace = object->namespace;
 		namespace_len = strlen(namespace) + 1;
 	}
@@ -1125,40 +1926,24 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 	if (object_backend == NULL)
 	{
 		server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
-		messages = g_new(JMessage*, server_count);
+		messages = g_new0(JMessage*, server_count);
+		servers = g_new(gboolean, server_count);
 
-		// FIXME use actual distribution
-		for (guint i = 0; i < server_count; i++)
-		{
-			messages[i] = j_message_new(J_MESSAGE_OBJECT_STATUS, namespace_len);
-			j_message_set_semantics(messages[i], semantics);
-			j_message_append_n(messages[i], namespace, namespace_len);
-		}
+		// All operations belong to the same object
+		j_distributed_object_get_servers(first_object, semantics, servers, server_count);
 	}
 
 	while (j_list_iterator_next(it))
 	{
 		JDistributedObjectOperation* operation = j_list_iterator_get(it);
-		JDistributedObject* object = operation->status.object;
-		gint64* modification_time = operation->status.modification_time;
-		guint64* size = operation->status.size;
-
-		if (modification_time != NULL)
-		{
-			*modification_time = 0;
-		}
-
-		if (size != NULL)
-		{
-			*size = 0;
-		}
+		JDistributedObject* object = operation->sync.object;
 
 		if (object_backend != NULL)
 		{
 			gpointer object_handle;
 
 			ret = j_backend_object_open(object_backend, object->namespace, object->name, &object_handle) && ret;
-			ret = j_backend_object_status(object_backend, object_handle, modification_time, size) && ret;
+			ret = j_backend_object_sync(object_backend, object_handle) && ret;
 			ret = j_backend_object_close(object_backend, object_handle) && ret;
 		}
 		else
@@ -1167,9 +1952,20 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 
 			name_len = strlen(object->name) + 1;
 
-			// FIXME use actual distribution
 			for (guint i = 0; i < server_count; i++)
 			{
+				if (!servers[i])
+				{
+					continue;
+				}
+
+				if (messages[i] == NULL)
+				{
+					messages[i] = j_message_new(J_MESSAGE_OBJECT_SYNC, namespace_len);
+					j_message_set_semantics(messages[i], semantics);
+					j_message_append_n(messages[i], namespace, namespace_len);
+				}
+
 				j_message_add_operation(messages[i], name_len);
 				j_message_append_n(messages[i], object->name, name_len);
 			}
@@ -1180,13 +1976,18 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 	{
 		g_autofree gpointer* background_data = NULL;
 
-		background_data = g_new(gpointer, server_count);
+		// Servers without messages are skipped
+		background_data = g_new0(gpointer, server_count);
 
-		// FIXME use actual distribution
 		for (guint i = 0; i < server_count; i++)
 		{
 			JDistributedObjectBackgroundData* data;
 
+			if (messages[i] == NULL)
+			{
+				continue;
+			}
+
 			data = g_slice_new(JDistributedObjectBackgroundData);
 			data->index = i;
 			data->message = messages[i];
@@ -1196,23 +1997,115 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 			background_data[i] = data;
 		}
 
-		j_helper_execute_parallel(j_distributed_object_status_background_operation, background_data, server_count);
+		j_helper_execute_parallel(j_distributed_object_sync_background_operation, background_data, server_count);
 	}
 
 	return ret;
 }
 
+/**
+ * Copies an object through the client.
+ * This is necessary if the objects are distributed differently, because their stripes are then stored on different servers.
+ *
+ * \private
+ *
+ * \param object      An object.
+ * \param destination The destination object.
+ * \param semantics   A semantics object.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
 static gboolean
-j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
+j_distributed_object_copy_buffered(JDistributedObject* object, JDistributedObject* destination, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autofree gchar* buffer = NULL;
+	gint64 modification_time;
+	guint64 size;
+	guint64 offset = 0;
+	guint64 buffer_size = 4 * 1024 * 1024;
+
+	batch = j_batch_new(semantics);
+
+	j_distributed_object_status(object, &modification_time, &size, batch);
+
+	if (!j_batch_execute(batch))
+	{
+		return FALSE;
+	}
+
+	// Remove the destination's previous stripes, the destination might not exist
+	j_distributed_object_delete(destination, batch);
+
+	if (!j_batch_execute(batch))
+	{
+		g_debug("Could not delete destination object.");
+	}
+
+	j_distributed_object_create_with_size_hint(destination, size, batch);
+
+	if (!j_batch_execute(batch))
+	{
+		return FALSE;
+	}
+
+	if (size > 0)
+	{
+		buffer = g_malloc(MIN(size, buffer_size));
+	}
+
+	while (offset < size)
+	{
+		guint64 length;
+		guint64 bytes_read = 0;
+		guint64 bytes_written = 0;
+
+		length = MIN(size - offset, buffer_size);
+
+		j_distributed_object_read(object, buffer, length, offset, &bytes_read, batch);
+
+		if (!j_batch_execute(batch))
+		{
+			return FALSE;
+		}
+
+		if (bytes_read == 0)
+		{
+			break;
+		}
+
+		j_distributed_object_write(destination, buffer, bytes_read, offset, &bytes_written, batch);
+
+		if (!j_batch_execute(batch) || bytes_written != bytes_read)
+		{
+			return FALSE;
+		}
+
+		offset += bytes_read;
+
+		if (bytes_read < length)
+		{
+			break;
+		}
+	}
+
+	return TRUE;
+}
+
+static gboolean
+j_distributed_object_copy_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	// FIXME check return value for messages
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
 	g_autoptr(JListIterator) it = NULL;
 	g_autofree JMessage** messages = NULL;
+	g_autofree gboolean* servers = NULL;
+	g_autofree gboolean* destination_servers = NULL;
 	gchar const* namespace = NULL;
 	gsize namespace_len = 0;
 	guint32 server_count = 0;
@@ -1222,7 +2115,7 @@ j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
 
 	{
 		JDistributedObjectOperation* operation = j_list_get_first(operations);
-		JDistributedObject* object = operation->sync.object;
+		JDistributedObject* object = operation->copy.object;
 
 		g_assert(operation != NULL);
 		g_assert(object != NULL);
@@ -1237,41 +2130,111 @@ j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
 	if (object_backend == NULL)
 	{
 		server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
-		messages = g_new(JMessage*, server_count);
-
-		// FIXME use actual distribution
-		for (guint i = 0; i < server_count; i++)
-		{
-			messages[i] = j_message_new(J_MESSAGE_OBJECT_SYNC, namespace_len);
-			j_message_set_semantics(messages[i], semantics);
-			j_message_append_n(messages[i], namespace, namespace_len);
-		}
+		messages = g_new0(JMessage*, server_count);
+		servers = g_new(gboolean, server_count);
+		destination_servers = g_new(gboolean, server_count);
 	}
 
 	while (j_list_iterator_next(it))
 	{
 		JDistributedObjectOperation* operation = j_list_iterator_get(it);
-		JDistributedObject* object = operation->sync.object;
+		JDistributedObject* object = operation->copy.object;
+		JDistributedObject* destination = operation->copy.destination;
+		JDistributedObjectStatus status;
+
+		if (object_backend == NULL)
+		{
+			if (!operation->copy.same_distribution)
+			{
+				ret = j_distributed_object_copy_buffered(object, destination, semantics) && ret;
+				continue;
+			}
+
+			// Servers storing stale stripes of the destination have to be contacted, too, so the record has to be checked before it is replaced
+			j_distributed_object_get_servers(destination, semantics, destination_servers, server_count);
+		}
+
+		// The destination inherits the source's record, objects without one will be scanned
+		if (j_distributed_object_status_get(object, &status, semantics))
+		{
+			status.modification_time = g_get_real_time();
+			ret = j_distributed_object_status_set(destination, &status, semantics) && ret;
+		}
+		else
+		{
+			g_autoptr(JBatch) status_batch = NULL;
+
+			status_batch = j_batch_new(semantics);
+			j_kv_delete(destination->status, status_batch);
+
+			// The destination might not have a record either
+			if (!j_batch_execute(status_batch))
+			{
+				g_debug("Could not delete status record.");
+			}
+
+			j_distributed_object_status_cache_set(destination, NULL);
+		}
 
 		if (object_backend != NULL)
 		{
 			gpointer object_handle;
+			gpointer destination_handle;
+			guint64 bytes_copied;
+
+			if (!j_backend_object_open(object_backend, object->namespace, object->name, &object_handle))
+			{
+				ret = FALSE;
+				continue;
+			}
+
+			if (j_backend_object_create(object_backend, destination->namespace, destination->name, &destination_handle))
+			{
+				ret = j_backend_object_copy(object_backend, object_handle, destination_handle, &bytes_copied) && ret;
+				ret = j_backend_object_close(object_backend, destination_handle) && ret;
+			}
+			else
+			{
+				ret = FALSE;
+			}
 
-			ret = j_backend_object_open(object_backend, object->namespace, object->name, &object_handle) && ret;
-			ret = j_backend_object_sync(object_backend, object_handle) && ret;
 			ret = j_backend_object_close(object_backend, object_handle) && ret;
 		}
 		else
 		{
 			gsize name_len;
+			gsize destination_namespace_len;
+			gsize destination_name_len;
 
 			name_len = strlen(object->name) + 1;
+			destination_namespace_len = strlen(destination->namespace) + 1;
+			destination_name_len = strlen(destination->name) + 1;
 
-			// FIXME use actual distribution
+			j_distributed_object_get_servers(object, semantics, servers, server_count);
+
+			// Every server copies the stripes it stores and removes stale stripes of the destination
 			for (guint i = 0; i < server_count; i++)
 			{
-				j_message_add_operation(messages[i], name_len);
+				if (!servers[i] && !destination_servers[i])
+				{
+					continue;
+				}
+
+				if (messages[i] == NULL)
+				{
+					// Servers storing the destination's stripes but not the source's have to remove them
+					gchar remove_stale = 1;
+
+					messages[i] = j_message_new(J_MESSAGE_OBJECT_COPY, namespace_len + 1);
+					j_message_set_semantics(messages[i], semantics);
+					j_message_append_n(messages[i], namespace, namespace_len);
+					j_message_append_1(messages[i], &remove_stale);
+				}
+
+				j_message_add_operation(messages[i], name_len + destination_namespace_len + destination_name_len);
 				j_message_append_n(messages[i], object->name, name_len);
+				j_message_append_n(messages[i], destination->namespace, destination_namespace_len);
+				j_message_append_n(messages[i], destination->name, destination_name_len);
 			}
 		}
 	}
@@ -1280,23 +2243,29 @@ j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
 	{
 		g_autofree gpointer* background_data = NULL;
 
-		background_data = g_new(gpointer, server_count);
+		// Servers without messages are skipped
+		background_data = g_new0(gpointer, server_count);
 
-		// FIXME use actual distribution
 		for (guint i = 0; i < server_count; i++)
 		{
 			JDistributedObjectBackgroundData* data;
 
+			if (messages[i] == NULL)
+			{
+				continue;
+			}
+
 			data = g_slice_new(JDistributedObjectBackgroundData);
 			data->index = i;
 			data->message = messages[i];
 			data->operations = operations;
 			data->semantics = semantics;
+			data->copy.ret = &ret;
 
 			background_data[i] = data;
 		}
 
-		j_helper_execute_parallel(j_distributed_object_sync_background_operation, background_data, server_count);
+		j_helper_execute_parallel(j_distributed_object_copy_background_operation, background_data, server_count);
 	}
 
 	return ret;
@@ -1333,8 +2302,16 @@ j_distributed_object_new(gchar const* namespace, gchar const* name, JDistributio
 	object->namespace = g_strdup(namespace);
 	object->name = g_strdup(name);
 	object->distribution = j_distribution_ref(distribution);
+	object->status_cached = FALSE;
 	object->ref_count = 1;
 
+	{
+		g_autofree gchar* status_namespace = NULL;
+
+		status_namespace = g_strconcat("distributed-object:", namespace, NULL);
+		object->status = j_kv_new(status_namespace, name);
+	}
+
 	return object;
 }
 
@@ -1385,6 +2362,7 @@ j_distributed_object_unref(JDistributedObject* object)
 		g_free(object->namespace);
 
 		j_distribution_unref(object->distribution);
+		j_kv_unref(object->status);
 
 		g_slice_free(JDistributedObject, object);
 	}
@@ -1407,14 +2385,45 @@ j_distributed_object_create(JDistributedObject* object, JBatch* batch)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	j_distributed_object_create_with_size_hint(object, 0, batch);
+}
+
+/**
+ * Creates an object and preallocates storage for it.
+ * The hint does not change the object's size but allows the backends to allocate contiguous space.
+ * Additionally, the object's distribution is adapted to the hint, see j_distribution_adapt().
+ *
+ * \code
+ * // The object will be filled with 1 GiB of data
+ * j_distributed_object_create_with_size_hint(object, 1024 * 1024 * 1024, batch);
+ * j_distributed_object_write(object, data, 1024 * 1024 * 1024, 0, &bytes_written, batch);
+ * \endcode
+ *
+ * \param object    An object.
+ * \param size_hint The expected size of the object, 0 if unknown.
+ * \param batch     A batch.
+ **/
+void
+j_distributed_object_create_with_size_hint(JDistributedObject* object, guint64 size_hint, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributedObjectOperation* iop;
 	JOperation* operation;
 
 	g_return_if_fail(object != NULL);
 
+	// The layout has to be chosen before any data is written
+	j_distribution_adapt(object->distribution, size_hint);
+
+	iop = g_slice_new(JDistributedObjectOperation);
+	iop->create.object = j_distributed_object_ref(object);
+	iop->create.size_hint = size_hint;
+
 	operation = j_operation_new();
 	// FIXME key = index + namespace
 	operation->key = object;
-	operation->data = j_distributed_object_ref(object);
+	operation->data = iop;
 	operation->exec_func = j_distributed_object_create_exec;
 	operation->free_func = j_distributed_object_create_free;
 
@@ -1571,6 +2580,8 @@ j_distributed_object_write(JDistributedObject* object, gconstpointer data, guint
 
 /**
  * Get the status of an object.
+ * The status is answered from the object's metadata record, which is updated by create, write and copy operations.
+ * Objects without a record are scanned like with j_distributed_object_status_scan().
  *
  * \code
  * \endcode
@@ -1602,6 +2613,42 @@ j_distributed_object_status(JDistributedObject* object, gint64* modification_tim
 	j_batch_add(batch, operation);
 }
 
+/**
+ * Get the status of an object by querying all servers.
+ * Other than j_distributed_object_status(), this does not rely on the object's metadata record but repairs it.
+ *
+ * \code
+ * \endcode
+ *
+ * \param object            An object.
+ * \param modification_time A modification time.
+ * \param size              A size.
+ * \param batch             A batch.
+ **/
+void
+j_distributed_object_status_scan(JDistributedObject* object, gint64* modification_time, guint64* size, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributedObjectOperation* iop;
+	JOperation* operation;
+
+	g_return_if_fail(object != NULL);
+
+	iop = g_slice_new(JDistributedObjectOperation);
+	iop->status.object = j_distributed_object_ref(object);
+	iop->status.modification_time = modification_time;
+	iop->status.size = size;
+
+	operation = j_operation_new();
+	operation->key = object;
+	operation->data = iop;
+	operation->exec_func = j_distributed_object_status_scan_exec;
+	operation->free_func = j_distributed_object_status_free;
+
+	j_batch_add(batch, operation);
+}
+
 /**
  * Sync an object.
  *
@@ -1633,6 +2680,56 @@ j_distributed_object_sync(JDistributedObject* object, JBatch* batch)
 	j_batch_add(batch, operation);
 }
 
+/**
+ * Copies an object.
+ * If both objects are distributed in the same way, each object server copies the stripes it stores locally, so the data is not transferred to the client.
+ * Otherwise, the data is read and written by the client.
+ * The destination object is created if necessary and its previous data is replaced.
+ *
+ * \code
+ * JDistributedObject* object;
+ * JDistributedObject* destination;
+ *
+ * j_distributed_object_copy(object, destination, batch);
+ * \endcode
+ *
+ * \param object      An object.
+ * \param destination The destination object.
+ * \param batch       A batch.
+ **/
+void
+j_distributed_object_copy(JDistributedObject* object, JDistributedObject* destination, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDistributedObjectOperation* iop;
+	JOperation* operation;
+	bson_t* distribution;
+	bson_t* destination_distribution;
+
+	g_return_if_fail(object != NULL);
+	g_return_if_fail(destination != NULL);
+
+	iop = g_slice_new(JDistributedObjectOperation);
+	iop->copy.object = j_distributed_object_ref(object);
+	iop->copy.destination = j_distributed_object_ref(destination);
+
+	// Stripes can only be copied locally if both objects are distributed in the same way
+	distribution = j_distribution_serialize(object->distribution);
+	destination_distribution = j_distribution_serialize(destination->distribution);
+	iop->copy.same_distribution = bson_equal(distribution, destination_distribution);
+	bson_destroy(distribution);
+	bson_destroy(destination_distribution);
+
+	operation = j_operation_new();
+	operation->key = object;
+	operation->data = iop;
+	operation->exec_func = j_distributed_object_copy_exec;
+	operation->free_func = j_distributed_object_copy_free;
+
+	j_batch_add(batch, operation);
+}
+
 /**
  * @}
  **/
@@ -43,6 +43,12 @@ struct JObjectOperation
 {
 	union
 	{
+		struct
+		{
+			JObject* object;
+			guint64 size_hint;
+		} create;
+
 		struct
 		{
 			JObject* object;
@@ -72,6 +78,12 @@ struct JObjectOperation
 			guint64 offset;
 			guint64* bytes_written;
 		} write;
+
+		struct
+		{
+			JObject* object;
+			JObject* destination;
+		} copy;
 	};
 };
 
@@ -167,9 +179,11 @@ j_object_create_free(gpointer data)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JObject* object = data;
+	JObjectOperation* operation = data;
 
-	j_object_unref(object);
+	j_object_unref(operation->create.object);
+
+	g_slice_free(JObjectOperation, operation);
 }
 
 static void
@@ -230,6 +244,19 @@ j_object_write_free(gpointer data)
 	g_slice_free(JObjectOperation, operation);
 }
 
+static void
+j_object_copy_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JObjectOperation* operation = data;
+
+	j_object_unref(operation->copy.object);
+	j_object_unref(operation->copy.destination);
+
+	g_slice_free(JObjectOperation, operation);
+}
+
 static gboolean
 j_object_create_exec(JList* operations, JSemantics* semantics)
 {
@@ -249,9 +276,10 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JObject* object;
+		JObjectOperation* operation = j_list_get_first(operations);
+		JObject* object = operation->create.object;
 
-		object = j_list_get_first(operations);
+		g_assert(operation != NULL);
 		g_assert(object != NULL);
 
 		namespace = object->namespace;
@@ -279,14 +307,28 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 
 	while (j_list_iterator_next(it))
 	{
-		JObject* object = j_list_iterator_get(it);
+		JObjectOperation* operation = j_list_iterator_get(it);
+		JObject* object = operation->create.object;
+		guint64 size_hint = operation->create.size_hint;
 
 		if (object_backend != NULL)
 		{
 			gpointer object_handle;
 
-			ret = j_backend_object_create(object_backend, object->namespace, object->name, &object_handle) && ret;
-			ret = j_backend_object_close(object_backend, object_handle) && ret;
+			if (j_backend_object_create(object_backend, object->namespace, object->name, &object_handle))
+			{
+				if (size_hint > 0)
+				{
+					// The hint is only an optimization
+					j_backend_object_allocate(object_backend, object_handle, size_hint, 0);
+				}
+
+				ret = j_backend_object_close(object_backend, object_handle) && ret;
+			}
+			else
+			{
+				ret = FALSE;
+			}
 		}
 		else
 		{
@@ -294,8 +336,9 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 
 			name_len = strlen(object->name) + 1;
 
-			j_message_add_operation(message, name_len);
+			j_message_add_operation(message, name_len + sizeof(guint64));
 			j_message_append_n(message, object->name, name_len);
+			j_message_append_8(message, &size_hint);
 		}
 	}
 
@@ -540,16 +583,8 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 
 				guint64 nbytes;
 
-				nbytes = j_message_get_8(reply);
+				nbytes = j_object_receive_read_reply(reply, object_connection, data);
 				j_helper_atomic_add(bytes_read, nbytes);
-
-				if (nbytes > 0)
-				{
-					GInputStream* input;
-
-					input = g_io_stream_get_input_stream(G_IO_STREAM(object_connection));
-					g_input_stream_read_all(input, data, nbytes, NULL, NULL, NULL);
-				}
 			}
 
 			operations_done += reply_operation_count;
@@ -578,7 +613,6 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	// FIXME check return value for messages
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
@@ -613,14 +647,17 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 	{
 		gsize name_len;
 		gsize namespace_len;
+		gchar create = 0;
 
 		namespace_len = strlen(object->namespace) + 1;
 		name_len = strlen(object->name) + 1;
 
-		message = j_message_new(J_MESSAGE_OBJECT_WRITE, namespace_len + name_len);
+		// Objects have to be created explicitly
+		message = j_message_new(J_MESSAGE_OBJECT_WRITE, namespace_len + name_len + 1);
 		j_message_set_semantics(message, semantics);
 		j_message_append_n(message, object->namespace, namespace_len);
 		j_message_append_n(message, object->name, name_len);
+		j_message_append_1(message, &create);
 	}
 
 	/*
@@ -704,6 +741,8 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 
 				nbytes = j_message_get_8(reply);
 				j_helper_atomic_add(bytes_written, nbytes);
+
+				ret = (j_message_get_1(reply) != 0) && ret;
 			}
 
 			j_list_iterator_free(it);
@@ -927,6 +966,134 @@ j_object_sync_exec(JList* operations, JSemantics* semantics)
 	return ret;
 }
 
+static gboolean
+j_object_copy_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	JBackend* object_backend;
+	g_autoptr(JListIterator) it = NULL;
+	g_autoptr(JMessage) message = NULL;
+	gchar const* namespace;
+	gsize namespace_len;
+	guint32 index;
+
+	g_return_val_if_fail(operations != NULL, FALSE);
+	g_return_val_if_fail(semantics != NULL, FALSE);
+
+	{
+		JObjectOperation* operation = j_list_get_first(operations);
+		JObject* object = operation->copy.object;
+
+		g_assert(operation != NULL);
+		g_assert(object != NULL);
+
+		namespace = object->namespace;
+		namespace_len = strlen(namespace) + 1;
+		index = object->index;
+	}
+
+	it = j_list_iterator_new(operations);
+	object_backend = j_object_get_backend();
+
+	if (object_backend == NULL)
+	{
+		// Copying a missing object fails instead of removing the destination
+		gchar remove_stale = 0;
+
+		message = j_message_new(J_MESSAGE_OBJECT_COPY, namespace_len + 1);
+		j_message_set_semantics(message, semantics);
+		j_message_append_n(message, namespace, namespace_len);
+		j_message_append_1(message, &remove_stale);
+	}
+
+	while (j_list_iterator_next(it))
+	{
+		JObjectOperation* operation = j_list_iterator_get(it);
+		JObject* object = operation->copy.object;
+		JObject* destination = operation->copy.destination;
+
+		if (object_backend != NULL)
+		{
+			gpointer object_handle;
+			gpointer destination_handle;
+			guint64 bytes_copied;
+
+			if (!j_backend_object_open(object_backend, object->namespace, object->name, &object_handle))
+			{
+				ret = FALSE;
+				continue;
+			}
+
+			if (j_backend_object_create(object_backend, destination->namespace, destination->name, &destination_handle))
+			{
+				ret = j_backend_object_copy(object_backend, object_handle, destination_handle, &bytes_copied) && ret;
+				ret = j_backend_object_close(object_backend, destination_handle) && ret;
+			}
+			else
+			{
+				ret = FALSE;
+			}
+
+			ret = j_backend_object_close(object_backend, object_handle) && ret;
+		}
+		else
+		{
+			gsize name_len;
+			gsize destination_namespace_len;
+			gsize destination_name_len;
+
+			name_len = strlen(object->name) + 1;
+			destination_namespace_len = strlen(destination->namespace) + 1;
+			destination_name_len = strlen(destination->name) + 1;
+
+			j_message_add_operation(message, name_len + destination_namespace_len + destination_name_len);
+			j_message_append_n(message, object->name, name_len);
+			j_message_append_n(message, destination->namespace, destination_namespace_len);
+			j_message_append_n(message, destination->name, destination_name_len);
+		}
+	}
+
+	if (object_backend == NULL)
+	{
+		JSemanticsSafety safety;
+		gpointer object_connection;
+
+		safety = j_semantics_get(semantics, J_SEMANTICS_SAFETY);
+		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, index);
+		j_message_send(message, object_connection);
+
+		if (safety == J_SEMANTICS_SAFETY_NETWORK || safety == J_SEMANTICS_SAFETY_STORAGE)
+		{
+			g_autoptr(JMessage) reply = NULL;
+
+			reply = j_message_new_reply(message);
+
+			if (j_message_receive(reply, object_connection))
+			{
+				guint32 reply_count;
+
+				reply_count = j_message_get_count(reply);
+
+				for (guint32 i = 0; i < reply_count; i++)
+				{
+					ret = (j_message_get_1(reply) != 0) && ret;
+				}
+			}
+			else
+			{
+				ret = FALSE;
+			}
+		}
+
+		j_connection_pool_push(J_BACKEND_TYPE_OBJECT, index, object_connection);
+	}
+
+	return ret;
+}
+
 /**
  * Creates a new object.
  *
@@ -997,6 +1164,42 @@ j_object_new_for_index(guint32 index, gchar const* namespace, gchar const* name)
 	return object;
 }
 
+/**
+ * Creates a new object on the local object server.
+ * If no object server runs on the local host, the object is placed as with j_object_new().
+ *
+ * Other clients compute a different index for the same name.
+ * This is therefore only suitable for node-local data, such as temporary or checkpoint data that is only accessed from the node that created it.
+ *
+ * \code
+ * JObject* i;
+ *
+ * i = j_object_new_local("JULEA", "JULEA");
+ * \endcode
+ *
+ * \param namespace    A namespace.
+ * \param name         An object name.
+ *
+ * \return A new object. Should be freed with j_object_unref().
+ **/
+JObject*
+j_object_new_local(gchar const* namespace, gchar const* name)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 index;
+
+	g_return_val_if_fail(namespace != NULL, NULL);
+	g_return_val_if_fail(name != NULL, NULL);
+
+	if (!j_configuration_get_local_server(j_configuration(), J_BACKEND_TYPE_OBJECT, &index))
+	{
+		return j_object_new(namespace, name);
+	}
+
+	return j_object_new_for_index(index, namespace, name);
+}
+
 /**
  * Increases an object's reference count.
  *
@@ -1064,14 +1267,41 @@ j_object_create(JObject* object, JBatch* batch)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	j_object_create_with_size_hint(object, 0, batch);
+}
+
+/**
+ * Creates an object and preallocates storage for it.
+ * The hint does not change the object's size but allows the backend to allocate contiguous space.
+ *
+ * \code
+ * // The object will be filled with 1 GiB of data
+ * j_object_create_with_size_hint(object, 1024 * 1024 * 1024, batch);
+ * j_object_write(object, data, 1024 * 1024 * 1024, 0, &bytes_written, batch);
+ * \endcode
+ *
+ * \param object    An object.
+ * \param size_hint The expected size of the object, 0 if unknown.
+ * \param batch     A batch.
+ **/
+void
+j_object_create_with_size_hint(JObject* object, guint64 size_hint, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JObjectOperation* iop;
 	JOperation* operation;
 
 	g_return_if_fail(object != NULL);
 
+	iop = g_slice_new(JObjectOperation);
+	iop->create.object = j_object_ref(object);
+	iop->create.size_hint = size_hint;
+
 	operation = j_operation_new();
 	// FIXME key = index + namespace
 	operation->key = object;
-	operation->data = j_object_ref(object);
+	operation->data = iop;
 	operation->exec_func = j_object_create_exec;
 	operation->free_func = j_object_create_free;
 
@@ -1290,6 +1520,53 @@ j_object_sync(JObject* object, JBatch* batch)
 	j_batch_add(batch, operation);
 }
 
+/**
+ * Copies an object.
+ * The data is copied by the object server without being transferred to the client.
+ * The destination object is created if necessary and its previous data is replaced.
+ *
+ * \code
+ * g_autoptr(JBatch) batch = NULL;
+ * g_autoptr(JObject) object = NULL;
+ * g_autoptr(JObject) destination = NULL;
+ *
+ * batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+ * object = j_object_new("JULEA", "source");
+ * destination = j_object_new("JULEA", "destination");
+ *
+ * j_object_copy(object, destination, batch);
+ * j_batch_execute(batch);
+ * \endcode
+ *
+ * \param object      An object.
+ * \param destination The destination object. Must be stored on the same object server as #object.
+ * \param batch       A batch.
+ **/
+void
+j_object_copy(JObject* object, JObject* destination, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JObjectOperation* iop;
+	JOperation* operation;
+
+	g_return_if_fail(object != NULL);
+	g_return_if_fail(destination != NULL);
+	g_return_if_fail(object->index == destination->index);
+
+	iop = g_slice_new(JObjectOperation);
+	iop->copy.object = j_object_ref(object);
+	iop->copy.destination = j_object_ref(destination);
+
+	operation = j_operation_new();
+	operation->key = object;
+	operation->data = iop;
+	operation->exec_func = j_object_copy_exec;
+	operation->free_func = j_object_copy_free;
+
+	j_batch_add(batch, operation);
+}
+
 /**
  * Returns the object backend.
  *
@@ -1301,6 +1578,61 @@ j_object_get_backend(void)
 	return j_object_backend;
 }
 
+/**
+ * Receives the data of a read operation's reply.
+ * Holes are not transmitted by the server and are filled with zeros instead.
+ *
+ * \param reply      The reply.
+ * \param connection The connection.
+ * \param data       The buffer to read into.
+ *
+ * \return The number of bytes read.
+ */
+guint64
+j_object_receive_read_reply(JMessage* reply, gpointer connection, gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GInputStream* input;
+	gchar* buffer = data;
+	guint64 nbytes;
+	guint64 position = 0;
+	guint32 hole_count;
+
+	g_return_val_if_fail(reply != NULL, 0);
+	g_return_val_if_fail(connection != NULL, 0);
+	g_return_val_if_fail(data != NULL, 0);
+
+	input = g_io_stream_get_input_stream(G_IO_STREAM(connection));
+
+	nbytes = j_message_get_8(reply);
+	hole_count = j_message_get_4(reply);
+
+	for (guint32 i = 0; i < hole_count; i++)
+	{
+		guint64 hole_offset;
+		guint64 hole_length;
+
+		hole_offset = j_message_get_8(reply);
+		hole_length = j_message_get_8(reply);
+
+		if (hole_offset > position)
+		{
+			g_input_stream_read_all(input, buffer + position, hole_offset - position, NULL, NULL, NULL);
+		}
+
+		memset(buffer + hole_offset, 0, hole_length);
+		position = hole_offset + hole_length;
+	}
+
+	if (position < nbytes)
+	{
+		g_input_stream_read_all(input, buffer + position, nbytes - position, NULL, NULL, NULL);
+	}
+
+	return nbytes;
+}
+
 /**
  * @}
  **/
@@ -0,0 +1,210 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <julea.h>
+
+#include "server.h"
+
+/**
+ * Cursors that have not been used for this many seconds are closed.
+ * This cleans up after clients that stop in the middle of an iteration without closing their cursors.
+ **/
+#define JD_CURSOR_TIMEOUT 60
+
+/**
+ * A key-value iterator that is kept open between pages.
+ **/
+struct JDCursor
+{
+	gpointer iterator;
+	gint64 last_used;
+};
+
+typedef struct JDCursor JDCursor;
+
+static GHashTable* jd_cursors = NULL;
+static guint jd_cursor_timeout_source = 0;
+
+G_LOCK_DEFINE_STATIC(jd_cursors);
+
+/**
+ * Closes cursors that have timed out.
+ * Called periodically by the main loop.
+ **/
+static gboolean
+jd_cursor_timeout(gpointer data)
+{
+	GHashTableIter iter;
+	GSList* removed = NULL;
+	gpointer value;
+	gint64 now;
+
+	(void)data;
+
+	now = g_get_monotonic_time();
+
+	G_LOCK(jd_cursors);
+
+	g_hash_table_iter_init(&iter, jd_cursors);
+
+	while (g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		JDCursor* cursor = value;
+
+		if (now - cursor->last_used > JD_CURSOR_TIMEOUT * G_USEC_PER_SEC)
+		{
+			removed = g_slist_prepend(removed, cursor);
+			g_hash_table_iter_remove(&iter);
+		}
+	}
+
+	G_UNLOCK(jd_cursors);
+
+	// Freeing iterators can take a while, do not block other connections
+	for (GSList* l = removed; l != NULL; l = l->next)
+	{
+		JDCursor* cursor = l->data;
+
+		j_backend_kv_iterator_free(jd_kv_backend, cursor->iterator);
+		g_slice_free(JDCursor, cursor);
+	}
+
+	g_slist_free(removed);
+
+	return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Initializes the cursors.
+ **/
+void
+jd_cursor_init(void)
+{
+	jd_cursors = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, NULL);
+	jd_cursor_timeout_source = g_timeout_add_seconds(JD_CURSOR_TIMEOUT, jd_cursor_timeout, NULL);
+}
+
+/**
+ * Closes all remaining cursors.
+ **/
+void
+jd_cursor_fini(void)
+{
+	GHashTableIter iter;
+	gpointer value;
+
+	g_source_remove(jd_cursor_timeout_source);
+	jd_cursor_timeout_source = 0;
+
+	g_hash_table_iter_init(&iter, jd_cursors);
+
+	while (g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		JDCursor* cursor = value;
+
+		j_backend_kv_iterator_free(jd_kv_backend, cursor->iterator);
+		g_slice_free(JDCursor, cursor);
+	}
+
+	g_hash_table_destroy(jd_cursors);
+	jd_cursors = NULL;
+}
+
+/**
+ * Stores an open key-value iterator so that the client can continue it later.
+ * Cursors can be used from any connection, their IDs are random so that other clients cannot guess them.
+ *
+ * \param iterator A key-value iterator.
+ *
+ * \return The cursor's ID, which is never 0.
+ **/
+guint64
+jd_cursor_add(gpointer iterator)
+{
+	JDCursor* cursor;
+	guint64 id;
+
+	cursor = g_slice_new(JDCursor);
+	cursor->iterator = iterator;
+	cursor->last_used = g_get_monotonic_time();
+
+	G_LOCK(jd_cursors);
+
+	do
+	{
+		id = ((guint64)g_random_int() << 32) | g_random_int();
+	} while (id == 0 || g_hash_table_contains(jd_cursors, &id));
+
+	g_hash_table_insert(jd_cursors, g_memdup(&id, sizeof(id)), cursor);
+
+	G_UNLOCK(jd_cursors);
+
+	return id;
+}
+
+/**
+ * Removes a cursor, giving exclusive access to its iterator.
+ *
+ * \param id A cursor ID.
+ *
+ * \return The key-value iterator, NULL if the cursor does not exist (anymore).
+ **/
+gpointer
+jd_cursor_take(guint64 id)
+{
+	gpointer iterator = NULL;
+	JDCursor* cursor;
+
+	G_LOCK(jd_cursors);
+
+	cursor = g_hash_table_lookup(jd_cursors, &id);
+
+	if (cursor != NULL)
+	{
+		g_hash_table_remove(jd_cursors, &id);
+
+		iterator = cursor->iterator;
+		g_slice_free(JDCursor, cursor);
+	}
+
+	G_UNLOCK(jd_cursors);
+
+	return iterator;
+}
+
+/**
+ * Closes a cursor.
+ *
+ * \param id A cursor ID.
+ **/
+void
+jd_cursor_close(guint64 id)
+{
+	gpointer iterator;
+
+	iterator = jd_cursor_take(id);
+
+	if (iterator != NULL)
+	{
+		j_backend_kv_iterator_free(jd_kv_backend, iterator);
+	}
+}
@@ -0,0 +1,451 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <string.h>
+
+#include <julea.h>
+
+#include "server.h"
+
+/**
+ * Number of locks protecting inline objects.
+ * Objects are mapped onto the locks based on their hash.
+ **/
+#define JD_INLINE_LOCKS 64
+
+/**
+ * Prefix of the key-value namespaces used for inline objects.
+ **/
+#define JD_INLINE_NAMESPACE_PREFIX "object-inline:"
+
+/**
+ * The maximum size of inline objects, 0 if disabled.
+ **/
+static guint64 jd_inline_threshold = 0;
+
+static GMutex jd_inline_locks[JD_INLINE_LOCKS];
+
+static GMutex*
+jd_inline_lock(gchar const* namespace, gchar const* path)
+{
+	return &(jd_inline_locks[(g_str_hash(namespace) ^ g_str_hash(path)) % JD_INLINE_LOCKS]);
+}
+
+/**
+ * Gets an inline object.
+ * The value consists of the modification time followed by the object's data.
+ **/
+static gboolean
+jd_inline_get(gpointer batch, gchar const* path, gchar** value, guint32* len)
+{
+	gpointer data;
+
+	if (!j_backend_kv_get(jd_kv_backend, batch, path, &data, len))
+	{
+		return FALSE;
+	}
+
+	// Values not written by us
+	if (*len < sizeof(gint64))
+	{
+		g_free(data);
+		return FALSE;
+	}
+
+	*value = data;
+
+	return TRUE;
+}
+
+static gboolean
+jd_inline_put(gpointer batch, gchar const* path, gchar const* data, guint64 length)
+{
+	g_autofree gchar* value = NULL;
+	gint64 modification_time;
+
+	modification_time = g_get_real_time();
+
+	value = g_malloc(sizeof(gint64) + length);
+	memcpy(value, &modification_time, sizeof(gint64));
+
+	if (length > 0)
+	{
+		memcpy(value + sizeof(gint64), data, length);
+	}
+
+	return j_backend_kv_put(jd_kv_backend, batch, path, value, sizeof(gint64) + length);
+}
+
+/**
+ * Enables inline objects.
+ * Objects smaller than the threshold are stored in the key-value backend instead of the object backend.
+ * This avoids creating files for small objects.
+ *
+ * \param threshold The maximum size of inline objects, 0 to disable them.
+ **/
+void
+jd_inline_init(guint64 threshold)
+{
+	for (guint i = 0; i < JD_INLINE_LOCKS; i++)
+	{
+		g_mutex_init(&(jd_inline_locks[i]));
+	}
+
+	jd_inline_threshold = threshold;
+}
+
+/**
+ * Shuts down inline objects.
+ **/
+void
+jd_inline_fini(void)
+{
+	for (guint i = 0; i < JD_INLINE_LOCKS; i++)
+	{
+		g_mutex_clear(&(jd_inline_locks[i]));
+	}
+
+	jd_inline_threshold = 0;
+}
+
+/**
+ * Creates an inline object.
+ * Objects that are expected to grow beyond the threshold or already exist in the object backend are not created inline.
+ *
+ * \return TRUE if the object has been created inline or already exists inline, FALSE if it has to be created in the object backend.
+ **/
+gboolean
+jd_inline_create(gchar const* namespace, gchar const* path, guint64 size_hint, JSemantics* semantics)
+{
+	g_autofree gchar* kv_namespace = NULL;
+	g_autofree gchar* value = NULL;
+	GMutex* lock;
+	gpointer batch;
+	gpointer object;
+	guint32 len;
+	gboolean ret = TRUE;
+
+	if (jd_inline_threshold == 0)
+	{
+		return FALSE;
+	}
+
+	kv_namespace = g_strconcat(JD_INLINE_NAMESPACE_PREFIX, namespace, NULL);
+	lock = jd_inline_lock(namespace, path);
+
+	g_mutex_lock(lock);
+
+	if (!j_backend_kv_batch_start(jd_kv_backend, kv_namespace, semantics, &batch))
+	{
+		g_mutex_unlock(lock);
+		return FALSE;
+	}
+
+	// Creating an existing object must not truncate it, large ones are promoted by their first write
+	if (!jd_inline_get(batch, path, &value, &len))
+	{
+		if (size_hint > jd_inline_threshold)
+		{
+			ret = FALSE;
+		}
+		else if (j_backend_object_open(jd_object_backend, namespace, path, &object))
+		{
+			// An empty inline object would shadow an object that has already been promoted
+			j_backend_object_close(jd_object_backend, object);
+			ret = FALSE;
+		}
+		else
+		{
+			ret = jd_inline_put(batch, path, NULL, 0);
+		}
+	}
+
+	ret = j_backend_kv_batch_execute(jd_kv_backend, batch) && ret;
+
+	g_mutex_unlock(lock);
+
+	return ret;
+}
+
+/**
+ * Deletes an inline object.
+ *
+ * \return TRUE if an inline object has been deleted, FALSE otherwise.
+ **/
+gboolean
+jd_inline_delete(gchar const* namespace, gchar const* path, JSemantics* semantics)
+{
+	g_autofree gchar* kv_namespace = NULL;
+	g_autofree gchar* value = NULL;
+	GMutex* lock;
+	gpointer batch;
+	guint32 len;
+	gboolean ret = FALSE;
+
+	if (jd_inline_threshold == 0)
+	{
+		return FALSE;
+	}
+
+	kv_namespace = g_strconcat(JD_INLINE_NAMESPACE_PREFIX, namespace, NULL);
+	lock = jd_inline_lock(namespace, path);
+
+	g_mutex_lock(lock);
+
+	if (j_backend_kv_batch_start(jd_kv_backend, kv_namespace, semantics, &batch))
+	{
+		if (jd_inline_get(batch, path, &value, &len))
+		{
+			ret = j_backend_kv_delete(jd_kv_backend, batch, path);
+		}
+
+		ret = j_backend_kv_batch_execute(jd_kv_backend, batch) && ret;
+	}
+
+	g_mutex_unlock(lock);
+
+	return ret;
+}
+
+/**
+ * Returns the status of an inline object.
+ *
+ * \return TRUE if the object is stored inline, FALSE otherwise.
+ **/
+gboolean
+jd_inline_status(gchar const* namespace, gchar const* path, JSemantics* semantics, gint64* modification_time, guint64* size)
+{
+	g_autofree gchar* kv_namespace = NULL;
+	g_autofree gchar* value = NULL;
+	gpointer batch;
+	guint32 len;
+	gboolean ret = FALSE;
+
+	if (jd_inline_threshold == 0)
+	{
+		return FALSE;
+	}
+
+	kv_namespace = g_strconcat(JD_INLINE_NAMESPACE_PREFIX, namespace, NULL);
+
+	if (j_backend_kv_batch_start(jd_kv_backend, kv_namespace, semantics, &batch))
+	{
+		ret = jd_inline_get(batch, path, &value, &len);
+		j_backend_kv_batch_execute(jd_kv_backend, batch);
+	}
+
+	if (ret)
+	{
+		memcpy(modification_time, value, sizeof(gint64));
+		*size = len - sizeof(gint64);
+	}
+
+	return ret;
+}
+
+/**
+ * Reads from an inline object.
+ *
+ * \return TRUE if the object is stored inline, FALSE otherwise.
+ **/
+gboolean
+jd_inline_read(gchar const* namespace, gchar const* path, JSemantics* semantics, gpointer buffer, guint64 length, guint64 offset, guint64* bytes_read)
+{
+	g_autofree gchar* kv_namespace = NULL;
+	g_autofree gchar* value = NULL;
+	gpointer batch;
+	guint32 len;
+	guint64 size;
+	gboolean ret = FALSE;
+
+	if (jd_inline_threshold == 0)
+	{
+		return FALSE;
+	}
+
+	kv_namespace = g_strconcat(JD_INLINE_NAMESPACE_PREFIX, namespace, NULL);
+
+	if (j_backend_kv_batch_start(jd_kv_backend, kv_namespace, semantics, &batch))
+	{
+		ret = jd_inline_get(batch, path, &value, &len);
+		j_backend_kv_batch_execute(jd_kv_backend, batch);
+	}
+
+	if (ret)
+	{
+		size = len - sizeof(gint64);
+		*bytes_read = 0;
+
+		if (offset < size)
+		{
+			*bytes_read = MIN(length, size - offset);
+			memcpy(buffer, value + sizeof(gint64) + offset, *bytes_read);
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * Writes to an inline object.
+ * If the object would grow beyond the threshold, it is promoted to a real object.
+ *
+ * \return TRUE if the data has been written inline, FALSE if it has to be written to the object backend.
+ **/
+gboolean
+jd_inline_write(gchar const* namespace, gchar const* path, JSemantics* semantics, gconstpointer buffer, guint64 length, guint64 offset, guint64* bytes_written)
+{
+	g_autofree gchar* kv_namespace = NULL;
+	g_autofree gchar* value = NULL;
+	GMutex* lock;
+	gpointer batch;
+	guint32 len;
+	guint64 size;
+	gboolean ret = FALSE;
+
+	if (jd_inline_threshold == 0)
+	{
+		return FALSE;
+	}
+
+	kv_namespace = g_strconcat(JD_INLINE_NAMESPACE_PREFIX, namespace, NULL);
+	lock = jd_inline_lock(namespace, path);
+
+	g_mutex_lock(lock);
+
+	if (!j_backend_kv_batch_start(jd_kv_backend, kv_namespace, semantics, &batch))
+	{
+		g_mutex_unlock(lock);
+		return FALSE;
+	}
+
+	if (jd_inline_get(batch, path, &value, &len))
+	{
+		size = len - sizeof(gint64);
+
+		if (offset + length <= jd_inline_threshold)
+		{
+			g_autofree gchar* data = NULL;
+			guint64 new_size;
+
+			new_size = MAX(size, offset + length);
+
+			// Gaps are filled with zeros
+			data = g_malloc0(new_size);
+			memcpy(data, value + sizeof(gint64), size);
+			memcpy(data + offset, buffer, length);
+
+			ret = jd_inline_put(batch, path, data, new_size);
+			*bytes_written = (ret) ? length : 0;
+		}
+		else
+		{
+			gpointer object;
+
+			// Promote the object, the caller then writes to the object backend
+			if (j_backend_object_create(jd_object_backend, namespace, path, &object))
+			{
+				guint64 nbytes = 0;
+
+				if (size == 0 || j_backend_object_write(jd_object_backend, object, value + sizeof(gint64), size, 0, &nbytes))
+				{
+					j_backend_kv_delete(jd_kv_backend, batch, path);
+				}
+
+				j_backend_object_close(jd_object_backend, object);
+			}
+		}
+	}
+
+	ret = j_backend_kv_batch_execute(jd_kv_backend, batch) && ret;
+
+	g_mutex_unlock(lock);
+
+	return ret;
+}
+
+/**
+ * Copies an inline object.
+ *
+ * \param copied Whether the destination object has been written.
+ *
+ * \return TRUE if the source object is stored inline, FALSE otherwise.
+ **/
+gboolean
+jd_inline_copy(gchar const* namespace, gchar const* path, gchar const* destination_namespace, gchar const* destination_path, JSemantics* semantics, guint64* bytes_copied, gboolean* copied)
+{
+	g_autofree gchar* kv_namespace = NULL;
+	g_autofree gchar* destination_kv_namespace = NULL;
+	g_autofree gchar* value = NULL;
+	GMutex* lock;
+	gpointer batch;
+	gpointer object;
+	guint32 len;
+	gboolean ret = FALSE;
+
+	if (jd_inline_threshold == 0)
+	{
+		return FALSE;
+	}
+
+	kv_namespace = g_strconcat(JD_INLINE_NAMESPACE_PREFIX, namespace, NULL);
+
+	if (j_backend_kv_batch_start(jd_kv_backend, kv_namespace, semantics, &batch))
+	{
+		ret = jd_inline_get(batch, path, &value, &len);
+		j_backend_kv_batch_execute(jd_kv_backend, batch);
+	}
+
+	if (!ret)
+	{
+		return FALSE;
+	}
+
+	destination_kv_namespace = g_strconcat(JD_INLINE_NAMESPACE_PREFIX, destination_namespace, NULL);
+	lock = jd_inline_lock(destination_namespace, destination_path);
+
+	*bytes_copied = 0;
+	*copied = FALSE;
+
+	g_mutex_lock(lock);
+
+	// An existing destination object would otherwise keep its old data in the object backend
+	if (j_backend_object_open(jd_object_backend, destination_namespace, destination_path, &object))
+	{
+		j_backend_object_delete(jd_object_backend, object);
+	}
+
+	if (j_backend_kv_batch_start(jd_kv_backend, destination_kv_namespace, semantics, &batch))
+	{
+		*copied = jd_inline_put(batch, destination_path, value + sizeof(gint64), len - sizeof(gint64));
+		*copied = j_backend_kv_batch_execute(jd_kv_backend, batch) && *copied;
+	}
+
+	if (*copied)
+	{
+		*bytes_copied = len - sizeof(gint64);
+	}
+
+	g_mutex_unlock(lock);
+
+	return ret;
+}
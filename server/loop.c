@@ -28,6 +28,92 @@
 
 static guint jd_thread_num = 0;
 
+/**
+ * The result of an atomic key-value operation.
+ * Results are collected until the batch has been executed, since they are only valid if it succeeds.
+ **/
+struct JDKVAtomicResult
+{
+	gboolean ret;
+	gboolean swapped;
+	gint64 value;
+};
+
+typedef struct JDKVAtomicResult JDKVAtomicResult;
+
+/**
+ * Terminates a page of key-value pairs.
+ * The page is terminated by a length of 0, followed by a cursor that can be used to request the next page and an error flag.
+ *
+ * \param reply  A reply.
+ * \param cursor The cursor, 0 if the iterator has been exhausted.
+ * \param failed Whether the iteration has failed.
+ **/
+static void
+jd_kv_append_page_end(JMessage* reply, guint64 cursor, gboolean failed)
+{
+	guint32 zero = 0;
+	gchar error;
+
+	error = (failed) ? 1 : 0;
+
+	j_message_add_operation(reply, 4 + 8 + 1);
+	j_message_append_4(reply, &zero);
+	j_message_append_8(reply, &cursor);
+	j_message_append_1(reply, &error);
+}
+
+/**
+ * Appends a page of key-value pairs to a reply.
+ * The cursor is 0 if the iterator has been exhausted.
+ *
+ * \param reply      A reply.
+ * \param iterator   A key-value iterator.
+ * \param page_size  The maximum number of pairs, 0 for no limit.
+ * \param page_bytes The maximum size of the page. A page always contains at least one pair.
+ **/
+static void
+jd_kv_append_page(JMessage* reply, gpointer iterator, guint32 page_size, guint64 page_bytes)
+{
+	gchar const* key;
+	gconstpointer value;
+	guint32 len;
+	guint32 count = 0;
+	guint64 bytes = 0;
+	guint64 cursor = 0;
+	gboolean more = TRUE;
+
+	// Check the limits before iterating, an entry that has been iterated over has to be sent
+	while ((page_size == 0 || count < page_size) && (count == 0 || bytes < page_bytes))
+	{
+		gsize key_len;
+
+		more = j_backend_kv_iterate(jd_kv_backend, iterator, &key, &value, &len);
+
+		if (!more)
+		{
+			break;
+		}
+
+		key_len = strlen(key) + 1;
+
+		j_message_add_operation(reply, 4 + len + key_len);
+		j_message_append_4(reply, &len);
+		j_message_append_n(reply, value, len);
+		j_message_append_string(reply, key);
+
+		count++;
+		bytes += 4 + len + key_len;
+	}
+
+	if (more)
+	{
+		cursor = jd_cursor_add(iterator);
+	}
+
+	jd_kv_append_page_end(reply, cursor, FALSE);
+}
+
 gboolean
 jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk* memory_chunk, guint64 memory_chunk_size, JStatistics* statistics)
 {
@@ -65,16 +151,29 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 			for (i = 0; i < operation_count; i++)
 			{
+				guint64 size_hint;
+
 				path = j_message_get_string(message);
+				size_hint = j_message_get_8(message);
 
-				if (j_backend_object_create(jd_object_backend, namespace, path, &object))
+				// Small objects start out inline
+				if (jd_inline_create(namespace, path, size_hint, semantics))
+				{
+					j_statistics_add(statistics, J_STATISTICS_FILES_CREATED, 1);
+				}
+				else if (j_backend_object_create(jd_object_backend, namespace, path, &object))
 				{
 					j_statistics_add(statistics, J_STATISTICS_FILES_CREATED, 1);
 
+					if (size_hint > 0)
+					{
+						// The hint is only an optimization
+						j_backend_object_allocate(jd_object_backend, object, size_hint, 0);
+					}
+
 					if (safety == J_SEMANTICS_SAFETY_STORAGE)
 					{
-						j_backend_object_sync(jd_object_backend, object);
-						j_statistics_add(statistics, J_STATISTICS_SYNC, 1);
+						jd_sync_object(object, statistics);
 					}
 
 					j_backend_object_close(jd_object_backend, object);
@@ -106,10 +205,20 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 			for (i = 0; i < operation_count; i++)
 			{
+				gboolean deleted;
+
 				path = j_message_get_string(message);
 
+				// Both copies have to be removed, a stale inline object would otherwise shadow a newly created real one
+				deleted = jd_inline_delete(namespace, path, semantics);
+
 				if (j_backend_object_open(jd_object_backend, namespace, path, &object)
 				    && j_backend_object_delete(jd_object_backend, object))
+				{
+					deleted = TRUE;
+				}
+
+				if (deleted)
 				{
 					j_statistics_add(statistics, J_STATISTICS_FILES_DELETED, 1);
 				}
@@ -129,38 +238,126 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 		case J_MESSAGE_OBJECT_READ:
 		{
 			JMessage* reply;
-			gpointer object;
+			g_autoptr(GArray) holes = NULL;
+			g_autofree gpointer* buffers = NULL;
+			g_autofree guint64* lengths = NULL;
+			g_autofree guint64* offsets = NULL;
+			g_autofree guint64* bytes_read = NULL;
+			gpointer object = NULL;
+			guint32 first = 0;
 
 			namespace = j_message_get_string(message);
 			path = j_message_get_string(message);
 
 			reply = j_message_new_reply(message);
+			holes = g_array_new(FALSE, FALSE, sizeof(guint64));
 
-			// FIXME return value
-			j_backend_object_open(jd_object_backend, namespace, path, &object);
+			buffers = g_new(gpointer, operation_count);
+			lengths = g_new(guint64, operation_count);
+			offsets = g_new(guint64, operation_count);
+			bytes_read = g_new0(guint64, operation_count);
 
 			for (i = 0; i < operation_count; i++)
 			{
-				gchar* buf;
-				guint64 length;
-				guint64 offset;
-				guint64 bytes_read = 0;
+				lengths[i] = j_message_get_8(message);
+				offsets[i] = j_message_get_8(message);
+			}
 
-				length = j_message_get_8(message);
-				offset = j_message_get_8(message);
+			// Operations are read together as long as their buffers fit into the memory chunk
+			while (first < operation_count)
+			{
+				guint32 last;
+				guint32 backend_first;
 
-				if (length > memory_chunk_size)
+				for (last = first; last < operation_count; last++)
 				{
-					// FIXME return proper error
-					j_message_add_operation(reply, sizeof(guint64));
-					j_message_append_8(reply, &bytes_read);
-					continue;
+					if (lengths[last] > memory_chunk_size)
+					{
+						// FIXME return proper error
+						buffers[last] = NULL;
+						lengths[last] = 0;
+						continue;
+					}
+
+					buffers[last] = j_memory_chunk_get(memory_chunk, lengths[last]);
+
+					if (buffers[last] == NULL)
+					{
+						break;
+					}
 				}
 
-				buf = j_memory_chunk_get(memory_chunk, length);
+				// Inline objects are checked first to avoid a failing open
+				for (backend_first = first; object == NULL && backend_first < last; backend_first++)
+				{
+					if (lengths[backend_first] > 0 && !jd_inline_read(namespace, path, semantics, buffers[backend_first], lengths[backend_first], offsets[backend_first], &(bytes_read[backend_first])))
+					{
+						if (!j_backend_object_open(jd_object_backend, namespace, path, &object))
+						{
+							object = NULL;
+						}
+
+						break;
+					}
+				}
+
+				if (object != NULL && backend_first < last)
+				{
+					j_backend_object_read_multi(jd_object_backend, object, buffers + backend_first, lengths + backend_first, offsets + backend_first, last - backend_first, bytes_read + backend_first);
+				}
+
+				for (i = first; i < last; i++)
+				{
+					gchar* buf = buffers[i];
+					guint64 bytes_sent = 0;
+					guint64 position = 0;
+					guint32 hole_count = 0;
+
+					g_array_set_size(holes, 0);
+
+					// Holes are not sent, the client fills them with zeros
+					if (object != NULL && i >= backend_first && bytes_read[i] > 0 && !j_backend_object_get_holes(jd_object_backend, object, bytes_read[i], offsets[i], holes))
+					{
+						g_array_set_size(holes, 0);
+					}
+
+					j_statistics_add(statistics, J_STATISTICS_BYTES_READ, bytes_read[i]);
+
+					hole_count = holes->len / 2;
+
+					j_message_add_operation(reply, sizeof(guint64) + sizeof(guint32) + hole_count * 2 * sizeof(guint64));
+					j_message_append_8(reply, &(bytes_read[i]));
+					j_message_append_4(reply, &hole_count);
+
+					for (guint32 h = 0; h < hole_count; h++)
+					{
+						guint64 hole_offset = g_array_index(holes, guint64, 2 * h) - offsets[i];
+						guint64 hole_length = g_array_index(holes, guint64, 2 * h + 1);
+
+						j_message_append_8(reply, &hole_offset);
+						j_message_append_8(reply, &hole_length);
 
-				if (buf == NULL)
+						if (hole_offset > position)
+						{
+							j_message_add_send(reply, buf + position, hole_offset - position);
+							bytes_sent += hole_offset - position;
+						}
+
+						position = hole_offset + hole_length;
+					}
+
+					if (position < bytes_read[i])
+					{
+						j_message_add_send(reply, buf + position, bytes_read[i] - position);
+						bytes_sent += bytes_read[i] - position;
+					}
+
+					j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, bytes_sent);
+				}
+
+				if (last < operation_count)
 				{
+					// The memory chunk is full, send the replies collected so far
 					// FIXME ugly
 					j_message_send(reply, connection);
 					j_message_unref(reply);
@@ -168,24 +365,15 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 					reply = j_message_new_reply(message);
 
 					j_memory_chunk_reset(memory_chunk);
-					buf = j_memory_chunk_get(memory_chunk, length);
 				}
 
-				j_backend_object_read(jd_object_backend, object, buf, length, offset, &bytes_read);
-				j_statistics_add(statistics, J_STATISTICS_BYTES_READ, bytes_read);
-
-				j_message_add_operation(reply, sizeof(guint64));
-				j_message_append_8(reply, &bytes_read);
-
-				if (bytes_read > 0)
-				{
-					j_message_add_send(reply, buf, bytes_read);
-				}
-
-				j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, bytes_read);
+				first = last;
 			}
 
-			j_backend_object_close(jd_object_backend, object);
+			if (object != NULL)
+			{
+				j_backend_object_close(jd_object_backend, object);
+			}
 
 			j_message_send(reply, connection);
 			j_message_unref(reply);
@@ -196,7 +384,8 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 		case J_MESSAGE_OBJECT_WRITE:
 		{
 			g_autoptr(JMessage) reply = NULL;
-			gpointer object;
+			gpointer object = NULL;
+			gboolean create;
 
 			if (safety == J_SEMANTICS_SAFETY_NETWORK || safety == J_SEMANTICS_SAFETY_STORAGE)
 			{
@@ -205,9 +394,7 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 			namespace = j_message_get_string(message);
 			path = j_message_get_string(message);
-
-			// FIXME return value
-			j_backend_object_open(jd_object_backend, namespace, path, &object);
+			create = (j_message_get_1(message) != 0);
 
 			for (i = 0; i < operation_count; i++)
 			{
@@ -216,15 +403,24 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				guint64 length;
 				guint64 offset;
 				guint64 bytes_written = 0;
+				gboolean written = FALSE;
+				gchar ret;
 
 				length = j_message_get_8(message);
 				offset = j_message_get_8(message);
 
 				if (length > memory_chunk_size)
 				{
-					// FIXME return proper error
-					j_message_add_operation(reply, sizeof(guint64));
-					j_message_append_8(reply, &bytes_written);
+					// FIXME the data still has to be skipped
+					if (reply != NULL)
+					{
+						ret = 0;
+
+						j_message_add_operation(reply, sizeof(guint64) + 1);
+						j_message_append_8(reply, &bytes_written);
+						j_message_append_1(reply, &ret);
+					}
+
 					continue;
 				}
 
@@ -236,25 +432,70 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				g_input_stream_read_all(input, buf, length, NULL, NULL, NULL);
 				j_statistics_add(statistics, J_STATISTICS_BYTES_RECEIVED, length);
 
-				j_backend_object_write(jd_object_backend, object, buf, length, offset, &bytes_written);
+				// Inline objects are checked first and promoted to real objects when they grow too large
+				if (object == NULL)
+				{
+					written = jd_inline_write(namespace, path, semantics, buf, length, offset, &bytes_written);
+				}
+
+				if (object == NULL && !written)
+				{
+					if (!j_backend_object_open(jd_object_backend, namespace, path, &object))
+					{
+						object = NULL;
+
+						// Stripes of distributed objects are created by their first write
+						if (create)
+						{
+							if (jd_inline_create(namespace, path, offset + length, semantics)
+							    && jd_inline_write(namespace, path, semantics, buf, length, offset, &bytes_written))
+							{
+								j_statistics_add(statistics, J_STATISTICS_FILES_CREATED, 1);
+								written = TRUE;
+							}
+							else if (j_backend_object_create(jd_object_backend, namespace, path, &object))
+							{
+								j_statistics_add(statistics, J_STATISTICS_FILES_CREATED, 1);
+							}
+							else
+							{
+								g_debug("Could not create %s/%s.", namespace, path);
+								object = NULL;
+							}
+						}
+					}
+				}
+
+				// Unlike reads, writes are not submitted together, since writes to overlapping ranges have to be applied in order
+				if (object != NULL)
+				{
+					written = j_backend_object_write(jd_object_backend, object, buf, length, offset, &bytes_written);
+				}
+
 				j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, bytes_written);
 
+				// Objects that do not exist and could not be created are reported as failed instead of as empty writes
 				if (reply != NULL)
 				{
-					j_message_add_operation(reply, sizeof(guint64));
+					ret = (written) ? 1 : 0;
+
+					j_message_add_operation(reply, sizeof(guint64) + 1);
 					j_message_append_8(reply, &bytes_written);
+					j_message_append_1(reply, &ret);
 				}
 
 				j_memory_chunk_reset(memory_chunk);
 			}
 
-			if (safety == J_SEMANTICS_SAFETY_STORAGE)
+			if (object != NULL)
 			{
-				j_backend_object_sync(jd_object_backend, object);
-				j_statistics_add(statistics, J_STATISTICS_SYNC, 1);
-			}
+				if (safety == J_SEMANTICS_SAFETY_STORAGE)
+				{
+					jd_sync_object(object, statistics);
+				}
 
-			j_backend_object_close(jd_object_backend, object);
+				j_backend_object_close(jd_object_backend, object);
+			}
 
 			if (reply != NULL)
 			{
@@ -264,6 +505,98 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			j_memory_chunk_reset(memory_chunk);
 		}
 		break;
+		case J_MESSAGE_OBJECT_COPY:
+		{
+			g_autoptr(JMessage) reply = NULL;
+			gboolean remove_stale;
+
+			if (safety == J_SEMANTICS_SAFETY_NETWORK || safety == J_SEMANTICS_SAFETY_STORAGE)
+			{
+				reply = j_message_new_reply(message);
+			}
+
+			namespace = j_message_get_string(message);
+			remove_stale = (j_message_get_1(message) != 0);
+
+			for (i = 0; i < operation_count; i++)
+			{
+				gchar const* destination_namespace;
+				gchar const* destination_path;
+				gpointer object;
+				gpointer destination;
+				guint64 bytes_copied = 0;
+				gboolean copied = FALSE;
+				gchar ret;
+
+				path = j_message_get_string(message);
+				destination_namespace = j_message_get_string(message);
+				destination_path = j_message_get_string(message);
+
+				// The data never leaves the server, inline objects are checked first to avoid a failing open
+				if (jd_inline_copy(namespace, path, destination_namespace, destination_path, semantics, &bytes_copied, &copied))
+				{
+					if (copied)
+					{
+						j_statistics_add(statistics, J_STATISTICS_BYTES_READ, bytes_copied);
+						j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, bytes_copied);
+					}
+				}
+				else if (j_backend_object_open(jd_object_backend, namespace, path, &object))
+				{
+					// An existing inline destination object would shadow the copy
+					jd_inline_delete(destination_namespace, destination_path, semantics);
+
+					if (j_backend_object_create(jd_object_backend, destination_namespace, destination_path, &destination))
+					{
+						copied = j_backend_object_copy(jd_object_backend, object, destination, &bytes_copied);
+						j_statistics_add(statistics, J_STATISTICS_BYTES_READ, bytes_copied);
+						j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, bytes_copied);
+
+						if (safety == J_SEMANTICS_SAFETY_STORAGE)
+						{
+							jd_sync_object(destination, statistics);
+						}
+
+						j_backend_object_close(jd_object_backend, destination);
+					}
+
+					j_backend_object_close(jd_object_backend, object);
+				}
+				else if (remove_stale)
+				{
+					gboolean deleted;
+
+					// Distributed objects do not have stripes on every server, stale stripes of the destination have to be removed
+					copied = TRUE;
+					deleted = jd_inline_delete(destination_namespace, destination_path, semantics);
+
+					if (j_backend_object_open(jd_object_backend, destination_namespace, destination_path, &destination))
+					{
+						copied = j_backend_object_delete(jd_object_backend, destination);
+						deleted = deleted || copied;
+					}
+
+					if (deleted)
+					{
+						j_statistics_add(statistics, J_STATISTICS_FILES_DELETED, 1);
+					}
+				}
+
+				if (reply != NULL)
+				{
+					ret = (copied) ? 1 : 0;
+
+					j_message_add_operation(reply, 1);
+					j_message_append_1(reply, &ret);
+				}
+			}
+
+			if (reply != NULL)
+			{
+				j_message_send(reply, connection);
+			}
+		}
+		break;
 		case J_MESSAGE_OBJECT_STATUS:
 		{
 			g_autoptr(JMessage) reply = NULL;
@@ -280,19 +613,24 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 				path = j_message_get_string(message);
 
-				// FIXME return value
-				j_backend_object_open(jd_object_backend, namespace, path, &object);
-
-				if (j_backend_object_status(jd_object_backend, object, &modification_time, &size))
+				// Inline objects are checked first to avoid a failing open
+				if (jd_inline_status(namespace, path, semantics, &modification_time, &size))
 				{
 					j_statistics_add(statistics, J_STATISTICS_FILES_STATED, 1);
 				}
+				else if (j_backend_object_open(jd_object_backend, namespace, path, &object))
+				{
+					if (j_backend_object_status(jd_object_backend, object, &modification_time, &size))
+					{
+						j_statistics_add(statistics, J_STATISTICS_FILES_STATED, 1);
+					}
+
+					j_backend_object_close(jd_object_backend, object);
+				}
 
 				j_message_add_operation(reply, sizeof(gint64) + sizeof(guint64));
 				j_message_append_8(reply, &modification_time);
 				j_message_append_8(reply, &size);
-
-				j_backend_object_close(jd_object_backend, object);
 			}
 
 			j_message_send(reply, connection);
@@ -316,8 +654,7 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 				if (j_backend_object_open(jd_object_backend, namespace, path, &object))
 				{
-					j_backend_object_sync(jd_object_backend, object);
-					j_statistics_add(statistics, J_STATISTICS_SYNC, 1);
+					jd_sync_object(object, statistics);
 					j_backend_object_close(jd_object_backend, object);
 				}
 
@@ -337,6 +674,7 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 		{
 			g_autoptr(JMessage) reply = NULL;
 			JStatistics* r_statistics;
+			JStatistics* backend_statistics;
 			gchar get_all;
 			guint64 value;
 
@@ -349,8 +687,16 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				/* FIXME add statistics of all threads */
 			}
 
+			backend_statistics = j_statistics_new(FALSE);
+
+			// Backend statistics are global, that is, they do not depend on get_all
+			if (jd_object_backend != NULL)
+			{
+				j_backend_object_statistics(jd_object_backend, backend_statistics);
+			}
+
 			reply = j_message_new_reply(message);
-			j_message_add_operation(reply, 8 * sizeof(guint64));
+			j_message_add_operation(reply, 11 * sizeof(guint64));
 
 			value = j_statistics_get(r_statistics, J_STATISTICS_FILES_CREATED);
 			j_message_append_8(reply, &value);
@@ -368,12 +714,20 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			j_message_append_8(reply, &value);
 			value = j_statistics_get(r_statistics, J_STATISTICS_BYTES_SENT);
 			j_message_append_8(reply, &value);
+			value = j_statistics_get(backend_statistics, J_STATISTICS_FILE_CACHE_HITS);
+			j_message_append_8(reply, &value);
+			value = j_statistics_get(backend_statistics, J_STATISTICS_FILE_CACHE_MISSES);
+			j_message_append_8(reply, &value);
+			value = j_statistics_get(backend_statistics, J_STATISTICS_FILE_CACHE_EVICTIONS);
+			j_message_append_8(reply, &value);
 
 			if (get_all != 0)
 			{
 				g_mutex_unlock(jd_statistics_mutex);
 			}
 
+			j_statistics_free(backend_statistics);
+
 			j_message_send(reply, connection);
 		}
 		break;
@@ -489,26 +843,80 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 		case J_MESSAGE_KV_GET:
 		{
 			g_autoptr(JMessage) reply = NULL;
+			g_autoptr(JList) values = NULL;
+			g_autofree gchar const** multi_keys = NULL;
+			g_autofree gconstpointer* multi_values = NULL;
+			g_autofree guint32* multi_lens = NULL;
 			gpointer batch;
+			gboolean borrow;
+			gboolean multi;
 
 			reply = j_message_new_reply(message);
 			namespace = j_message_get_string(message);
 			j_backend_kv_batch_start(jd_kv_backend, namespace, semantics, &batch);
 
+			// Borrowed values are valid until the batch is executed, copies are kept until the reply has been sent
+			borrow = (jd_kv_backend->kv.backend_get_borrowed != NULL);
+			multi = (jd_kv_backend->kv.backend_get_multi != NULL && operation_count > 1);
+			values = j_list_new(g_free);
+
+			if (multi)
+			{
+				multi_keys = g_new(gchar const*, operation_count);
+				multi_values = g_new0(gconstpointer, operation_count);
+				multi_lens = g_new0(guint32, operation_count);
+
+				for (i = 0; i < operation_count; i++)
+				{
+					multi_keys[i] = j_message_get_string(message);
+				}
+
+				// Values that could not be read stay NULL and are reported as not found
+				j_backend_kv_get_multi(jd_kv_backend, batch, multi_keys, operation_count, multi_values, multi_lens);
+			}
+
 			for (i = 0; i < operation_count; i++)
 			{
-				gpointer value;
+				gconstpointer value = NULL;
 				guint32 len;
+				gboolean found;
 
-				key = j_message_get_string(message);
+				if (multi)
+				{
+					value = multi_values[i];
+					len = multi_lens[i];
+					found = (value != NULL);
+				}
+				else if (borrow)
+				{
+					key = j_message_get_string(message);
+					found = j_backend_kv_get_borrowed(jd_kv_backend, batch, key, &value, &len);
+				}
+				else
+				{
+					gpointer copy = NULL;
+
+					key = j_message_get_string(message);
+					found = j_backend_kv_get(jd_kv_backend, batch, key, &copy, &len);
+
+					if (copy != NULL)
+					{
+						j_list_append(values, copy);
+						value = copy;
+					}
+				}
 
-				if (j_backend_kv_get(jd_kv_backend, batch, key, &value, &len))
+				if (found && len > J_MESSAGE_KV_INLINE_MAX)
+				{
+					j_message_add_operation(reply, 4);
+					j_message_append_4(reply, &len);
+					j_message_add_send(reply, value, len);
+				}
+				else if (found)
 				{
 					j_message_add_operation(reply, 4 + len);
 					j_message_append_4(reply, &len);
 					j_message_append_n(reply, value, len);
-
-					g_free(value);
 				}
 				else
 				{
@@ -519,38 +927,29 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				}
 			}
 
-			j_backend_kv_batch_execute(jd_kv_backend, batch);
-
 			j_message_send(reply, connection);
+
+			j_backend_kv_batch_execute(jd_kv_backend, batch);
 		}
 		break;
 		case J_MESSAGE_KV_GET_ALL:
 		{
 			g_autoptr(JMessage) reply = NULL;
 			gpointer iterator;
-			gconstpointer value;
-			guint32 len;
-			guint32 zero = 0;
+			guint32 page_size;
 
 			reply = j_message_new_reply(message);
 			namespace = j_message_get_string(message);
+			page_size = j_message_get_4(message);
 
-			j_backend_kv_get_all(jd_kv_backend, namespace, &iterator);
-
-			while (j_backend_kv_iterate(jd_kv_backend, iterator, &key, &value, &len))
+			if (j_backend_kv_get_all(jd_kv_backend, namespace, &iterator))
 			{
-				gsize key_len;
-
-				key_len = strlen(key) + 1;
-
-				j_message_add_operation(reply, 4 + len + key_len);
-				j_message_append_4(reply, &len);
-				j_message_append_n(reply, value, len);
-				j_message_append_string(reply, key);
+				jd_kv_append_page(reply, iterator, page_size, memory_chunk_size);
+			}
+			else
+			{
+				jd_kv_append_page_end(reply, 0, TRUE);
 			}
-
-			j_message_add_operation(reply, 4);
-			j_message_append_4(reply, &zero);
 
 			j_message_send(reply, connection);
 		}
@@ -560,30 +959,188 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			g_autoptr(JMessage) reply = NULL;
 			gchar const* prefix;
 			gpointer iterator;
-			gconstpointer value;
-			guint32 len;
-			guint32 zero = 0;
+			guint32 page_size;
 
 			reply = j_message_new_reply(message);
 			namespace = j_message_get_string(message);
 			prefix = j_message_get_string(message);
+			page_size = j_message_get_4(message);
+
+			if (j_backend_kv_get_by_prefix(jd_kv_backend, namespace, prefix, &iterator))
+			{
+				jd_kv_append_page(reply, iterator, page_size, memory_chunk_size);
+			}
+			else
+			{
+				jd_kv_append_page_end(reply, 0, TRUE);
+			}
 
-			j_backend_kv_get_by_prefix(jd_kv_backend, namespace, prefix, &iterator);
+			j_message_send(reply, connection);
+		}
+		break;
+		case J_MESSAGE_KV_GET_RANGE:
+		{
+			g_autoptr(JMessage) reply = NULL;
+			gchar const* start;
+			gchar const* end;
+			gpointer iterator;
+			guint32 limit;
+			gboolean reverse;
+			guint32 page_size;
 
-			while (j_backend_kv_iterate(jd_kv_backend, iterator, &key, &value, &len))
+			reply = j_message_new_reply(message);
+			namespace = j_message_get_string(message);
+			// Empty strings denote unbounded ranges
+			start = j_message_get_string(message);
+			end = j_message_get_string(message);
+			limit = j_message_get_4(message);
+			reverse = j_message_get_1(message);
+			page_size = j_message_get_4(message);
+
+			if (j_backend_kv_get_range(jd_kv_backend, namespace, (start[0] != '\0') ? start : NULL, (end[0] != '\0') ? end : NULL, limit, reverse, &iterator))
+			{
+				jd_kv_append_page(reply, iterator, page_size, memory_chunk_size);
+			}
+			else
 			{
-				gsize key_len;
+				jd_kv_append_page_end(reply, 0, TRUE);
+			}
+
+			j_message_send(reply, connection);
+		}
+		break;
+		case J_MESSAGE_KV_ITERATE:
+		{
+			g_autoptr(JMessage) reply = NULL;
+			gpointer iterator;
+			guint64 cursor;
+			guint32 page_size;
 
-				key_len = strlen(key) + 1;
+			cursor = j_message_get_8(message);
+			page_size = j_message_get_4(message);
 
-				j_message_add_operation(reply, 4 + len + key_len);
-				j_message_append_4(reply, &len);
-				j_message_append_n(reply, value, len);
-				j_message_append_string(reply, key);
+			// A page size of 0 closes the cursor, the client does not wait for a reply
+			if (page_size == 0)
+			{
+				jd_cursor_close(cursor);
+				break;
 			}
 
-			j_message_add_operation(reply, 4);
-			j_message_append_4(reply, &zero);
+			reply = j_message_new_reply(message);
+			iterator = jd_cursor_take(cursor);
+
+			if (iterator == NULL)
+			{
+				// The cursor has timed out, the client has to be told that the iteration is incomplete
+				g_debug("Cursor %" G_GUINT64_FORMAT " does not exist.", cursor);
+
+				jd_kv_append_page_end(reply, 0, TRUE);
+			}
+			else
+			{
+				jd_kv_append_page(reply, iterator, page_size, memory_chunk_size);
+			}
+
+			j_message_send(reply, connection);
+		}
+		break;
+		case J_MESSAGE_KV_COMPARE_AND_SWAP:
+		case J_MESSAGE_KV_ADD:
+		case J_MESSAGE_KV_APPEND:
+		{
+			g_autoptr(JMessage) reply = NULL;
+			g_autoptr(GArray) results = NULL;
+			JMessageType type;
+			gpointer batch;
+			gboolean batch_ret;
+
+			type = j_message_get_type(message);
+			results = g_array_sized_new(FALSE, FALSE, sizeof(JDKVAtomicResult), operation_count);
+
+			namespace = j_message_get_string(message);
+			// The backend executes all operations within the batch's transaction
+			j_backend_kv_batch_start(jd_kv_backend, namespace, semantics, &batch);
+
+			for (i = 0; i < operation_count; i++)
+			{
+				JDKVAtomicResult result = { FALSE, FALSE, 0 };
+				gconstpointer data;
+				guint32 len;
+
+				key = j_message_get_string(message);
+
+				if (type == J_MESSAGE_KV_COMPARE_AND_SWAP)
+				{
+					gconstpointer expected = NULL;
+					guint32 expected_len;
+					gchar exists;
+
+					exists = j_message_get_1(message);
+					expected_len = j_message_get_4(message);
+
+					if (exists)
+					{
+						expected = j_message_get_n(message, expected_len);
+					}
+
+					len = j_message_get_4(message);
+					data = j_message_get_n(message, len);
+
+					result.ret = j_backend_kv_compare_and_swap(jd_kv_backend, batch, key, expected, expected_len, data, len, &(result.swapped));
+				}
+				else if (type == J_MESSAGE_KV_ADD)
+				{
+					gint64 delta;
+
+					delta = j_message_get_8(message);
+
+					result.ret = j_backend_kv_add(jd_kv_backend, batch, key, delta, &(result.value));
+				}
+				else
+				{
+					len = j_message_get_4(message);
+					data = j_message_get_n(message, len);
+
+					result.ret = j_backend_kv_append(jd_kv_backend, batch, key, data, len);
+				}
+
+				g_array_append_val(results, result);
+			}
+
+			batch_ret = j_backend_kv_batch_execute(jd_kv_backend, batch);
+
+			// The client always needs the results, independent of the safety semantics
+			reply = j_message_new_reply(message);
+
+			for (i = 0; i < results->len; i++)
+			{
+				JDKVAtomicResult* result = &g_array_index(results, JDKVAtomicResult, i);
+				gchar ret;
+
+				ret = (result->ret && batch_ret) ? 1 : 0;
+
+				if (type == J_MESSAGE_KV_COMPARE_AND_SWAP)
+				{
+					gchar swapped;
+
+					swapped = (ret && result->swapped) ? 1 : 0;
+
+					j_message_add_operation(reply, 1 + 1);
+					j_message_append_1(reply, &ret);
+					j_message_append_1(reply, &swapped);
+				}
+				else if (type == J_MESSAGE_KV_ADD)
+				{
+					j_message_add_operation(reply, 1 + 8);
+					j_message_append_1(reply, &ret);
+					j_message_append_8(reply, &(result->value));
+				}
+				else
+				{
+					j_message_add_operation(reply, 1);
+					j_message_append_1(reply, &ret);
+				}
+			}
 
 			j_message_send(reply, connection);
 		}
@@ -359,6 +359,22 @@ main(int argc, char** argv)
 		g_debug("Initialized db backend %s.", db_backend);
 	}
 
+	if (jd_object_backend != NULL && jd_kv_backend != NULL)
+	{
+		jd_inline_init(j_configuration_get_inline_threshold(jd_configuration));
+	}
+	else
+	{
+		if (jd_object_backend != NULL && j_configuration_get_inline_threshold(jd_configuration) > 0)
+		{
+			g_warning("Inline objects require a kv backend on the same server, disabling them.");
+		}
+
+		jd_inline_init(0);
+	}
+
+	jd_cursor_init();
+
 	jd_statistics = j_statistics_new(FALSE);
 	g_mutex_init(jd_statistics_mutex);
 
@@ -378,6 +394,9 @@ main(int argc, char** argv)
 	g_mutex_clear(jd_statistics_mutex);
 	j_statistics_free(jd_statistics);
 
+	jd_inline_fini();
+	jd_cursor_fini();
+
 	if (jd_db_backend != NULL)
 	{
 		j_backend_db_fini(jd_db_backend);
@@ -25,6 +25,7 @@
 #include <jbackend.h>
 #include <jmemory-chunk.h>
 #include <jmessage.h>
+#include <jsemantics.h>
 #include <jstatistics.h>
 
 G_GNUC_INTERNAL extern JStatistics* jd_statistics;
@@ -36,4 +37,23 @@ G_GNUC_INTERNAL extern JBackend* jd_db_backend;
 
 G_GNUC_INTERNAL gboolean jd_handle_message(JMessage*, GSocketConnection*, JMemoryChunk*, guint64, JStatistics*);
 
+G_GNUC_INTERNAL gboolean jd_sync_object(gpointer, JStatistics*);
+
+G_GNUC_INTERNAL void jd_cursor_init(void);
+G_GNUC_INTERNAL void jd_cursor_fini(void);
+
+G_GNUC_INTERNAL guint64 jd_cursor_add(gpointer);
+G_GNUC_INTERNAL gpointer jd_cursor_take(guint64);
+G_GNUC_INTERNAL void jd_cursor_close(guint64);
+
+G_GNUC_INTERNAL void jd_inline_init(guint64);
+G_GNUC_INTERNAL void jd_inline_fini(void);
+
+G_GNUC_INTERNAL gboolean jd_inline_create(gchar const*, gchar const*, guint64, JSemantics*);
+G_GNUC_INTERNAL gboolean jd_inline_delete(gchar const*, gchar const*, JSemantics*);
+G_GNUC_INTERNAL gboolean jd_inline_status(gchar const*, gchar const*, JSemantics*, gint64*, guint64*);
+G_GNUC_INTERNAL gboolean jd_inline_read(gchar const*, gchar const*, JSemantics*, gpointer, guint64, guint64, guint64*);
+G_GNUC_INTERNAL gboolean jd_inline_write(gchar const*, gchar const*, JSemantics*, gconstpointer, guint64, guint64, guint64*);
+G_GNUC_INTERNAL gboolean jd_inline_copy(gchar const*, gchar const*, gchar const*, gchar const*, JSemantics*, guint64*, gboolean*);
+
 #endif
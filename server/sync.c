@@ -0,0 +1,160 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <julea.h>
+
+#include "server.h"
+
+/**
+ * A group of objects that are synced together.
+ **/
+struct JdSyncBatch
+{
+	/**
+	 * The objects to sync, mapped to the result of their sync.
+	 * Objects are deduplicated, that is, each object is synced at most once per batch.
+	 **/
+	GHashTable* objects;
+
+	/**
+	 * Whether the batch has been committed.
+	 **/
+	gboolean done;
+
+	/**
+	 * The number of threads waiting for the batch.
+	 **/
+	guint ref_count;
+};
+
+typedef struct JdSyncBatch JdSyncBatch;
+
+static GMutex jd_sync_mutex;
+static GCond jd_sync_cond;
+
+/**
+ * The batch that is currently being filled.
+ **/
+static JdSyncBatch* jd_sync_current = NULL;
+
+/**
+ * Whether a thread is currently committing a batch.
+ **/
+static gboolean jd_sync_leader = FALSE;
+
+/**
+ * Syncs an object using group commit.
+ *
+ * Sync requests from all connection threads are collected into batches.
+ * While one thread (the leader) commits a batch, new requests are collected into the next batch,
+ * which is then committed by one of its waiting threads.
+ * This way, concurrent requests share sync operations instead of serializing on them,
+ * while a single request is committed without additional latency.
+ *
+ * \param object     The backend object. It has to stay open until the function returns.
+ * \param statistics The statistics to which the leader adds the number of performed syncs.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+jd_sync_object(gpointer object, JStatistics* statistics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdSyncBatch* batch;
+	gboolean ret;
+
+	g_return_val_if_fail(object != NULL, FALSE);
+	g_return_val_if_fail(statistics != NULL, FALSE);
+
+	g_mutex_lock(&jd_sync_mutex);
+
+	if (jd_sync_current == NULL)
+	{
+		jd_sync_current = g_slice_new(JdSyncBatch);
+		jd_sync_current->objects = g_hash_table_new(NULL, NULL);
+		jd_sync_current->done = FALSE;
+		jd_sync_current->ref_count = 0;
+	}
+
+	batch = jd_sync_current;
+	batch->ref_count++;
+
+	g_hash_table_insert(batch->objects, object, GINT_TO_POINTER(FALSE));
+
+	while (!batch->done)
+	{
+		if (!jd_sync_leader)
+		{
+			GHashTableIter iter;
+			gpointer key;
+			guint64 count = 0;
+
+			// Without a leader, our batch has to be the current one
+			g_assert(batch == jd_sync_current);
+
+			jd_sync_leader = TRUE;
+			jd_sync_current = NULL;
+
+			g_mutex_unlock(&jd_sync_mutex);
+
+			g_hash_table_iter_init(&iter, batch->objects);
+
+			while (g_hash_table_iter_next(&iter, &key, NULL))
+			{
+				gboolean result;
+
+				result = j_backend_object_sync(jd_object_backend, key);
+				g_hash_table_iter_replace(&iter, GINT_TO_POINTER(result));
+
+				count++;
+			}
+
+			j_statistics_add(statistics, J_STATISTICS_SYNC, count);
+
+			g_mutex_lock(&jd_sync_mutex);
+
+			batch->done = TRUE;
+			jd_sync_leader = FALSE;
+
+			g_cond_broadcast(&jd_sync_cond);
+		}
+		else
+		{
+			g_cond_wait(&jd_sync_cond, &jd_sync_mutex);
+		}
+	}
+
+	ret = GPOINTER_TO_INT(g_hash_table_lookup(batch->objects, object));
+
+	batch->ref_count--;
+
+	if (batch->ref_count == 0)
+	{
+		g_hash_table_destroy(batch->objects);
+		g_slice_free(JdSyncBatch, batch);
+	}
+
+	g_mutex_unlock(&jd_sync_mutex);
+
+	return ret;
+}
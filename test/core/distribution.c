@@ -213,10 +213,299 @@ test_distribution_weighted(JConfiguration** configuration, gconstpointer data)
 	test_distribution_distribute(J_DISTRIBUTION_WEIGHTED, configuration, data);
 }
 
+static JConfiguration*
+test_distribution_configuration_new(guint server_count)
+{
+	JConfiguration* configuration;
+	GKeyFile* key_file;
+	g_auto(GStrv) servers = NULL;
+
+	servers = g_new0(gchar*, server_count + 1);
+
+	for (guint i = 0; i < server_count; i++)
+	{
+		servers[i] = g_strdup("localhost");
+	}
+
+	key_file = g_key_file_new();
+	g_key_file_set_string_list(key_file, "servers", "object", (gchar const* const*)servers, server_count);
+	g_key_file_set_string_list(key_file, "servers", "kv", (gchar const* const*)servers, 1);
+	g_key_file_set_string_list(key_file, "servers", "db", (gchar const* const*)servers, 1);
+	g_key_file_set_string(key_file, "object", "backend", "null");
+	g_key_file_set_string(key_file, "object", "component", "server");
+	g_key_file_set_string(key_file, "object", "path", "");
+	g_key_file_set_string(key_file, "kv", "backend", "null");
+	g_key_file_set_string(key_file, "kv", "component", "server");
+	g_key_file_set_string(key_file, "kv", "path", "");
+	g_key_file_set_string(key_file, "db", "backend", "null");
+	g_key_file_set_string(key_file, "db", "component", "server");
+	g_key_file_set_string(key_file, "db", "path", "");
+
+	configuration = j_configuration_new_for_data(key_file);
+
+	g_key_file_free(key_file);
+
+	return configuration;
+}
+
+static void
+test_distribution_consistent_hash(JConfiguration** configuration, gconstpointer data)
+{
+	guint const n = 1000;
+
+	g_autoptr(JConfiguration) new_configuration = NULL;
+	g_autoptr(JDistribution) distribution = NULL;
+	g_autoptr(JDistribution) new_distribution = NULL;
+	gboolean ret;
+	guint64 block_size;
+	guint64 length;
+	guint64 offset;
+	guint64 block_id;
+	guint index;
+	guint moved = 0;
+
+	(void)data;
+
+	block_size = j_configuration_get_stripe_size(*configuration);
+
+	distribution = j_distribution_new_for_configuration(J_DISTRIBUTION_CONSISTENT_HASH, *configuration);
+	j_distribution_set(distribution, "seed", 42);
+	j_distribution_reset(distribution, n * block_size, 42);
+
+	// Blocks are stored at their global offsets
+	ret = j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+	g_assert_true(ret);
+	g_assert_cmpuint(length, ==, block_size - 42);
+	g_assert_cmpuint(offset, ==, 42);
+	g_assert_cmpuint(block_id, ==, 0);
+
+	// Adding a server only moves blocks to the new server
+	new_configuration = test_distribution_configuration_new(3);
+	new_distribution = j_distribution_new_for_configuration(J_DISTRIBUTION_CONSISTENT_HASH, new_configuration);
+	j_distribution_set(new_distribution, "seed", 42);
+
+	j_distribution_reset(distribution, n * block_size, 0);
+	j_distribution_reset(new_distribution, n * block_size, 0);
+
+	for (guint i = 0; i < n; i++)
+	{
+		guint new_index;
+
+		ret = j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+		g_assert_true(ret);
+		g_assert_cmpuint(index, <, 2);
+
+		ret = j_distribution_distribute(new_distribution, &new_index, &length, &offset, &block_id);
+		g_assert_true(ret);
+		g_assert_cmpuint(new_index, <, 3);
+
+		if (index != new_index)
+		{
+			g_assert_cmpuint(new_index, ==, 2);
+			moved++;
+		}
+	}
+
+	// About a third of the blocks should move
+	g_assert_cmpuint(moved, >, n / 4);
+	g_assert_cmpuint(moved, <, n / 2);
+}
+
+static void
+test_distribution_adapt(JConfiguration** configuration, gconstpointer data)
+{
+	g_autoptr(JDistribution) distribution = NULL;
+	g_autoptr(JDistribution) fixed_distribution = NULL;
+	g_autoptr(JDistribution) large_distribution = NULL;
+	gboolean ret;
+	guint64 length;
+	guint64 offset;
+	guint64 block_id;
+	guint index;
+	guint first_index;
+
+	(void)data;
+
+	// Small data is split into small blocks spread across both servers
+	distribution = j_distribution_new_for_configuration(J_DISTRIBUTION_ROUND_ROBIN, *configuration);
+	j_distribution_adapt(distribution, 256 * 1024);
+	j_distribution_reset(distribution, 256 * 1024, 0);
+
+	ret = j_distribution_distribute(distribution, &first_index, &length, &offset, &block_id);
+	g_assert_true(ret);
+	g_assert_cmpuint(length, ==, 64 * 1024);
+
+	ret = j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+	g_assert_true(ret);
+	g_assert_cmpuint(length, ==, 64 * 1024);
+	g_assert_cmpuint(index, !=, first_index);
+
+	// Data smaller than one block only uses one server
+	j_distribution_adapt(distribution, 1024);
+	j_distribution_reset(distribution, 256 * 1024, 0);
+
+	while (j_distribution_distribute(distribution, &index, &length, &offset, &block_id))
+	{
+		g_assert_cmpuint(index, ==, first_index);
+	}
+
+	// Large data uses larger blocks
+	large_distribution = j_distribution_new_for_configuration(J_DISTRIBUTION_ROUND_ROBIN, *configuration);
+	j_distribution_adapt(large_distribution, G_GUINT64_CONSTANT(64) * 1024 * 1024 * 1024);
+	j_distribution_reset(large_distribution, G_GUINT64_CONSTANT(64) * 1024 * 1024 * 1024, 0);
+
+	ret = j_distribution_distribute(large_distribution, &index, &length, &offset, &block_id);
+	g_assert_true(ret);
+	g_assert_cmpuint(length, ==, 64 * 1024 * 1024);
+
+	// Explicit block sizes are kept
+	fixed_distribution = j_distribution_new_for_configuration(J_DISTRIBUTION_ROUND_ROBIN, *configuration);
+	j_distribution_set_block_size(fixed_distribution, 42);
+	j_distribution_adapt(fixed_distribution, 256 * 1024);
+	j_distribution_reset(fixed_distribution, 256 * 1024, 0);
+
+	ret = j_distribution_distribute(fixed_distribution, &index, &length, &offset, &block_id);
+	g_assert_true(ret);
+	g_assert_cmpuint(length, ==, 42);
+}
+
+static void
+test_distribution_replicated(JConfiguration** configuration, gconstpointer data)
+{
+	g_autoptr(JDistribution) distribution = NULL;
+	gboolean ret;
+	guint64 block_size;
+	guint64 length;
+	guint64 offset;
+	guint64 block_id;
+	guint index;
+
+	(void)data;
+
+	block_size = j_configuration_get_stripe_size(*configuration);
+
+	distribution = j_distribution_new_for_configuration(J_DISTRIBUTION_REPLICATED, *configuration);
+	j_distribution_set(distribution, "start-index", 1);
+	j_distribution_set(distribution, "replicas", 2);
+	j_distribution_reset(distribution, 3 * block_size, 42);
+
+	g_assert_cmpuint(j_distribution_get_replica_count(distribution), ==, 2);
+
+	ret = j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+	g_assert_true(ret);
+	g_assert_cmpuint(index, ==, 1);
+	g_assert_cmpuint(length, ==, block_size - 42);
+	g_assert_cmpuint(offset, ==, 42);
+	g_assert_cmpuint(block_id, ==, 0);
+
+	j_distribution_get_replica(distribution, 1, &index, &offset);
+	g_assert_cmpuint(index, ==, 0);
+	g_assert_cmpuint(offset, ==, block_size + 42);
+
+	ret = j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+	g_assert_true(ret);
+	g_assert_cmpuint(index, ==, 0);
+	g_assert_cmpuint(length, ==, block_size);
+	g_assert_cmpuint(offset, ==, 0);
+	g_assert_cmpuint(block_id, ==, 1);
+
+	j_distribution_get_replica(distribution, 1, &index, &offset);
+	g_assert_cmpuint(index, ==, 1);
+	g_assert_cmpuint(offset, ==, block_size);
+
+	ret = j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+	g_assert_true(ret);
+	g_assert_cmpuint(index, ==, 1);
+	g_assert_cmpuint(length, ==, block_size);
+	g_assert_cmpuint(offset, ==, 2 * block_size);
+	g_assert_cmpuint(block_id, ==, 2);
+
+	j_distribution_get_replica(distribution, 1, &index, &offset);
+	g_assert_cmpuint(index, ==, 0);
+	g_assert_cmpuint(offset, ==, 3 * block_size);
+}
+
+static void
+test_distribution_local(JConfiguration** configuration, gconstpointer data)
+{
+	g_autoptr(JDistribution) distribution = NULL;
+	gboolean ret;
+	guint64 block_size;
+	guint64 length;
+	guint64 offset;
+	guint64 block_id;
+	guint32 local_index;
+	guint index;
+
+	(void)data;
+
+	block_size = j_configuration_get_stripe_size(*configuration);
+
+	// Both servers are local, the first one is preferred
+	ret = j_configuration_get_local_server(*configuration, J_BACKEND_TYPE_OBJECT, &local_index);
+	g_assert_true(ret);
+	g_assert_cmpuint(local_index, ==, 0);
+
+	distribution = j_distribution_new_for_configuration(J_DISTRIBUTION_LOCAL, *configuration);
+	j_distribution_reset(distribution, 3 * block_size, 42);
+
+	for (guint i = 0; i < 3; i++)
+	{
+		ret = j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+		g_assert_true(ret);
+		g_assert_cmpuint(index, ==, 0);
+	}
+
+	ret = j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+	g_assert_false(ret);
+}
+
+static void
+test_distribution_local_port(void)
+{
+	g_autoptr(JConfiguration) configuration = NULL;
+	GKeyFile* key_file;
+	gchar const* servers[] = { "remote.invalid:4711", "localhost:4712", NULL };
+	gboolean ret;
+	guint32 local_index;
+
+	key_file = g_key_file_new();
+	g_key_file_set_string_list(key_file, "servers", "object", servers, 2);
+	g_key_file_set_string_list(key_file, "servers", "kv", servers, 2);
+	g_key_file_set_string_list(key_file, "servers", "db", servers, 2);
+	g_key_file_set_string(key_file, "object", "backend", "null");
+	g_key_file_set_string(key_file, "object", "component", "server");
+	g_key_file_set_string(key_file, "object", "path", "");
+	g_key_file_set_string(key_file, "kv", "backend", "null");
+	g_key_file_set_string(key_file, "kv", "component", "server");
+	g_key_file_set_string(key_file, "kv", "path", "");
+	g_key_file_set_string(key_file, "db", "backend", "null");
+	g_key_file_set_string(key_file, "db", "component", "server");
+	g_key_file_set_string(key_file, "db", "path", "");
+
+	configuration = j_configuration_new_for_data(key_file);
+
+	g_key_file_free(key_file);
+
+	// Ports are not part of the host name
+	ret = j_configuration_get_local_server(configuration, J_BACKEND_TYPE_OBJECT, &local_index);
+	g_assert_true(ret);
+	g_assert_cmpuint(local_index, ==, 1);
+
+	ret = j_configuration_get_local_server(configuration, J_BACKEND_TYPE_KV, &local_index);
+	g_assert_true(ret);
+	g_assert_cmpuint(local_index, ==, 1);
+}
+
 void
 test_core_distribution(void)
 {
 	g_test_add("/core/distribution/round_robin", JConfiguration*, NULL, test_distribution_fixture_setup, test_distribution_round_robin, test_distribution_fixture_teardown);
 	g_test_add("/core/distribution/single_server", JConfiguration*, NULL, test_distribution_fixture_setup, test_distribution_single_server, test_distribution_fixture_teardown);
 	g_test_add("/core/distribution/weighted", JConfiguration*, NULL, test_distribution_fixture_setup, test_distribution_weighted, test_distribution_fixture_teardown);
+	g_test_add("/core/distribution/adapt", JConfiguration*, NULL, test_distribution_fixture_setup, test_distribution_adapt, test_distribution_fixture_teardown);
+	g_test_add("/core/distribution/replicated", JConfiguration*, NULL, test_distribution_fixture_setup, test_distribution_replicated, test_distribution_fixture_teardown);
+	g_test_add("/core/distribution/local", JConfiguration*, NULL, test_distribution_fixture_setup, test_distribution_local, test_distribution_fixture_teardown);
+	g_test_add_func("/core/distribution/local_port", test_distribution_local_port);
+	g_test_add("/core/distribution/consistent_hash", JConfiguration*, NULL, test_distribution_fixture_setup, test_distribution_consistent_hash, test_distribution_fixture_teardown);
 }
@@ -180,9 +180,219 @@ test_kv_iterator_next_get(void)
 	g_assert_true(ret);
 }
 
+static void
+test_kv_iterator_pages(void)
+{
+	// More than the number of pairs per page
+	guint const n = 2500;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JBatch) delete_batch = NULL;
+	g_autoptr(JKVIterator) kv_iterator = NULL;
+	g_autoptr(JKVIterator) kv_iterator_partial = NULL;
+	g_autoptr(GHashTable) keys = NULL;
+	gboolean ret;
+
+	guint kvs = 0;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	delete_batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	for (guint i = 0; i < n; i++)
+	{
+		g_autoptr(JKV) kv = NULL;
+
+		g_autofree gchar* key = NULL;
+		gchar* value = NULL;
+
+		key = g_strdup_printf("test-key-pages-%d", i);
+		value = g_strdup_printf("test-value-%d", i);
+		kv = j_kv_new("test-ns-pages", key);
+		j_kv_put(kv, value, strlen(value) + 1, g_free, batch);
+		j_kv_delete(kv, delete_batch);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	kv_iterator = j_kv_iterator_new("test-ns-pages", NULL);
+
+	while (j_kv_iterator_next(kv_iterator))
+	{
+		gchar const* key;
+		gconstpointer value;
+		guint32 len;
+
+		key = j_kv_iterator_get(kv_iterator, &value, &len);
+		g_assert_true(g_str_has_prefix(key, "test-key-pages-"));
+		g_assert_true(g_str_has_prefix(value, "test-value-"));
+
+		// Every pair has to be returned exactly once
+		g_assert_true(g_hash_table_add(keys, g_strdup(key)));
+		kvs++;
+	}
+
+	g_assert_cmpuint(kvs, ==, n);
+	g_assert_false(j_kv_iterator_failed(kv_iterator));
+
+	// Stop in the middle of the first page, the server's cursor has to be closed
+	kvs = 0;
+	kv_iterator_partial = j_kv_iterator_new("test-ns-pages", NULL);
+
+	while (kvs < 10 && j_kv_iterator_next(kv_iterator_partial))
+	{
+		kvs++;
+	}
+
+	g_assert_cmpuint(kvs, ==, 10);
+	g_assert_false(j_kv_iterator_failed(kv_iterator_partial));
+
+	ret = j_batch_execute(delete_batch);
+	g_assert_true(ret);
+}
+
+static void
+test_kv_iterator_ordered(void)
+{
+	guint const n = 2500;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JBatch) delete_batch = NULL;
+	g_autoptr(JKVIterator) kv_iterator = NULL;
+	g_autofree gchar* previous_key = NULL;
+	gboolean ret;
+
+	guint kvs = 0;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	delete_batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	for (guint i = 0; i < n; i++)
+	{
+		g_autoptr(JKV) kv = NULL;
+
+		g_autofree gchar* key = NULL;
+		gchar* value = NULL;
+
+		// The keys are spread across all servers
+		key = g_strdup_printf("test-key-ordered-%d", i);
+		value = g_strdup_printf("test-value-%d", i);
+		kv = j_kv_new("test-ns-ordered", key);
+		j_kv_put(kv, value, strlen(value) + 1, g_free, batch);
+		j_kv_delete(kv, delete_batch);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	kv_iterator = j_kv_iterator_new_ordered("test-ns-ordered", "test-key-ordered-");
+
+	while (j_kv_iterator_next(kv_iterator))
+	{
+		gchar const* key;
+		gconstpointer value;
+		guint32 len;
+
+		key = j_kv_iterator_get(kv_iterator, &value, &len);
+		g_assert_true(g_str_has_prefix(key, "test-key-ordered-"));
+
+		if (previous_key != NULL)
+		{
+			g_assert_cmpint(strcmp(previous_key, key), <, 0);
+		}
+
+		g_free(previous_key);
+		previous_key = g_strdup(key);
+		kvs++;
+	}
+
+	g_assert_cmpuint(kvs, ==, n);
+
+	ret = j_batch_execute(delete_batch);
+	g_assert_true(ret);
+}
+
+static void
+test_kv_iterator_range(void)
+{
+	guint const n = 100;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JBatch) delete_batch = NULL;
+	g_autoptr(JKVIterator) kv_iterator = NULL;
+	g_autoptr(JKVIterator) reverse_iterator = NULL;
+	gboolean ret;
+
+	guint kvs = 0;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	delete_batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	for (guint i = 0; i < n; i++)
+	{
+		g_autoptr(JKV) kv = NULL;
+
+		g_autofree gchar* key = NULL;
+		gchar* value = NULL;
+
+		key = g_strdup_printf("test-key-range-%03d", i);
+		value = g_strdup_printf("test-value-%d", i);
+		kv = j_kv_new("test-ns-range", key);
+		j_kv_put(kv, value, strlen(value) + 1, g_free, batch);
+		j_kv_delete(kv, delete_batch);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	kv_iterator = j_kv_iterator_new_range("test-ns-range", "test-key-range-010", "test-key-range-050", 0, FALSE);
+
+	while (j_kv_iterator_next(kv_iterator))
+	{
+		g_autofree gchar* expected_key = NULL;
+		gchar const* key;
+		gconstpointer value;
+		guint32 len;
+
+		key = j_kv_iterator_get(kv_iterator, &value, &len);
+		expected_key = g_strdup_printf("test-key-range-%03d", 10 + kvs);
+		g_assert_cmpstr(key, ==, expected_key);
+
+		kvs++;
+	}
+
+	g_assert_cmpuint(kvs, ==, 40);
+
+	kvs = 0;
+	reverse_iterator = j_kv_iterator_new_range("test-ns-range", NULL, "test-key-range-050", 5, TRUE);
+
+	while (j_kv_iterator_next(reverse_iterator))
+	{
+		g_autofree gchar* expected_key = NULL;
+		gchar const* key;
+		gconstpointer value;
+		guint32 len;
+
+		key = j_kv_iterator_get(reverse_iterator, &value, &len);
+		expected_key = g_strdup_printf("test-key-range-%03d", 49 - kvs);
+		g_assert_cmpstr(key, ==, expected_key);
+
+		kvs++;
+	}
+
+	g_assert_cmpuint(kvs, ==, 5);
+
+	ret = j_batch_execute(delete_batch);
+	g_assert_true(ret);
+}
+
 void
 test_kv_kv_iterator(void)
 {
 	g_test_add_func("/kv/kv-iterator/new_free", test_kv_iterator_new_free);
 	g_test_add_func("/kv/kv-iterator/next_get", test_kv_iterator_next_get);
+	g_test_add_func("/kv/kv-iterator/pages", test_kv_iterator_pages);
+	g_test_add_func("/kv/kv-iterator/ordered", test_kv_iterator_ordered);
+	g_test_add_func("/kv/kv-iterator/range", test_kv_iterator_range);
 }
@@ -166,6 +166,263 @@ test_kv_get(void)
 	g_assert_true(ret);
 }
 
+static void
+test_kv_get_large(void)
+{
+	guint32 const large_len = 1024 * 1024;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JKV) kv_small = NULL;
+	g_autoptr(JKV) kv_large = NULL;
+	g_autofree gchar* small_value = NULL;
+	g_autofree gchar* large_value = NULL;
+	g_autofree gchar* get_small_value = NULL;
+	g_autofree gchar* get_large_value = NULL;
+	guint32 get_small_len;
+	guint32 get_large_len;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	// Large values are sent after the reply instead of inside it
+	small_value = g_strdup("kv-value");
+	large_value = g_malloc(large_len);
+
+	for (guint32 i = 0; i < large_len; i++)
+	{
+		large_value[i] = i % 251;
+	}
+
+	kv_small = j_kv_new("test", "test-kv-get-large-small");
+	kv_large = j_kv_new("test", "test-kv-get-large-large");
+
+	j_kv_put(kv_large, large_value, large_len, NULL, batch);
+	j_kv_put(kv_small, small_value, strlen(small_value) + 1, NULL, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	j_kv_get(kv_large, (gpointer)&get_large_value, &get_large_len, batch);
+	j_kv_get(kv_small, (gpointer)&get_small_value, &get_small_len, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	g_assert_cmpuint(get_large_len, ==, large_len);
+	g_assert_true(memcmp(get_large_value, large_value, large_len) == 0);
+	g_assert_cmpstr(get_small_value, ==, small_value);
+	g_assert_cmpuint(get_small_len, ==, strlen(small_value) + 1);
+
+	j_kv_delete(kv_large, batch);
+	j_kv_delete(kv_small, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
+static void
+test_kv_get_multi(void)
+{
+	guint const n = 100;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(GPtrArray) kvs = NULL;
+	g_autofree gchar** get_values = NULL;
+	g_autofree guint32* get_lens = NULL;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	kvs = g_ptr_array_new_with_free_func((GDestroyNotify)j_kv_unref);
+	get_values = g_new0(gchar*, n);
+	get_lens = g_new0(guint32, n);
+
+	// Gets of different pairs are sent to the server in one message, every other pair does not exist
+	for (guint i = 0; i < n; i++)
+	{
+		g_autofree gchar* key = NULL;
+		JKV* kv;
+
+		key = g_strdup_printf("test-kv-get-multi-%03u", (i * 37) % n);
+		kv = j_kv_new("test", key);
+		g_ptr_array_add(kvs, kv);
+
+		if (i % 2 == 0)
+		{
+			j_kv_put(kv, g_strdup(key), strlen(key) + 1, g_free, batch);
+		}
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	for (guint i = 0; i < n; i++)
+	{
+		j_kv_get(g_ptr_array_index(kvs, i), (gpointer)&(get_values[i]), &(get_lens[i]), batch);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_false(ret);
+
+	for (guint i = 0; i < n; i++)
+	{
+		g_autofree gchar* key = NULL;
+
+		key = g_strdup_printf("test-kv-get-multi-%03u", (i * 37) % n);
+
+		if (i % 2 == 0)
+		{
+			g_assert_cmpstr(get_values[i], ==, key);
+			g_assert_cmpuint(get_lens[i], ==, strlen(key) + 1);
+
+			j_kv_delete(g_ptr_array_index(kvs, i), batch);
+		}
+		else
+		{
+			g_assert_null(get_values[i]);
+		}
+
+		g_free(get_values[i]);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
+static void
+test_kv_compare_and_swap(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JKV) kv = NULL;
+	g_autofree gchar* get_value = NULL;
+	guint32 get_len;
+	gboolean swapped;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	kv = j_kv_new("test", "test-kv-compare-and-swap");
+
+	// The pair does not exist yet
+	j_kv_compare_and_swap(kv, NULL, 0, g_strdup("value-1"), strlen("value-1") + 1, g_free, &swapped, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_true(swapped);
+
+	j_kv_compare_and_swap(kv, NULL, 0, g_strdup("value-2"), strlen("value-2") + 1, g_free, &swapped, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_false(swapped);
+
+	j_kv_compare_and_swap(kv, "value-2", strlen("value-2") + 1, g_strdup("value-3"), strlen("value-3") + 1, g_free, &swapped, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_false(swapped);
+
+	j_kv_compare_and_swap(kv, "value-1", strlen("value-1") + 1, g_strdup("value-3"), strlen("value-3") + 1, g_free, &swapped, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_true(swapped);
+
+	j_kv_get(kv, (gpointer)&get_value, &get_len, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpstr(get_value, ==, "value-3");
+
+	j_kv_delete(kv, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
+static void
+test_kv_add(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JKV) kv = NULL;
+	gint64 result_1 = 0;
+	gint64 result_2 = 0;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	kv = j_kv_new("test", "test-kv-add");
+
+	// Each addition has to see the previous one, even within the same batch
+	j_kv_add(kv, 40, &result_1, batch);
+	j_kv_add(kv, 2, &result_2, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpint(result_1, ==, 40);
+	g_assert_cmpint(result_2, ==, 42);
+
+	j_kv_add(kv, -50, &result_1, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpint(result_1, ==, -8);
+
+	j_kv_delete(kv, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
+static void
+test_kv_append(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JKV) kv = NULL;
+	g_autofree gchar* get_value = NULL;
+	guint32 get_len;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	kv = j_kv_new("test", "test-kv-append");
+
+	j_kv_append(kv, g_strdup("abc"), 3, g_free, batch);
+	j_kv_append(kv, g_strdup("def"), 4, g_free, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	j_kv_get(kv, (gpointer)&get_value, &get_len, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(get_len, ==, 7);
+	g_assert_cmpstr(get_value, ==, "abcdef");
+
+	j_kv_delete(kv, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
+static void
+test_kv_placement(void)
+{
+	guint const n = 10000;
+
+	guint moved = 0;
+
+	for (guint i = 0; i < n; i++)
+	{
+		g_autofree gchar* key = NULL;
+		guint32 index;
+		guint32 new_index;
+
+		key = g_strdup_printf("test-kv-placement-%u", i);
+
+		g_assert_cmpuint(j_kv_placement_index(J_KV_PLACEMENT_MODULO, 4, key), <, 4);
+
+		index = j_kv_placement_index(J_KV_PLACEMENT_JUMP, 4, key);
+		new_index = j_kv_placement_index(J_KV_PLACEMENT_JUMP, 5, key);
+
+		g_assert_cmpuint(index, <, 4);
+		g_assert_cmpuint(index, ==, j_kv_placement_index(J_KV_PLACEMENT_JUMP, 4, key));
+
+		// Keys only move to the new server
+		if (index != new_index)
+		{
+			g_assert_cmpuint(new_index, ==, 4);
+			moved++;
+		}
+	}
+
+	// About a fifth of the keys should move
+	g_assert_cmpuint(moved, >, n / 5 - n / 20);
+	g_assert_cmpuint(moved, <, n / 5 + n / 20);
+}
+
 static guint num_callbacks = 0;
 
 static void
@@ -221,5 +478,11 @@ test_kv_kv(void)
 	g_test_add_func("/kv/kv/put_delete", test_kv_put_delete);
 	g_test_add_func("/kv/kv/put_update", test_kv_put_update);
 	g_test_add_func("/kv/kv/get", test_kv_get);
+	g_test_add_func("/kv/kv/get_large", test_kv_get_large);
+	g_test_add_func("/kv/kv/get_multi", test_kv_get_multi);
 	g_test_add_func("/kv/kv/get_callback", test_kv_get_callback);
+	g_test_add_func("/kv/kv/compare_and_swap", test_kv_compare_and_swap);
+	g_test_add_func("/kv/kv/add", test_kv_add);
+	g_test_add_func("/kv/kv/append", test_kv_append);
+	g_test_add_func("/kv/kv/placement", test_kv_placement);
 }
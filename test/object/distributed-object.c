@@ -199,6 +199,47 @@ test_object_status(void)
 	g_assert_true(ret);
 }
 
+static void
+test_object_status_scan(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JDistribution) distribution = NULL;
+	g_autoptr(JDistributedObject) object = NULL;
+	g_autofree gchar* buffer = NULL;
+	gint64 modification_time = 0;
+	gint64 scan_modification_time = 0;
+	guint64 nbytes = 0;
+	guint64 size = 0;
+	guint64 scan_size = 0;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	buffer = g_malloc0(42);
+
+	distribution = j_distribution_new(J_DISTRIBUTION_ROUND_ROBIN);
+	object = j_distributed_object_new("test", "test-distributed-object-status-scan", distribution);
+	g_assert_true(object != NULL);
+
+	j_distributed_object_create(object, batch);
+	j_distributed_object_write(object, buffer, 42, 0, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, 42);
+
+	j_distributed_object_status(object, &modification_time, &size, batch);
+	j_distributed_object_status_scan(object, &scan_modification_time, &scan_size, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpint(modification_time, !=, 0);
+	g_assert_cmpint(scan_modification_time, !=, 0);
+	g_assert_cmpuint(size, ==, 42);
+	g_assert_cmpuint(scan_size, ==, size);
+
+	j_distributed_object_delete(object, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
 static void
 test_object_sync(void)
 {
@@ -234,6 +275,81 @@ test_object_sync(void)
 	g_assert_true(ret);
 }
 
+static void
+test_object_lazy_create(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JDistribution) distribution = NULL;
+	g_autoptr(JDistributedObject) object = NULL;
+	g_autofree gchar* buffer = NULL;
+	g_autofree gchar* buffer2 = NULL;
+	guint64 const block_size = 1024;
+	guint64 block_id;
+	guint64 new_length;
+	guint64 new_offset;
+	guint64 nbytes = 0;
+	guint32 first_index;
+	guint32 index;
+	guint32 server_count;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	buffer = g_malloc0(42);
+	buffer2 = g_malloc0(42);
+	memset(buffer, 'j', 42);
+
+	distribution = j_distribution_new(J_DISTRIBUTION_ROUND_ROBIN);
+	j_distribution_set_block_size(distribution, block_size);
+	object = j_distributed_object_new("test", "test-distributed-object-lazy", distribution);
+	g_assert_true(object != NULL);
+
+	j_distributed_object_create(object, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	// Only the stripe holding the written block is created
+	j_distributed_object_write(object, buffer, 42, 3 * block_size + 1, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, 42);
+
+	j_distributed_object_read(object, buffer2, 42, 3 * block_size + 1, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, 42);
+	g_assert_cmpmem(buffer, 42, buffer2, 42);
+
+	server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
+
+	j_distribution_reset(distribution, 1, 0);
+	j_distribution_distribute(distribution, &first_index, &new_length, &new_offset, &block_id);
+	j_distribution_reset(distribution, 42, 3 * block_size + 1);
+	j_distribution_distribute(distribution, &index, &new_length, &new_offset, &block_id);
+
+	// Only the servers storing the first and the written block have stripes
+	for (guint32 i = 0; i < server_count; i++)
+	{
+		g_autoptr(JObject) stripe = NULL;
+		gint64 modification_time = 0;
+		guint64 size = 0;
+
+		if (i == first_index || i == index)
+		{
+			continue;
+		}
+
+		stripe = j_object_new_for_index(i, "test", "test-distributed-object-lazy");
+		j_object_status(stripe, &modification_time, &size, batch);
+		ret = j_batch_execute(batch);
+		g_assert_cmpint(modification_time, ==, 0);
+		g_assert_cmpuint(size, ==, 0);
+	}
+
+	j_distributed_object_delete(object, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
 void
 test_object_distributed_object(void)
 {
@@ -241,5 +357,7 @@ test_object_distributed_object(void)
 	g_test_add_func("/object/distributed-object/create_delete", test_object_create_delete);
 	g_test_add_func("/object/distributed-object/read_write", test_object_read_write);
 	g_test_add_func("/object/distributed-object/status", test_object_status);
+	g_test_add_func("/object/distributed-object/status_scan", test_object_status_scan);
 	g_test_add_func("/object/distributed-object/sync", test_object_sync);
+	g_test_add_func("/object/distributed-object/lazy_create", test_object_lazy_create);
 }
@@ -20,6 +20,8 @@
 
 #include <glib.h>
 
+#include <string.h>
+
 #include <julea.h>
 #include <julea-object.h>
 
@@ -66,6 +68,32 @@ test_object_create_delete(void)
 	g_assert_true(ret);
 }
 
+static void
+test_object_create_size_hint(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JObject) object = NULL;
+	guint64 size = 42;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	object = j_object_new("test", "test-object-size-hint");
+	g_assert_true(object != NULL);
+
+	j_object_create_with_size_hint(object, 1024 * 1024, batch);
+	j_object_status(object, NULL, &size, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	// The hint must not change the object's size
+	g_assert_cmpuint(size, ==, 0);
+
+	j_object_delete(object, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
 static void
 test_object_read_write(void)
 {
@@ -153,6 +181,90 @@ test_object_read_write(void)
 	g_assert_true(ret);
 }
 
+static void
+test_object_read_sparse(void)
+{
+	guint64 const hole_size = 1024 * 1024;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JObject) object = NULL;
+	g_autofree gchar* buffer = NULL;
+	gchar data[42];
+	guint64 nbytes = 0;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	buffer = g_malloc(hole_size + sizeof(data));
+	memset(data, 'j', sizeof(data));
+
+	object = j_object_new("test", "test-object-sparse");
+	g_assert_true(object != NULL);
+
+	j_object_create(object, batch);
+	j_object_write(object, data, sizeof(data), hole_size, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, sizeof(data));
+
+	// Make sure holes are actually overwritten
+	memset(buffer, 'x', hole_size + sizeof(data));
+
+	nbytes = 0;
+	j_object_read(object, buffer, hole_size + sizeof(data), 0, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, hole_size + sizeof(data));
+
+	for (guint64 i = 0; i < hole_size; i++)
+	{
+		g_assert_cmpint(buffer[i], ==, 0);
+	}
+
+	g_assert_cmpmem(buffer + hole_size, sizeof(data), data, sizeof(data));
+
+	j_object_delete(object, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
+static void
+test_object_copy(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JObject) object = NULL;
+	g_autoptr(JObject) destination = NULL;
+	gchar data[42];
+	gchar buffer[42];
+	guint64 nbytes = 0;
+	guint64 size = 0;
+	gboolean ret;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	memset(data, 'j', sizeof(data));
+
+	object = j_object_new_for_index(0, "test", "test-object-copy");
+	destination = j_object_new_for_index(0, "test", "test-object-copy-destination");
+
+	j_object_create(object, batch);
+	j_object_write(object, data, sizeof(data), 0, &nbytes, batch);
+	j_object_copy(object, destination, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	j_object_status(destination, NULL, &size, batch);
+	j_object_read(destination, buffer, sizeof(buffer), 0, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(size, ==, sizeof(data));
+	g_assert_cmpuint(nbytes, ==, sizeof(data));
+	g_assert_cmpmem(buffer, sizeof(buffer), data, sizeof(data));
+
+	j_object_delete(object, batch);
+	j_object_delete(destination, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+}
+
 static void
 test_object_status(void)
 {
@@ -223,12 +335,103 @@ test_object_sync(void)
 	g_assert_true(ret);
 }
 
+static void
+test_object_inline(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JObject) object = NULL;
+	g_autoptr(JObject) destination = NULL;
+	g_autofree gchar* data = NULL;
+	g_autofree gchar* buffer = NULL;
+	gint64 modification_time = 0;
+	guint64 inline_threshold;
+	guint64 nbytes = 0;
+	guint64 size = 0;
+	gboolean ret;
+
+	inline_threshold = j_configuration_get_inline_threshold(j_configuration());
+
+	if (inline_threshold == 0)
+	{
+		g_test_skip("Inline objects are disabled");
+		return;
+	}
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	data = g_malloc(inline_threshold + 1);
+	buffer = g_malloc(inline_threshold + 1);
+	memset(data, 'j', inline_threshold + 1);
+
+	object = j_object_new_for_index(0, "test", "test-object-inline");
+	destination = j_object_new_for_index(0, "test", "test-object-inline-destination");
+
+	// Inline object
+	j_object_create(object, batch);
+	j_object_write(object, data, inline_threshold / 2, 0, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, inline_threshold / 2);
+
+	j_object_status(object, NULL, &size, batch);
+	j_object_read(object, buffer, inline_threshold + 1, 0, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(size, ==, inline_threshold / 2);
+	g_assert_cmpuint(nbytes, ==, inline_threshold / 2);
+	g_assert_cmpmem(buffer, nbytes, data, inline_threshold / 2);
+
+	// Copying an inline object must replace a real destination object
+	j_object_create(destination, batch);
+	j_object_write(destination, data, inline_threshold + 1, 0, &nbytes, batch);
+	j_object_copy(object, destination, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	j_object_status(destination, NULL, &size, batch);
+	j_object_read(destination, buffer, inline_threshold + 1, 0, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(size, ==, inline_threshold / 2);
+	g_assert_cmpuint(nbytes, ==, inline_threshold / 2);
+	g_assert_cmpmem(buffer, nbytes, data, inline_threshold / 2);
+
+	// Growing beyond the threshold promotes the object
+	j_object_write(object, data + inline_threshold / 2, inline_threshold + 1 - inline_threshold / 2, inline_threshold / 2, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, inline_threshold + 1 - inline_threshold / 2);
+
+	j_object_status(object, NULL, &size, batch);
+	j_object_read(object, buffer, inline_threshold + 1, 0, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(size, ==, inline_threshold + 1);
+	g_assert_cmpuint(nbytes, ==, inline_threshold + 1);
+	g_assert_cmpmem(buffer, nbytes, data, inline_threshold + 1);
+
+	j_object_delete(object, batch);
+	j_object_delete(destination, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	// Deleted objects must not be found inline or in the object backend
+	size = 0;
+	j_object_status(object, &modification_time, &size, batch);
+	ret = j_batch_execute(batch);
+	g_assert_cmpint(modification_time, ==, 0);
+	g_assert_cmpuint(size, ==, 0);
+}
+
 void
 test_object_object(void)
 {
 	g_test_add_func("/object/object/new_free", test_object_new_free);
 	g_test_add_func("/object/object/create_delete", test_object_create_delete);
+	g_test_add_func("/object/object/create_size_hint", test_object_create_size_hint);
 	g_test_add_func("/object/object/read_write", test_object_read_write);
+	g_test_add_func("/object/object/read_sparse", test_object_read_sparse);
+	g_test_add_func("/object/object/copy", test_object_copy);
 	g_test_add_func("/object/object/status", test_object_status);
 	g_test_add_func("/object/object/sync", test_object_sync);
+	g_test_add_func("/object/object/inline", test_object_inline);
 }
@@ -38,12 +38,14 @@ static gchar const* opt_object_path = NULL;
 static gchar const* opt_kv_backend = NULL;
 static gchar const* opt_kv_component = NULL;
 static gchar const* opt_kv_path = NULL;
+static gchar const* opt_kv_placement = NULL;
 static gchar const* opt_db_backend = NULL;
 static gchar const* opt_db_component = NULL;
 static gchar const* opt_db_path = NULL;
 static gint64 opt_max_operation_size = 0;
 static gint opt_max_connections = 0;
 static gint64 opt_stripe_size = 0;
+static gint64 opt_inline_threshold = 0;
 
 static gchar**
 string_split(gchar const* string)
@@ -113,12 +115,19 @@ write_config(gchar* path)
 	g_key_file_set_string(key_file, "object", "backend", opt_object_backend);
 	g_key_file_set_string(key_file, "object", "component", opt_object_component);
 	g_key_file_set_string(key_file, "object", "path", opt_object_path);
+	g_key_file_set_int64(key_file, "object", "inline-threshold", opt_inline_threshold);
 	g_key_file_set_string(key_file, "kv", "backend", opt_kv_backend);
 	g_key_file_set_string(key_file, "kv", "component", opt_kv_component);
 	g_key_file_set_string(key_file, "kv", "path", opt_kv_path);
 	g_key_file_set_string(key_file, "db", "backend", opt_db_backend);
 	g_key_file_set_string(key_file, "db", "component", opt_db_component);
 	g_key_file_set_string(key_file, "db", "path", opt_db_path);
+
+	if (opt_kv_placement != NULL)
+	{
+		g_key_file_set_string(key_file, "kv", "placement", opt_kv_placement);
+	}
+
 	key_file_data = g_key_file_to_data(key_file, &key_file_data_len, NULL);
 
 	if (path != NULL)
@@ -161,12 +170,14 @@ main(gint argc, gchar** argv)
 		{ "kv-backend", 0, 0, G_OPTION_ARG_STRING, &opt_kv_backend, "Key-value backend to use", "posix|null|gio|…" },
 		{ "kv-component", 0, 0, G_OPTION_ARG_STRING, &opt_kv_component, "Key-value component to use", "client|server" },
 		{ "kv-path", 0, 0, G_OPTION_ARG_STRING, &opt_kv_path, "Key-value path to use", "/path/to/storage" },
+		{ "kv-placement", 0, 0, G_OPTION_ARG_STRING, &opt_kv_placement, "Key-value placement to use", "modulo|jump" },
 		{ "db-backend", 0, 0, G_OPTION_ARG_STRING, &opt_db_backend, "Database backend to use", "sqlite|null|…" },
 		{ "db-component", 0, 0, G_OPTION_ARG_STRING, &opt_db_component, "Database component to use", "client|server" },
 		{ "db-path", 0, 0, G_OPTION_ARG_STRING, &opt_db_path, "Database path to use", "/path/to/storage" },
 		{ "max-operation-size", 0, 0, G_OPTION_ARG_INT64, &opt_max_operation_size, "Maximum size of an operation", "0" },
 		{ "max-connections", 0, 0, G_OPTION_ARG_INT, &opt_max_connections, "Maximum number of connections", "0" },
 		{ "stripe-size", 0, 0, G_OPTION_ARG_INT64, &opt_stripe_size, "Default stripe size", "0" },
+		{ "inline-threshold", 0, 0, G_OPTION_ARG_INT64, &opt_inline_threshold, "Maximum size of objects stored in the key-value backend", "0" },
 		{ NULL, 0, 0, 0, NULL, NULL, NULL }
 	};
 
@@ -188,12 +199,14 @@ main(gint argc, gchar** argv)
 	}
 
 	if ((opt_user && opt_system)
-	    || (opt_read && (opt_servers_object != NULL || opt_servers_kv != NULL || opt_servers_db != NULL || opt_object_backend != NULL || opt_object_component != NULL || opt_object_path != NULL || opt_kv_backend != NULL || opt_kv_component != NULL || opt_kv_path != NULL || opt_db_backend != NULL || opt_db_component != NULL || opt_db_path != NULL))
+	    || (opt_read && (opt_servers_object != NULL || opt_servers_kv != NULL || opt_servers_db != NULL || opt_object_backend != NULL || opt_object_component != NULL || opt_object_path != NULL || opt_kv_backend != NULL || opt_kv_component != NULL || opt_kv_path != NULL || opt_kv_placement != NULL || opt_db_backend != NULL || opt_db_component != NULL || opt_db_path != NULL))
 	    || (opt_read && !opt_user && !opt_system)
 	    || (!opt_read && (opt_servers_object == NULL || opt_servers_kv == NULL || opt_servers_db == NULL || opt_object_backend == NULL || opt_object_component == NULL || opt_object_path == NULL || opt_kv_backend == NULL || opt_kv_component == NULL || opt_kv_path == NULL || opt_db_backend == NULL || opt_db_component == NULL || opt_db_path == NULL))
 	    || opt_max_operation_size < 0
 	    || opt_max_connections < 0
-	    || opt_stripe_size < 0)
+	    || opt_stripe_size < 0
+	    || opt_inline_threshold < 0
+	    || (opt_kv_placement != NULL && g_strcmp0(opt_kv_placement, "modulo") != 0 && g_strcmp0(opt_kv_placement, "jump") != 0))
 	{
 		g_autofree gchar* help = NULL;
 
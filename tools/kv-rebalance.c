@@ -0,0 +1,253 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <locale.h>
+
+#include <julea.h>
+#include <julea-kv.h>
+
+static gint opt_old_servers = 0;
+static gchar* opt_old_placement = NULL;
+static gchar** opt_namespaces = NULL;
+static gboolean opt_dry_run = FALSE;
+
+/**
+ * The number of pairs that are moved per batch.
+ **/
+#define MOVE_BATCH_SIZE 1000
+
+/**
+ * A key-value pair that has to be moved to another server.
+ **/
+struct Move
+{
+	gchar* key;
+	gpointer value;
+	guint32 len;
+	guint32 index;
+};
+
+typedef struct Move Move;
+
+static void
+move_free(gpointer data)
+{
+	Move* move = data;
+
+	g_free(move->key);
+	g_free(move->value);
+	g_slice_free(Move, move);
+}
+
+/**
+ * Writes the pairs to their new servers and deletes them from the old one afterwards.
+ * Pairs are only deleted once they have been written successfully.
+ **/
+static gboolean
+execute_moves(gchar const* namespace, guint32 old_index, GPtrArray* moves)
+{
+	g_autoptr(JBatch) put_batch = NULL;
+	g_autoptr(JBatch) delete_batch = NULL;
+
+	put_batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	delete_batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	for (guint i = 0; i < moves->len; i++)
+	{
+		Move* move = g_ptr_array_index(moves, i);
+		g_autoptr(JKV) new_kv = NULL;
+		g_autoptr(JKV) old_kv = NULL;
+
+		new_kv = j_kv_new_for_index(move->index, namespace, move->key);
+		old_kv = j_kv_new_for_index(old_index, namespace, move->key);
+
+		j_kv_put(new_kv, move->value, move->len, NULL, put_batch);
+		j_kv_delete(old_kv, delete_batch);
+	}
+
+	if (!j_batch_execute(put_batch))
+	{
+		return FALSE;
+	}
+
+	return j_batch_execute(delete_batch);
+}
+
+/**
+ * Moves all pairs of a namespace that are placed on another server after the expansion.
+ * With jump consistent hashing, only the pairs that belong to the new servers are moved.
+ **/
+static gboolean
+rebalance_namespace(gchar const* namespace, JKVPlacement old_placement, JKVPlacement placement, guint32 old_server_count, guint32 server_count)
+{
+	gboolean ret = TRUE;
+	guint64 moved = 0;
+	guint64 total = 0;
+
+	for (guint32 old_index = 0; old_index < old_server_count; old_index++)
+	{
+		g_autoptr(GPtrArray) moves = NULL;
+		g_autoptr(JKVIterator) iterator = NULL;
+
+		moves = g_ptr_array_new_with_free_func(move_free);
+
+		// Collect the pairs first, modifying the namespace while iterating over it is not supported by all backends
+		iterator = j_kv_iterator_new_for_index(old_index, namespace, NULL);
+
+		while (j_kv_iterator_next(iterator))
+		{
+			gchar const* key;
+			gconstpointer value;
+			guint32 len;
+			guint32 index;
+			Move* move;
+
+			key = j_kv_iterator_get(iterator, &value, &len);
+			total++;
+
+			// Skip pairs that have not been placed on this server by the old placement
+			if (j_kv_placement_index(old_placement, old_server_count, key) != old_index)
+			{
+				continue;
+			}
+
+			index = j_kv_placement_index(placement, server_count, key);
+
+			if (index == old_index)
+			{
+				continue;
+			}
+
+			move = g_slice_new(Move);
+			move->key = g_strdup(key);
+			move->value = g_memdup(value, len);
+			move->len = len;
+			move->index = index;
+
+			g_ptr_array_add(moves, move);
+		}
+
+		moved += moves->len;
+
+		if (opt_dry_run)
+		{
+			continue;
+		}
+
+		for (guint i = 0; i < moves->len; i += MOVE_BATCH_SIZE)
+		{
+			g_autoptr(GPtrArray) chunk = NULL;
+
+			chunk = g_ptr_array_new();
+
+			for (guint j = i; j < MIN(i + MOVE_BATCH_SIZE, moves->len); j++)
+			{
+				g_ptr_array_add(chunk, g_ptr_array_index(moves, j));
+			}
+
+			if (!execute_moves(namespace, old_index, chunk))
+			{
+				g_printerr("Error: Could not move pairs of namespace %s from server %u.\n", namespace, old_index);
+				ret = FALSE;
+				break;
+			}
+		}
+	}
+
+	g_print("%s: %s %" G_GUINT64_FORMAT " of %" G_GUINT64_FORMAT " pairs\n", namespace, (opt_dry_run) ? "would move" : "moved", moved, total);
+
+	return ret;
+}
+
+gint
+main(gint argc, gchar** argv)
+{
+	GError* error = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	JConfiguration* configuration;
+	JKVPlacement placement;
+	JKVPlacement old_placement;
+	guint32 server_count;
+	gboolean ret = TRUE;
+
+	GOptionEntry entries[] = {
+		{ "old-servers", 0, 0, G_OPTION_ARG_INT, &opt_old_servers, "Number of key-value servers before the expansion", "2" },
+		{ "old-placement", 0, 0, G_OPTION_ARG_STRING, &opt_old_placement, "Key-value placement before the expansion (default: current placement)", "modulo|jump" },
+		{ "namespace", 0, 0, G_OPTION_ARG_STRING_ARRAY, &opt_namespaces, "Namespace to rebalance (can be given multiple times)", "kv" },
+		{ "dry-run", 0, 0, G_OPTION_ARG_NONE, &opt_dry_run, "Only count the pairs that would be moved", NULL },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
+
+	// Explicitly enable UTF-8 since functions such as g_format_size might return UTF-8 characters.
+	setlocale(LC_ALL, "C.UTF-8");
+
+	context = g_option_context_new(NULL);
+	g_option_context_set_summary(context, "Moves key-value pairs after key-value servers have been added.\nThe new servers have to be appended to the list of key-value servers in the configuration.");
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		if (error)
+		{
+			g_printerr("%s\n", error->message);
+			g_error_free(error);
+		}
+
+		return 1;
+	}
+
+	configuration = j_configuration();
+	server_count = j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV);
+	placement = j_configuration_get_kv_placement(configuration);
+	old_placement = placement;
+
+	if (g_strcmp0(opt_old_placement, "modulo") == 0)
+	{
+		old_placement = J_KV_PLACEMENT_MODULO;
+	}
+	else if (g_strcmp0(opt_old_placement, "jump") == 0)
+	{
+		old_placement = J_KV_PLACEMENT_JUMP;
+	}
+
+	if (opt_old_servers <= 0 || (guint32)opt_old_servers > server_count || opt_namespaces == NULL
+	    || (opt_old_placement != NULL && g_strcmp0(opt_old_placement, "modulo") != 0 && g_strcmp0(opt_old_placement, "jump") != 0))
+	{
+		g_autofree gchar* help = NULL;
+
+		help = g_option_context_get_help(context, TRUE, NULL);
+
+		g_print("%s", help);
+
+		return 1;
+	}
+
+	for (guint i = 0; opt_namespaces[i] != NULL; i++)
+	{
+		ret = rebalance_namespace(opt_namespaces[i], old_placement, placement, opt_old_servers, server_count) && ret;
+	}
+
+	g_free(opt_old_placement);
+	g_strfreev(opt_namespaces);
+
+	return (ret) ? 0 : 1;
+}
@@ -0,0 +1,320 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <locale.h>
+#include <string.h>
+
+#include <julea.h>
+
+static gchar* opt_path = NULL;
+static gchar* opt_layout = NULL;
+
+/**
+ * Returns the path of an object relative to its namespace in the hashed layout.
+ * This has to be kept in sync with the posix object backend.
+ **/
+static gchar*
+hashed_path(gchar const* name)
+{
+	guint32 hash;
+	gchar level1[3];
+	gchar level2[3];
+
+	hash = j_helper_hash_fnv1a(name);
+
+	g_snprintf(level1, sizeof(level1), "%02x", (hash >> 24) & 0xff);
+	g_snprintf(level2, sizeof(level2), "%02x", (hash >> 16) & 0xff);
+
+	return g_build_filename(level1, level2, name, NULL);
+}
+
+static gboolean
+is_hashed_level(gchar const* name)
+{
+	return (strlen(name) == 2 && g_ascii_isxdigit(name[0]) && g_ascii_isxdigit(name[1]));
+}
+
+/**
+ * Checks whether a file is already stored at its location in the hashed layout.
+ * This makes repeated or interrupted migrations safe.
+ **/
+static gboolean
+is_hashed_path(gchar const* relative)
+{
+	g_autofree gchar* expected = NULL;
+
+	// "xx/yy/name"
+	if (strlen(relative) <= 6 || relative[2] != G_DIR_SEPARATOR || relative[5] != G_DIR_SEPARATOR)
+	{
+		return FALSE;
+	}
+
+	expected = hashed_path(relative + 6);
+
+	return (g_strcmp0(relative, expected) == 0);
+}
+
+static void
+collect_files(gchar const* base, gchar const* relative, GPtrArray* files)
+{
+	g_autoptr(GDir) dir = NULL;
+	g_autofree gchar* path = NULL;
+	gchar const* name;
+
+	path = g_build_filename(base, relative, NULL);
+
+	if ((dir = g_dir_open(path, 0, NULL)) == NULL)
+	{
+		return;
+	}
+
+	while ((name = g_dir_read_name(dir)) != NULL)
+	{
+		g_autofree gchar* child = NULL;
+		gchar* child_relative;
+
+		child_relative = g_build_filename(relative, name, NULL);
+		child = g_build_filename(base, child_relative, NULL);
+
+		if (g_file_test(child, G_FILE_TEST_IS_DIR) && !g_file_test(child, G_FILE_TEST_IS_SYMLINK))
+		{
+			collect_files(base, child_relative, files);
+			g_free(child_relative);
+		}
+		else
+		{
+			g_ptr_array_add(files, child_relative);
+		}
+	}
+}
+
+static void
+remove_empty_directories(gchar const* path)
+{
+	g_autoptr(GDir) dir = NULL;
+	gchar const* name;
+
+	if ((dir = g_dir_open(path, 0, NULL)) == NULL)
+	{
+		return;
+	}
+
+	while ((name = g_dir_read_name(dir)) != NULL)
+	{
+		g_autofree gchar* child = NULL;
+
+		child = g_build_filename(path, name, NULL);
+
+		if (g_file_test(child, G_FILE_TEST_IS_DIR) && !g_file_test(child, G_FILE_TEST_IS_SYMLINK))
+		{
+			remove_empty_directories(child);
+			// Fails if the directory is not empty
+			g_rmdir(child);
+		}
+	}
+}
+
+static gboolean
+migrate_namespace(gchar const* namespace_path, gboolean to_hashed)
+{
+	g_autoptr(GPtrArray) files = NULL;
+	gboolean ret = TRUE;
+	guint skipped = 0;
+
+	files = g_ptr_array_new_with_free_func(g_free);
+
+	if (to_hashed)
+	{
+		collect_files(namespace_path, "", files);
+	}
+	else
+	{
+		g_autoptr(GDir) dir = NULL;
+		gchar const* level1;
+
+		if ((dir = g_dir_open(namespace_path, 0, NULL)) == NULL)
+		{
+			return FALSE;
+		}
+
+		while ((level1 = g_dir_read_name(dir)) != NULL)
+		{
+			g_autoptr(GDir) dir_level1 = NULL;
+			g_autofree gchar* path_level1 = NULL;
+			gchar const* level2;
+
+			path_level1 = g_build_filename(namespace_path, level1, NULL);
+
+			if (!is_hashed_level(level1) || (dir_level1 = g_dir_open(path_level1, 0, NULL)) == NULL)
+			{
+				continue;
+			}
+
+			while ((level2 = g_dir_read_name(dir_level1)) != NULL)
+			{
+				g_autofree gchar* relative = NULL;
+
+				if (!is_hashed_level(level2))
+				{
+					continue;
+				}
+
+				relative = g_build_filename(level1, level2, NULL);
+				collect_files(namespace_path, relative, files);
+			}
+		}
+	}
+
+	for (guint i = 0; i < files->len; i++)
+	{
+		gchar const* relative = g_ptr_array_index(files, i);
+		g_autofree gchar* source = NULL;
+		g_autofree gchar* destination = NULL;
+		g_autofree gchar* destination_relative = NULL;
+		g_autofree gchar* parent = NULL;
+
+		// Files that are already hashed stay where they are when migrating to the hashed layout.
+		// When migrating to the flat layout, files that do not belong to the hashed layout are left alone.
+		if (is_hashed_path(relative) == to_hashed)
+		{
+			skipped++;
+			continue;
+		}
+
+		if (to_hashed)
+		{
+			destination_relative = hashed_path(relative);
+		}
+		else
+		{
+			// Skip the two levels of subdirectories ("xx/yy/")
+			destination_relative = g_strdup(relative + 6);
+		}
+
+		source = g_build_filename(namespace_path, relative, NULL);
+		destination = g_build_filename(namespace_path, destination_relative, NULL);
+
+		if (g_file_test(destination, G_FILE_TEST_EXISTS))
+		{
+			g_printerr("Error: %s already exists, skipping %s.\n", destination, source);
+			ret = FALSE;
+			continue;
+		}
+
+		parent = g_path_get_dirname(destination);
+		g_mkdir_with_parents(parent, 0700);
+
+		if (g_rename(source, destination) != 0)
+		{
+			g_printerr("Error: Could not move %s to %s.\n", source, destination);
+			ret = FALSE;
+		}
+	}
+
+	remove_empty_directories(namespace_path);
+
+	g_print("%s: %u objects migrated, %u objects skipped\n", namespace_path, files->len - skipped, skipped);
+
+	return ret;
+}
+
+gint
+main(gint argc, gchar** argv)
+{
+	GError* error = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GHashTable) options = NULL;
+	g_autofree gchar* path = NULL;
+	gboolean to_hashed;
+	gboolean ret = TRUE;
+	gchar const* namespace;
+
+	GOptionEntry entries[] = {
+		{ "path", 0, 0, G_OPTION_ARG_STRING, &opt_path, "Path of the posix object backend", "/path/to/storage" },
+		{ "layout", 0, 0, G_OPTION_ARG_STRING, &opt_layout, "Layout to migrate to", "flat|hashed" },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
+
+	// Explicitly enable UTF-8 since functions such as g_format_size might return UTF-8 characters.
+	setlocale(LC_ALL, "C.UTF-8");
+
+	context = g_option_context_new(NULL);
+	g_option_context_set_summary(context, "Migrates the posix object backend's storage between the flat and hashed layouts.\nThe server must not be running during the migration.");
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		if (error)
+		{
+			g_printerr("%s\n", error->message);
+			g_error_free(error);
+		}
+
+		return 1;
+	}
+
+	if (opt_path == NULL
+	    || (g_strcmp0(opt_layout, "flat") != 0 && g_strcmp0(opt_layout, "hashed") != 0))
+	{
+		g_autofree gchar* help = NULL;
+
+		help = g_option_context_get_help(context, TRUE, NULL);
+
+		g_print("%s", help);
+
+		return 1;
+	}
+
+	to_hashed = (g_strcmp0(opt_layout, "hashed") == 0);
+
+	// Allow passing the backend path including its options
+	path = j_backend_path_parse(opt_path, &options);
+
+	if ((dir = g_dir_open(path, 0, &error)) == NULL)
+	{
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+
+		return 1;
+	}
+
+	while ((namespace = g_dir_read_name(dir)) != NULL)
+	{
+		g_autofree gchar* namespace_path = NULL;
+
+		namespace_path = g_build_filename(path, namespace, NULL);
+
+		if (!g_file_test(namespace_path, G_FILE_TEST_IS_DIR))
+		{
+			continue;
+		}
+
+		ret = migrate_namespace(namespace_path, to_hashed) && ret;
+	}
+
+	g_free(opt_path);
+	g_free(opt_layout);
+
+	return (ret) ? 0 : 1;
+}
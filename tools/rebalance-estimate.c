@@ -0,0 +1,208 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2020 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <locale.h>
+
+#include <julea.h>
+
+static gint opt_servers = 0;
+static gint opt_new_servers = 0;
+static gint opt_objects = 100;
+static gint opt_blocks = 1000;
+static gchar* opt_distribution = NULL;
+
+/**
+ * Creates a configuration that only differs in the number of object servers.
+ * The servers are never contacted, only their number is relevant for the distributions.
+ **/
+static JConfiguration*
+configuration_new(guint server_count)
+{
+	JConfiguration* configuration;
+	GKeyFile* key_file;
+	g_auto(GStrv) servers = NULL;
+
+	servers = g_new0(gchar*, server_count + 1);
+
+	for (guint i = 0; i < server_count; i++)
+	{
+		servers[i] = g_strdup_printf("server%u", i);
+	}
+
+	key_file = g_key_file_new();
+	g_key_file_set_string_list(key_file, "servers", "object", (gchar const* const*)servers, server_count);
+	g_key_file_set_string_list(key_file, "servers", "kv", (gchar const* const*)servers, 1);
+	g_key_file_set_string_list(key_file, "servers", "db", (gchar const* const*)servers, 1);
+	g_key_file_set_string(key_file, "object", "backend", "null");
+	g_key_file_set_string(key_file, "object", "component", "server");
+	g_key_file_set_string(key_file, "object", "path", "");
+	g_key_file_set_string(key_file, "kv", "backend", "null");
+	g_key_file_set_string(key_file, "kv", "component", "server");
+	g_key_file_set_string(key_file, "kv", "path", "");
+	g_key_file_set_string(key_file, "db", "backend", "null");
+	g_key_file_set_string(key_file, "db", "component", "server");
+	g_key_file_set_string(key_file, "db", "path", "");
+
+	configuration = j_configuration_new_for_data(key_file);
+
+	g_key_file_free(key_file);
+
+	return configuration;
+}
+
+/**
+ * Returns the fraction of blocks that have to be moved when growing from the old to the new configuration.
+ **/
+static gdouble
+estimate(JDistributionType type, JConfiguration* configuration, JConfiguration* new_configuration)
+{
+	guint64 const block_size = 1;
+
+	guint64 moved = 0;
+	guint64 total = 0;
+
+	for (gint i = 0; i < opt_objects; i++)
+	{
+		g_autoptr(JDistribution) distribution = NULL;
+		g_autoptr(JDistribution) new_distribution = NULL;
+		guint32 seed;
+
+		distribution = j_distribution_new_for_configuration(type, configuration);
+		new_distribution = j_distribution_new_for_configuration(type, new_configuration);
+
+		// Both distributions have to describe the same object
+		seed = g_random_int();
+
+		if (type == J_DISTRIBUTION_ROUND_ROBIN)
+		{
+			j_distribution_set(distribution, "start-index", seed % opt_servers);
+			j_distribution_set(new_distribution, "start-index", seed % opt_servers);
+		}
+		else if (type == J_DISTRIBUTION_CONSISTENT_HASH)
+		{
+			j_distribution_set(distribution, "seed", seed);
+			j_distribution_set(new_distribution, "seed", seed);
+		}
+
+		j_distribution_set_block_size(distribution, block_size);
+		j_distribution_set_block_size(new_distribution, block_size);
+
+		j_distribution_reset(distribution, opt_blocks * block_size, 0);
+		j_distribution_reset(new_distribution, opt_blocks * block_size, 0);
+
+		for (gint j = 0; j < opt_blocks; j++)
+		{
+			guint index;
+			guint new_index;
+			guint64 length;
+			guint64 offset;
+			guint64 block_id;
+
+			j_distribution_distribute(distribution, &index, &length, &offset, &block_id);
+			j_distribution_distribute(new_distribution, &new_index, &length, &offset, &block_id);
+
+			if (index != new_index)
+			{
+				moved++;
+			}
+
+			total++;
+		}
+	}
+
+	return (gdouble)moved / (gdouble)total;
+}
+
+gint
+main(gint argc, gchar** argv)
+{
+	GError* error = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(JConfiguration) configuration = NULL;
+	g_autoptr(JConfiguration) new_configuration = NULL;
+	gboolean all;
+
+	GOptionEntry entries[] = {
+		{ "servers", 0, 0, G_OPTION_ARG_INT, &opt_servers, "Current number of object servers", "2" },
+		{ "new-servers", 0, 0, G_OPTION_ARG_INT, &opt_new_servers, "Number of object servers after the expansion", "3" },
+		{ "objects", 0, 0, G_OPTION_ARG_INT, &opt_objects, "Number of sampled objects", "100" },
+		{ "blocks", 0, 0, G_OPTION_ARG_INT, &opt_blocks, "Number of blocks per object", "1000" },
+		{ "distribution", 0, 0, G_OPTION_ARG_STRING, &opt_distribution, "Distribution to estimate", "round-robin|consistent-hash|all" },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
+
+	// Explicitly enable UTF-8 since functions such as g_format_size might return UTF-8 characters.
+	setlocale(LC_ALL, "C.UTF-8");
+
+	context = g_option_context_new(NULL);
+	g_option_context_set_summary(context, "Estimates the fraction of data that has to be moved when adding object servers.");
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		if (error)
+		{
+			g_printerr("%s\n", error->message);
+			g_error_free(error);
+		}
+
+		return 1;
+	}
+
+	if (opt_distribution == NULL)
+	{
+		opt_distribution = g_strdup("all");
+	}
+
+	if (opt_servers <= 0 || opt_new_servers <= opt_servers || opt_objects <= 0 || opt_blocks <= 0
+	    || (g_strcmp0(opt_distribution, "round-robin") != 0 && g_strcmp0(opt_distribution, "consistent-hash") != 0 && g_strcmp0(opt_distribution, "all") != 0))
+	{
+		g_autofree gchar* help = NULL;
+
+		help = g_option_context_get_help(context, TRUE, NULL);
+
+		g_print("%s", help);
+
+		return 1;
+	}
+
+	all = (g_strcmp0(opt_distribution, "all") == 0);
+
+	configuration = configuration_new(opt_servers);
+	new_configuration = configuration_new(opt_new_servers);
+
+	g_print("Optimal: %.2f%%\n", 100.0 * (opt_new_servers - opt_servers) / opt_new_servers);
+
+	if (all || g_strcmp0(opt_distribution, "round-robin") == 0)
+	{
+		g_print("round-robin: %.2f%%\n", 100.0 * estimate(J_DISTRIBUTION_ROUND_ROBIN, configuration, new_configuration));
+	}
+
+	if (all || g_strcmp0(opt_distribution, "consistent-hash") == 0)
+	{
+		g_print("consistent-hash: %.2f%%\n", 100.0 * estimate(J_DISTRIBUTION_CONSISTENT_HASH, configuration, new_configuration));
+	}
+
+	g_free(opt_distribution);
+
+	return 0;
+}
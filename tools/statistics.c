@@ -49,6 +49,9 @@ print_statistics(JStatistics* statistics)
 	g_print("  %s written\n", size_written);
 	g_print("  %s received\n", size_received);
 	g_print("  %s sent\n", size_sent);
+	g_print("  %" G_GUINT64_FORMAT " file cache hits\n", j_statistics_get(statistics, J_STATISTICS_FILE_CACHE_HITS));
+	g_print("  %" G_GUINT64_FORMAT " file cache misses\n", j_statistics_get(statistics, J_STATISTICS_FILE_CACHE_MISSES));
+	g_print("  %" G_GUINT64_FORMAT " file cache evictions\n", j_statistics_get(statistics, J_STATISTICS_FILE_CACHE_EVICTIONS));
 
 	g_free(size_read);
 	g_free(size_written);
@@ -125,6 +128,18 @@ main(int argc, char** argv)
 		j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, value);
 		j_statistics_add(statistics_total, J_STATISTICS_BYTES_SENT, value);
 
+		value = j_message_get_8(reply);
+		j_statistics_add(statistics, J_STATISTICS_FILE_CACHE_HITS, value);
+		j_statistics_add(statistics_total, J_STATISTICS_FILE_CACHE_HITS, value);
+
+		value = j_message_get_8(reply);
+		j_statistics_add(statistics, J_STATISTICS_FILE_CACHE_MISSES, value);
+		j_statistics_add(statistics_total, J_STATISTICS_FILE_CACHE_MISSES, value);
+
+		value = j_message_get_8(reply);
+		j_statistics_add(statistics, J_STATISTICS_FILE_CACHE_EVICTIONS, value);
+		j_statistics_add(statistics_total, J_STATISTICS_FILE_CACHE_EVICTIONS, value);
+
 		g_print("Data server %d\n", i);
 		print_statistics(statistics);
 